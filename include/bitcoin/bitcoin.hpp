@@ -21,22 +21,37 @@
 #include <bitcoin/bitcoin/error.hpp>
 #include <bitcoin/bitcoin/handlers.hpp>
 #include <bitcoin/bitcoin/version.hpp>
+#include <bitcoin/bitcoin/chain/address_rows.hpp>
 #include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/chain/block_assembler.hpp>
+#include <bitcoin/bitcoin/chain/block_file_reader.hpp>
+#include <bitcoin/bitcoin/chain/block_pipeline.hpp>
+#include <bitcoin/bitcoin/chain/bloom_filter.hpp>
 #include <bitcoin/bitcoin/chain/chain_state.hpp>
 #include <bitcoin/bitcoin/chain/compact.hpp>
+#include <bitcoin/bitcoin/chain/compact_filter.hpp>
+#include <bitcoin/bitcoin/chain/compression.hpp>
 #include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/chain/header_batch.hpp>
 #include <bitcoin/bitcoin/chain/history.hpp>
+#include <bitcoin/bitcoin/chain/iblt.hpp>
 #include <bitcoin/bitcoin/chain/input.hpp>
 #include <bitcoin/bitcoin/chain/input_point.hpp>
+#include <bitcoin/bitcoin/chain/merkle_tree.hpp>
 #include <bitcoin/bitcoin/chain/output.hpp>
 #include <bitcoin/bitcoin/chain/output_point.hpp>
 #include <bitcoin/bitcoin/chain/point.hpp>
 #include <bitcoin/bitcoin/chain/point_iterator.hpp>
 #include <bitcoin/bitcoin/chain/point_value.hpp>
 #include <bitcoin/bitcoin/chain/points_value.hpp>
+#include <bitcoin/bitcoin/chain/rolling_bloom_filter.hpp>
 #include <bitcoin/bitcoin/chain/script.hpp>
 #include <bitcoin/bitcoin/chain/stealth.hpp>
+#include <bitcoin/bitcoin/chain/stealth_filter.hpp>
+#include <bitcoin/bitcoin/chain/stealth_rows.hpp>
 #include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/chain/utxo_commitment.hpp>
+#include <bitcoin/bitcoin/chain/utxo_snapshot.hpp>
 #include <bitcoin/bitcoin/chain/witness.hpp>
 #include <bitcoin/bitcoin/config/authority.hpp>
 #include <bitcoin/bitcoin/config/base16.hpp>
@@ -105,15 +120,18 @@
 #include <bitcoin/bitcoin/message/block.hpp>
 #include <bitcoin/bitcoin/message/block_transactions.hpp>
 #include <bitcoin/bitcoin/message/compact_block.hpp>
+#include <bitcoin/bitcoin/message/compact_block_reconstructor.hpp>
 #include <bitcoin/bitcoin/message/fee_filter.hpp>
 #include <bitcoin/bitcoin/message/filter_add.hpp>
 #include <bitcoin/bitcoin/message/filter_clear.hpp>
 #include <bitcoin/bitcoin/message/filter_load.hpp>
+#include <bitcoin/bitcoin/message/framer.hpp>
 #include <bitcoin/bitcoin/message/get_address.hpp>
 #include <bitcoin/bitcoin/message/get_block_transactions.hpp>
 #include <bitcoin/bitcoin/message/get_blocks.hpp>
 #include <bitcoin/bitcoin/message/get_data.hpp>
 #include <bitcoin/bitcoin/message/get_headers.hpp>
+#include <bitcoin/bitcoin/message/graphene_block.hpp>
 #include <bitcoin/bitcoin/message/header.hpp>
 #include <bitcoin/bitcoin/message/headers.hpp>
 #include <bitcoin/bitcoin/message/heading.hpp>
@@ -126,6 +144,7 @@
 #include <bitcoin/bitcoin/message/not_found.hpp>
 #include <bitcoin/bitcoin/message/ping.hpp>
 #include <bitcoin/bitcoin/message/pong.hpp>
+#include <bitcoin/bitcoin/message/pooled_message.hpp>
 #include <bitcoin/bitcoin/message/prefilled_transaction.hpp>
 #include <bitcoin/bitcoin/message/reject.hpp>
 #include <bitcoin/bitcoin/message/send_compact.hpp>
@@ -146,6 +165,7 @@
 #include <bitcoin/bitcoin/utility/assert.hpp>
 #include <bitcoin/bitcoin/utility/atomic.hpp>
 #include <bitcoin/bitcoin/utility/binary.hpp>
+#include <bitcoin/bitcoin/utility/buffer_pool.hpp>
 #include <bitcoin/bitcoin/utility/collection.hpp>
 #include <bitcoin/bitcoin/utility/color.hpp>
 #include <bitcoin/bitcoin/utility/conditional_lock.hpp>
@@ -172,6 +192,7 @@
 #include <bitcoin/bitcoin/utility/pseudo_random.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/resubscriber.hpp>
+#include <bitcoin/bitcoin/utility/ring_window.hpp>
 #include <bitcoin/bitcoin/utility/scope_lock.hpp>
 #include <bitcoin/bitcoin/utility/sequencer.hpp>
 #include <bitcoin/bitcoin/utility/sequential_lock.hpp>
@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_ADDRESS_ROWS_HPP
+#define LIBBITCOIN_CHAIN_ADDRESS_ROWS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// The payment address hashes of a block in columns, one row per address, as
+/// for a history index. Scripts are classified directly from their bytes,
+/// with the results of payment_address::extract_output and extract_input.
+/// Columns are retained across extractions, so reuse avoids allocation.
+class BC_API address_rows
+{
+public:
+    enum class kind: uint8_t
+    {
+        /// Pay key hash and (conflated for tracking) pay public key.
+        output_key_hash,
+        output_script_hash,
+
+        /// Sign key hash is ambiguous, so also yields an input script hash.
+        input_key_hash,
+        input_script_hash
+    };
+
+    typedef std::vector<uint32_t> position_column;
+    typedef std::vector<kind> kind_column;
+    typedef std::vector<short_hash> hash_column;
+    typedef std::vector<uint64_t> value_column;
+
+    /// Reserve columns for the given number of rows.
+    void reserve(size_t rows);
+    void clear();
+    size_t size() const;
+
+    /// Replace the rows with those of the block, in block order. Coinbase
+    /// inputs are skipped. Transactions are divided among the threads (zero
+    /// is one per core).
+    void extract(const block& block, size_t threads=1);
+
+    /// Append the rows of the transaction at the given block position.
+    void extract(const transaction& tx, uint32_t position);
+
+    /// The block position of the transaction of each row.
+    const position_column& transactions() const;
+
+    /// The position of the input or output within its transaction.
+    const position_column& indexes() const;
+
+    const kind_column& kinds() const;
+    const hash_column& hashes() const;
+
+    /// Output value, or for inputs the value of the previous output if
+    /// populated by validation (otherwise output::not_found).
+    const value_column& values() const;
+
+private:
+    void append(const address_rows& other);
+    void push(uint32_t position, uint32_t index, kind type,
+        const short_hash& hash, uint64_t value);
+
+    position_column transactions_;
+    position_column indexes_;
+    kind_column kinds_;
+    hash_column hashes_;
+    value_column values_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -28,6 +28,7 @@
 #include <boost/optional.hpp>
 #include <bitcoin/bitcoin/chain/chain_state.hpp>
 #include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/chain/merkle_tree.hpp>
 #include <bitcoin/bitcoin/chain/transaction.hpp>
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/error.hpp>
@@ -46,6 +47,8 @@ class BC_API block
 public:
     typedef std::vector<block> list;
     typedef std::vector<size_t> indexes;
+    typedef std::vector<indexes> index_sets;
+    typedef std::shared_ptr<const data_chunk> data_const_ptr;
 
     // THIS IS FOR LIBRARY USE ONLY, DO NOT CREATE A DEPENDENCY ON IT.
     struct validation
@@ -102,6 +105,14 @@ public:
     bool from_data(std::istream& stream, bool witness=false);
     bool from_data(reader& source, bool witness=false);
 
+    /// Light parse of a wire block, populating the given sections of each
+    /// transaction (see transaction). Offsets are from the start of the block.
+    /// Transaction hashes are set only when parsing from the data.
+    bool from_data(const data_chunk& data, transaction::parse fields,
+        transaction::offsets::list& out);
+    bool from_data(reader& source, transaction::parse fields,
+        transaction::offsets::list& out);
+
     bool is_valid() const;
 
     // Serialization.
@@ -112,6 +123,12 @@ public:
     void to_data(writer& sink, bool witness=false) const;
     hash_list to_hashes(bool witness=false) const;
 
+    /// The immutable wire serialization, shared as for relay to many peers.
+    /// Captured by from_data of a data_chunk or built here on first use, it
+    /// is then written by serialization and invalidated by the setters and
+    /// by mutable access. Messages serialize through it.
+    data_const_ptr wire_data(bool witness=false) const;
+
     // Properties (size, accessors, cache).
     //-------------------------------------------------------------------------
 
@@ -156,6 +173,14 @@ public:
     uint64_t reward(size_t height) const;
     uint256_t proof() const;
     hash_digest generate_merkle_root(bool witness=false) const;
+
+    /// The transaction hash merkle tree, cached until transactions change.
+    merkle_tree::const_ptr to_merkle_tree() const;
+
+    /// The merkle branch of the transaction at the position, from the cached
+    /// tree. Empty if the position is out of range.
+    hash_list merkle_branch(size_t position) const;
+
     size_t signature_operations() const;
     size_t signature_operations(bool bip16, bool bip141) const;
     size_t total_inputs(bool with_coinbase=true) const;
@@ -173,6 +198,15 @@ public:
     bool is_valid_merkle_root() const;
     bool is_segregated() const;
 
+    /// Transaction positions grouped by in-block dependency depth. A
+    /// transaction is one level above the highest level of the in-block
+    /// transactions it spends, so each level depends only on prior levels.
+    index_sets dependency_levels() const;
+
+    /// Transaction positions grouped into sets connected by in-block spends.
+    /// Sets have no in-block dependencies on each other.
+    index_sets dependency_components() const;
+
     code check() const;
     code check_transactions() const;
     code accept(bool transactions=true) const;
@@ -191,6 +225,10 @@ protected:
     void reset();
 
 private:
+    index_sets dependency_parents() const;
+    void write_data(writer& sink, bool witness) const;
+    void invalidate_data() const;
+
     chain::header header_;
     transaction::list transactions_;
 
@@ -199,6 +237,9 @@ private:
     mutable boost::optional<size_t> total_inputs_;
     mutable boost::optional<size_t> base_size_;
     mutable boost::optional<size_t> total_size_;
+    mutable merkle_tree::const_ptr merkle_tree_;
+    mutable data_const_ptr data_;
+    mutable data_const_ptr witness_data_;
     mutable upgrade_mutex mutex_;
 };
 
@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_BLOCK_ASSEMBLER_HPP
+#define LIBBITCOIN_CHAIN_BLOCK_ASSEMBLER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/chain/chain_state.hpp>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// This class is thread safe.
+/// Builds block templates from validated pool transactions. Candidates are
+/// selected by ancestor package fee rate, where the package of a candidate
+/// is itself and its unselected in-pool ancestors, so a low fee parent is
+/// included for the sake of a high fee child. Candidates must carry the
+/// cached fees and sigops of pool validation and must spend only confirmed
+/// outputs or outputs of other candidates.
+class BC_API block_assembler
+{
+public:
+    /// Zero limits are those of the next block under the chain state.
+    block_assembler(const chain_state& state, size_t max_size=0,
+        size_t max_sigops=0);
+
+    /// Positions of the selected candidates, each preceded by its selected
+    /// ancestors, within the limits less the reserved size and sigops.
+    /// Coinbases and repeated transactions are never selected.
+    block::indexes select(const transaction::list& candidates,
+        size_t reserved_size=0, size_t reserved_sigops=0) const;
+
+    /// Template on the previous block with the coinbase and the selected
+    /// candidates, canonically ordered if magnetic anomaly is enabled. The
+    /// first coinbase output claims the block reward less any other outputs.
+    /// The timestamp is raised above median time past if necessary and the
+    /// merkle root is set, the nonce is zero.
+    block assemble(const hash_digest& previous, const transaction& coinbase,
+        const transaction::list& candidates, uint32_t timestamp) const;
+
+private:
+    size_t sigop_limit(size_t block_size) const;
+
+    const size_t height_;
+    const uint32_t version_;
+    const uint32_t bits_;
+    const uint32_t median_time_past_;
+    const bool canonical_;
+    const size_t max_size_;
+    const size_t max_sigops_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
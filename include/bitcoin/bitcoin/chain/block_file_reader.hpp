@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_BLOCK_FILE_READER_HPP
+#define LIBBITCOIN_CHAIN_BLOCK_FILE_READER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/noncopyable.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// This class is not thread safe, but const members may be called
+/// concurrently once all files are open.
+/// Memory-maps satoshi-format block files (blk?????.dat), each a sequence of
+/// [magic:4][size:4][block:size] records, and exposes the blocks in place.
+class BC_API block_file_reader
+  : noncopyable
+{
+public:
+    typedef boost::filesystem::path path;
+
+    /// Expected access pattern, passed to the kernel as a readahead hint.
+    enum class access
+    {
+        normal,
+        sequential,
+        random
+    };
+
+    /// A zero-copy view of one serialized block within a mapped file.
+    /// The view remains valid until the reader is closed or destroyed.
+    struct BC_API entry
+    {
+        typedef std::vector<entry> list;
+
+        /// The zero-based index of the file in order of opening.
+        size_t file;
+
+        /// The offset of the serialized block within the file.
+        size_t offset;
+
+        /// The serialized block.
+        data_slice data;
+
+        /// Hash the header in place, without parsing the block.
+        hash_digest hash() const;
+        hash_digest previous_block_hash() const;
+
+        /// Deserialize the block directly from the mapped bytes.
+        bool to_block(block& out) const;
+    };
+
+    /// The path of the numbered block file in the given directory.
+    static path file_path(const path& directory, size_t number);
+
+    block_file_reader(uint32_t magic);
+    ~block_file_reader();
+
+    /// Map a file and index its framing, false if the file cannot be mapped.
+    /// A truncated trailing record (partial write) terminates the scan.
+    bool open(const path& file, access hint=access::sequential);
+
+    /// Map blk00000.dat, blk00001.dat, ... until the first missing number.
+    /// Returns the number of files opened.
+    size_t open_directory(const path& directory,
+        access hint=access::sequential);
+
+    /// Unmap all files, invalidating all entries.
+    void close();
+
+    /// The number of mapped files.
+    size_t files() const;
+
+    /// All blocks in file order (which is download order, not chain order).
+    const entry::list& entries() const;
+
+    /// Blocks in chain order starting at the block with the given hash,
+    /// following the longest branch of previous block links. Stale and
+    /// orphan blocks are excluded. Empty if the start block is not found.
+    entry::list chain_order(const hash_digest& start) const;
+
+    /// Advise the kernel that the entry will be read soon (readahead).
+    void prefetch(const entry& value) const;
+
+private:
+    class mapping;
+    typedef std::shared_ptr<mapping> mapping_ptr;
+
+    void scan(size_t file, const data_slice& data);
+
+    const uint32_t magic_;
+    std::vector<mapping_ptr> mappings_;
+    entry::list entries_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
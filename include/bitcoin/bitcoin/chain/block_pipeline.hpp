@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_BLOCK_PIPELINE_HPP
+#define LIBBITCOIN_CHAIN_BLOCK_PIPELINE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/utility/asio.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/noncopyable.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// This class is not thread safe, run may not be called concurrently.
+/// Imports serialized blocks through bounded read, parse, hash and check
+/// stages that overlap across threads, delivering results in read order.
+class BC_API block_pipeline
+  : noncopyable
+{
+public:
+    typedef std::shared_ptr<block> block_ptr;
+
+    /// Read the next serialized block, false when there are no more blocks.
+    /// This is always invoked from a single thread and in sequence.
+    typedef std::function<bool(data_chunk& out)> read_handler;
+
+    /// Receive the result of the block with the given read sequence number.
+    /// The error is bad_stream if parse failed, otherwise the check() result.
+    /// Return false to stop the pipeline. Invoked on the thread of run().
+    typedef std::function<bool(const code& ec, size_t sequence,
+        block_ptr block)> result_handler;
+
+    enum stage
+    {
+        read,
+        parse,
+        hash,
+        check,
+        stages
+    };
+
+    struct BC_API stage_metrics
+    {
+        /// Items completed by the stage.
+        size_t items = 0;
+
+        /// Serialized bytes completed by the stage.
+        uint64_t bytes = 0;
+
+        /// Time spent processing (not waiting) summed over stage threads.
+        asio::duration busy = asio::duration::zero();
+
+        /// Items per second of processing time (per thread throughput).
+        double rate() const;
+    };
+
+    typedef std::array<stage_metrics, stages> stage_statistics;
+
+    /// Threads per parallel stage (zero is one per core) and the number of
+    /// blocks that may be in flight (zero is four per parallel thread).
+    block_pipeline(size_t threads=0, size_t capacity=0);
+
+    /// Run the pipeline to completion or until the result handler stops it.
+    /// Returns service_stopped if stopped by the handler, otherwise success.
+    code run(read_handler reader, result_handler handler);
+
+    /// Per stage statistics of the last run.
+    const stage_statistics& statistics() const;
+
+    /// Wall clock duration of the last run.
+    asio::duration elapsed() const;
+
+private:
+    const size_t threads_;
+    const size_t capacity_;
+    stage_statistics statistics_;
+    asio::duration elapsed_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
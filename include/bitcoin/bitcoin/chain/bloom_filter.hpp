@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_BLOOM_FILTER_HPP
+#define LIBBITCOIN_CHAIN_BLOOM_FILTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/chain/merkle_tree.hpp>
+#include <bitcoin/bitcoin/chain/point.hpp>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/message/filter_load.hpp>
+#include <bitcoin/bitcoin/message/merkle_block.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// A BIP37 transaction filter, as loaded by a peer with filter_load and
+/// extended with filter_add. Matching may insert matched outpoints into the
+/// filter, according to the update flags, so this is not thread safe.
+class BC_API bloom_filter
+{
+public:
+    enum update: uint8_t
+    {
+        // Matched outputs are not added to the filter.
+        none = 0,
+
+        // Every matched output is added to the filter.
+        all = 1,
+
+        // Only matched pay to public key and multisig outputs are added.
+        pay_public_key_only = 2,
+
+        mask = 3
+    };
+
+    /// An empty filter, which matches nothing.
+    bloom_filter();
+
+    bloom_filter(const data_chunk& filter, uint32_t hash_functions,
+        uint32_t tweak, uint8_t flags);
+    bloom_filter(data_chunk&& filter, uint32_t hash_functions,
+        uint32_t tweak, uint8_t flags);
+
+    /// A filter sized for the element count at the false positive rate,
+    /// bounded by the protocol limits.
+    bloom_filter(size_t elements, double false_positive_rate, uint32_t tweak,
+        uint8_t flags);
+
+    bloom_filter(const message::filter_load& load);
+
+    /// False if the filter exceeds the protocol size or function limits.
+    bool is_valid() const;
+
+    const data_chunk& filter() const;
+    uint32_t hash_functions() const;
+    uint32_t tweak() const;
+    uint8_t flags() const;
+
+    bool contains(data_slice element) const;
+    bool contains(const point& outpoint) const;
+    void insert(data_slice element);
+    void insert(const point& outpoint);
+
+    /// Match the transaction by its hash, output script pushes, spent
+    /// outpoints and input script pushes, updating the filter as flagged.
+    bool match(const transaction& tx);
+
+    /// Match each transaction of the block in order, one flag per transaction.
+    merkle_tree::matches match(const block& block);
+
+    /// The filtered block for the peer, from the block's cached merkle tree,
+    /// and the matched transactions in block order.
+    message::merkle_block to_merkle_block(const block& block,
+        transaction::list& out_matched);
+
+private:
+    typedef std::vector<uint32_t> hashes;
+
+    void initialize();
+    void indexes(data_slice element, uint32_t* out) const;
+    bool match_output(const output& output, const hash_digest& hash,
+        uint32_t index);
+    bool match_input(const input& input) const;
+
+    data_chunk filter_;
+    uint32_t hash_functions_;
+    uint32_t tweak_;
+    uint8_t flags_;
+    bool empty_;
+    bool full_;
+    hashes seeds_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -22,13 +22,13 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
-#include <deque>
 #include <bitcoin/bitcoin/config/checkpoint.hpp>
 #include <bitcoin/bitcoin/constants.hpp>
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/machine/opcode.hpp>
 #include <bitcoin/bitcoin/machine/rule_fork.hpp>
+#include <bitcoin/bitcoin/utility/ring_window.hpp>
 
 namespace libbitcoin { namespace chain {
 
@@ -36,10 +36,15 @@ class block;
 class header;
 
 class BC_API chain_state {
+    // Promotes state data across a run of headers without construction.
+    friend class header_batch;
+
 public:
-    typedef std::deque<uint32_t> bitss;
-    typedef std::deque<uint32_t> versions;
-    typedef std::deque<uint32_t> timestamps;
+    // Windows are shared between parent and child states, and the bits
+    // window memoizes the cumulative proof used by the cash difficulty.
+    typedef ring_window<uint32_t, uint256_t> bitss;
+    typedef ring_window<uint32_t> versions;
+    typedef ring_window<uint32_t> timestamps;
     typedef struct { size_t count; size_t high; } range;
 
     typedef std::shared_ptr<chain_state> ptr;
@@ -83,6 +88,9 @@ public:
 
         /// mainnet: 481824, testnet: 834624 (or map::unrequested)
         size_t bip9_bit1_height;
+
+        /// Configured assume valid height (or map::unrequested if above).
+        size_t assume_valid_height;
     };
 
     /// Values used to populate chain state at the target height.
@@ -102,6 +110,10 @@ public:
         /// Hash of the bip9_bit1 block or null_hash if unrequested.
         hash_digest bip9_bit1_hash;
 
+        /// Hash of the block at the assume valid height in the (header) chain
+        /// containing the candidate or null_hash if unrequested.
+        hash_digest assume_valid_hash;
+
         /// Values must be ordered by height with high (block - 1) last.
         struct {
             uint32_t self;
@@ -123,7 +135,9 @@ public:
     };
 
     /// Checkpoints must be ordered by height with greatest at back.
-    static map get_map(size_t height, const checkpoints& checkpoints, uint32_t forks);
+    /// A null assume valid hash disables assume valid.
+    static map get_map(size_t height, const checkpoints& checkpoints, uint32_t forks,
+        const config::checkpoint& assume_valid={});
 
     static uint32_t signal_version(uint32_t forks);
 
@@ -137,12 +151,14 @@ public:
     chain_state(chain_state const& parent, const chain::header& header);
 
     /// Checkpoints must be ordered by height with greatest at back.
-    /// Forks and checkpoints must match those provided for map creation.
+    /// Forks, checkpoints and assume valid must match those provided for map
+    /// creation.
     chain_state(data&& values, const checkpoints& checkpoints, uint32_t forks
 #ifdef BITPRIM_CURRENCY_BCH
                 , magnetic_anomaly_t magnetic_anomaly_activation_time
                 , great_wall_t great_wall_activation_time
 #endif  //BITPRIM_CURRENCY_BCH
+                , const config::checkpoint& assume_valid={}
     );
 
     /// Properties.
@@ -169,6 +185,11 @@ public:
     /// This block height is less than or equal to that of the top checkpoint.
     bool is_under_checkpoint() const;
 
+    /// This block is the assume valid block or one of its ancestors, so its
+    /// scripts are presumed valid. The populator must set assume_valid_hash
+    /// from the chain that contains this block.
+    bool is_under_assume_valid() const;
+
     static bool is_retarget_height(size_t height); //Need to be public, for Litecoin
 
 #ifdef BITPRIM_CURRENCY_BCH
@@ -227,6 +248,9 @@ private:
     static
     size_t bip9_bit1_height(size_t height, uint32_t forks);
 
+    static
+    size_t assume_valid_height(size_t height, config::checkpoint const& assume_valid);
+
     // static size_t uahf_height(size_t height, uint32_t forks);
     // static size_t daa_height(size_t height, uint32_t forks);
 
@@ -239,6 +263,12 @@ private:
     static data to_block(chain_state const& pool, block const& block);
     static data to_header(chain_state const& parent, header const& header);
 
+    // In place promotions, used by to_pool/to_header and by header_batch.
+    static void promote_pool(data& data, uint32_t forks);
+    static void promote_header(data& data, header const& header,
+        hash_digest const& hash, uint32_t forks,
+        config::checkpoint const& assume_valid);
+
     static uint32_t work_required_retarget(data const& values);
     static uint32_t retarget_timespan(chain_state::data const& values);
 
@@ -272,6 +302,9 @@ private:
     // Checkpoints do not affect the data that is collected or promoted.
     config::checkpoint::list const& checkpoints_;
 
+    // Assume valid does not affect the data that is promoted.
+    config::checkpoint const assume_valid_;
+
     // These are computed on construct from sample and checkpoints.
     activations const active_;
     uint32_t const median_time_past_;
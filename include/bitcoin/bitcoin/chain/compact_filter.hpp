@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_COMPACT_FILTER_HPP
+#define LIBBITCOIN_CHAIN_COMPACT_FILTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// A BIP158 basic block filter, a Golomb-Rice coded set of the block's
+/// output scripts and spent previous output scripts, keyed by block hash.
+class BC_API compact_filter
+{
+public:
+    typedef std::shared_ptr<const compact_filter> const_ptr;
+
+    /// The basic filter type and its Golomb-Rice parameters.
+    static const uint8_t basic;
+    static const uint8_t golomb_bits;
+    static const uint64_t inverse_false_positive_rate;
+
+    /// An invalid filter, which matches nothing.
+    compact_filter();
+
+    /// The filter of distinct elements, keyed by the block hash.
+    compact_filter(const hash_digest& block_hash, const data_stack& elements);
+
+    /// The encoded filter as received from a peer.
+    compact_filter(const hash_digest& block_hash, const data_chunk& encoded);
+    compact_filter(const hash_digest& block_hash, data_chunk&& encoded);
+
+    /// The basic filter of the block. Spent previous output scripts are read
+    /// from the input validation cache, so the block must be populated.
+    compact_filter(const block& block);
+
+    bool is_valid() const;
+    const hash_digest& block_hash() const;
+    const data_chunk& encoded() const;
+
+    /// The number of elements in the set.
+    uint64_t size() const;
+
+    /// The filter hash and the header chained from the previous header.
+    hash_digest hash() const;
+    hash_digest header(const hash_digest& previous_header) const;
+
+    /// Test membership of one element, subject to false positives.
+    bool match(data_slice element) const;
+
+    /// Test membership of any of the elements in one pass over the filter.
+    bool match_any(const data_stack& elements) const;
+
+private:
+    typedef std::vector<uint64_t> values;
+
+    void set_keys();
+    bool decode_count();
+    uint64_t to_value(data_slice element) const;
+    void encode(const data_stack& elements);
+    bool match_sorted(const values& queries) const;
+
+    hash_digest block_hash_;
+    data_chunk encoded_;
+    uint64_t count_;
+    size_t offset_;
+    uint64_t key0_;
+    uint64_t key1_;
+    bool valid_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_COMPRESSION_HPP
+#define LIBBITCOIN_CHAIN_COMPRESSION_HPP
+
+#include <cstdint>
+#include <bitcoin/bitcoin/chain/output.hpp>
+#include <bitcoin/bitcoin/chain/script.hpp>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/reader.hpp>
+#include <bitcoin/bitcoin/utility/writer.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// Compact storage codec, not a wire or hashing format.
+/// Amounts are reduced by factoring out trailing decimal zeros, common output
+/// scripts (pay key hash, pay script hash, pay public key) are reduced to 21
+/// or 33 bytes and repeated previous output hashes within a transaction are
+/// replaced by a reference to their first occurrence. Decompression restores
+/// the original serialization exactly. Witness data is not encoded.
+
+/// Reversible mapping of an amount onto a smaller integer.
+/// The amount must not exceed max_uint64 / 9 - 1, well above max_money().
+BC_API uint64_t compress_amount(uint64_t value);
+
+/// Returns false if the value is not a valid compressed amount.
+BC_API bool decompress_amount(uint64_t& out, uint64_t value);
+
+BC_API void to_compressed_data(writer& sink, const script& value);
+BC_API bool from_compressed_data(reader& source, script& out);
+
+BC_API data_chunk to_compressed_data(const output& value);
+BC_API void to_compressed_data(writer& sink, const output& value);
+BC_API bool from_compressed_data(const data_chunk& data, output& out);
+BC_API bool from_compressed_data(reader& source, output& out);
+
+BC_API data_chunk to_compressed_data(const transaction& value);
+BC_API void to_compressed_data(writer& sink, const transaction& value);
+BC_API bool from_compressed_data(const data_chunk& data, transaction& out);
+BC_API bool from_compressed_data(reader& source, transaction& out);
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
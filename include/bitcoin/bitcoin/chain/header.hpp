@@ -143,6 +143,9 @@ public:
     // Validation.
     //-----------------------------------------------------------------------------
 
+    static bool is_valid_proof_of_work(const hash_digest& hash,
+        uint32_t bits, bool retarget=true);
+
     bool is_valid_timestamp() const;
     bool is_valid_proof_of_work(bool retarget=true) const;
 
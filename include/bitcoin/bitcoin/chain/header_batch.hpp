@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_HEADER_BATCH_HPP
+#define LIBBITCOIN_CHAIN_HEADER_BATCH_HPP
+
+#include <cstddef>
+#include <vector>
+#include <bitcoin/bitcoin/chain/chain_state.hpp>
+#include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/noncopyable.hpp>
+#include <bitcoin/bitcoin/utility/threadpool.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+class header;
+
+} // namespace message
+
+namespace chain {
+
+/// This class is not thread safe, validate may not be called concurrently.
+/// Validates a run of headers (such as a headers message) as a chain. The
+/// headers are serialized and hashed and their proof of work and timestamps
+/// are checked in parallel. Linkage and contextual acceptance are then
+/// checked in sequence by promoting a single copy of the chain state data,
+/// and one chain state is constructed for the last valid header.
+class BC_API header_batch
+  : noncopyable
+{
+public:
+    /// Zero threads is one per core.
+    header_batch(size_t threads=0);
+    ~header_batch();
+
+    /// Validate the headers on the state of the header that precedes them.
+    /// Returns the error of the first invalid header or success, orphan_block
+    /// if a header does not link to its predecessor. Otherwise the errors are
+    /// those of header check and accept.
+    code validate(const chain_state& parent, const header::list& headers);
+    code validate(const chain_state& parent,
+        const std::vector<message::header>& headers);
+
+    /// Hashes of the headers of the last validation (all, in order).
+    const hash_list& hashes() const;
+
+    /// The number of leading valid headers of the last validation.
+    size_t valid() const;
+
+    /// The state of the last valid header, or nullptr if none are valid.
+    chain_state::ptr top() const;
+
+private:
+    typedef std::vector<const header*> header_pointers;
+
+    code validate(const chain_state& parent, const header_pointers& headers);
+    void check(const header_pointers& headers, bool retarget);
+    code accept(const chain_state& parent, const header_pointers& headers);
+
+    threadpool pool_;
+    hash_list hashes_;
+    std::vector<code> checks_;
+    size_t valid_;
+    chain_state::ptr top_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
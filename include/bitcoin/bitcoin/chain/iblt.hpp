@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_IBLT_HPP
+#define LIBBITCOIN_CHAIN_IBLT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/utility/reader.hpp>
+#include <bitcoin/bitcoin/utility/writer.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// An invertible bloom lookup table of 64 bit keys. The difference of two
+/// tables, each of a set, decodes to the keys of the symmetric difference of
+/// the sets, provided that difference is small relative to the table size.
+/// Each hash function addresses its own partition of the cells.
+class BC_API iblt
+{
+public:
+    typedef std::vector<uint64_t> keys;
+
+    /// The default and maximum number of hash functions.
+    static const uint8_t default_hash_functions;
+    static const uint8_t max_hash_functions;
+
+    /// An empty table of no cells.
+    iblt();
+
+    /// A table sized to decode a difference of up to capacity keys.
+    iblt(size_t capacity, uint32_t seed,
+        uint8_t hash_functions=default_hash_functions);
+
+    /// True if the cells evenly partition among the hash functions.
+    bool is_valid() const;
+
+    size_t cells() const;
+    uint8_t hash_functions() const;
+    uint32_t seed() const;
+
+    /// True if both tables have the same shape and seed, so may subtract.
+    bool is_compatible(const iblt& other) const;
+
+    void insert(uint64_t key);
+    void erase(uint64_t key);
+
+    /// Subtract the other table, false if not compatible.
+    bool subtract(const iblt& other);
+
+    /// Peel the table into the keys inserted (positive) and erased (negative),
+    /// false if the table does not fully decode.
+    bool decode(keys& out_inserted, keys& out_erased) const;
+
+    bool from_data(reader& source);
+    void to_data(writer& sink) const;
+    size_t serialized_size() const;
+
+    bool operator==(const iblt& other) const;
+    bool operator!=(const iblt& other) const;
+
+private:
+    struct cell
+    {
+        int32_t count;
+        uint64_t key_sum;
+        uint32_t check_sum;
+    };
+
+    typedef std::vector<cell> table;
+
+    static bool is_pure(const cell& cell, uint32_t check);
+    static bool is_empty(const cell& cell);
+
+    void set_seeds();
+    uint32_t hash(uint64_t key, size_t* out_indexes) const;
+    static void update(table& cells, const size_t* indexes, size_t count,
+        uint64_t key, uint32_t check, int32_t sign);
+
+    uint8_t hash_functions_;
+    uint32_t seed_;
+    table cells_;
+    std::vector<uint32_t> seeds_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_MERKLE_TREE_HPP
+#define LIBBITCOIN_CHAIN_MERKLE_TREE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// A merkle tree over transaction hashes with every level retained, so that
+/// branches and partial (BIP37) trees are produced without rehashing. Levels
+/// are stored contiguously, leaves first. An odd node at the end of a level
+/// is paired with itself, as in the merkle root computation.
+class BC_API merkle_tree
+{
+public:
+    typedef std::shared_ptr<const merkle_tree> const_ptr;
+    typedef std::vector<size_t> indexes;
+
+    /// One flag per leaf, true if the leaf is to be proven.
+    typedef std::vector<bool> matches;
+
+    merkle_tree(const hash_list& leaves);
+    merkle_tree(hash_list&& leaves);
+
+    /// The number of leaves.
+    size_t size() const;
+
+    /// The merkle root, or null_hash if there are no leaves.
+    hash_digest root() const;
+
+    /// The hashes paired with the leaf on its path to the root, leaf level
+    /// first. Empty if the position is out of range.
+    hash_list branch(size_t position) const;
+
+    /// The root implied by a leaf, its position and its branch.
+    static hash_digest branch_root(const hash_digest& leaf,
+        const hash_list& branch, size_t position);
+
+    /// Build the partial tree proving the matched leaves (BIP37). The flags
+    /// are packed least significant bit first. False if the match count
+    /// does not equal the leaf count.
+    bool partial(const matches& matched, hash_list& out_hashes,
+        data_chunk& out_flags) const;
+
+    /// Verify a partial tree over the given number of leaves and extract the
+    /// matched leaf hashes and positions. False if the tree is malformed, in
+    /// which case the outputs are unspecified.
+    static bool extract(size_t total, const hash_list& hashes,
+        const data_chunk& flags, hash_digest& out_root, hash_list& out_matches,
+        indexes& out_positions);
+
+private:
+    size_t width(size_t level) const;
+    const hash_digest& node(size_t level, size_t position) const;
+    void build();
+
+    // Offsets of the first node of each level within nodes_.
+    indexes offsets_;
+    hash_list nodes_;
+    size_t leaves_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
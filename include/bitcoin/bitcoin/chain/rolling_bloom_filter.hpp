@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_ROLLING_BLOOM_FILTER_HPP
+#define LIBBITCOIN_CHAIN_ROLLING_BLOOM_FILTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// A bloom filter of the most recently inserted hashes, in fixed memory.
+/// Insertions are counted in generations of half the element count, and each
+/// bit records the generation that last set it. Starting a fourth generation
+/// clears the bits of the oldest, so at least the last elements inserted are
+/// always contained, up to the false positive rate. Hashing is keyed at
+/// random, so peers cannot target collisions. This class is not thread safe.
+class BC_API rolling_bloom_filter
+{
+public:
+    /// The maximum number of hash functions.
+    static const uint8_t max_hash_functions;
+
+    /// A filter that contains at least the last elements inserted.
+    rolling_bloom_filter(size_t elements, double false_positive_rate);
+
+    /// The number of 64 bit words of the filter (two per word of bits).
+    size_t words() const;
+    uint8_t hash_functions() const;
+
+    void insert(const hash_digest& hash);
+    bool contains(const hash_digest& hash) const;
+
+    /// Clear the filter and rekey the hash.
+    void reset();
+
+private:
+    typedef std::vector<uint64_t> words_list;
+
+    template <typename Action>
+    bool for_each_bit(const hash_digest& hash, Action action) const;
+
+    void start_generation();
+
+    uint8_t hash_functions_;
+    size_t generation_entries_;
+    size_t entries_;
+    uint8_t generation_;
+    uint64_t key0_;
+    uint64_t key1_;
+    words_list data_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
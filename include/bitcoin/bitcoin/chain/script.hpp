@@ -125,6 +125,9 @@ public:
     size_t serialized_size(bool prefix) const;
     const operation::list& operations() const;
 
+    /// The encoded script (without prefix), for matching without parsing.
+    const data_chunk& bytes() const;
+
     // Signing.
     //-------------------------------------------------------------------------
 
@@ -235,8 +238,6 @@ private:
         uint32_t input_index, const script& script_code, uint64_t value,
         uint8_t sighash_type);
 
-    void find_and_delete_(const data_chunk& endorsement);
-
     data_chunk bytes_;
     bool valid_;
 
@@ -0,0 +1,59 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_STEALTH_FILTER_HPP
+#define LIBBITCOIN_CHAIN_STEALTH_FILTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/utility/binary.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// A set of stealth filters compiled for matching many 32 bit stealth
+/// prefixes (see to_stealth_prefix). Filters are grouped by bit length, so a
+/// prefix is tested with one shift and sorted search per distinct length,
+/// rather than by bit comparison against each filter.
+class BC_API stealth_filter
+{
+public:
+    typedef std::vector<binary> list;
+
+    stealth_filter(const list& filters);
+
+    /// True if there are no filters, which matches nothing.
+    bool empty() const;
+
+    /// True if any filter is a prefix of the stealth prefix, as would be
+    /// binary::is_prefix_of.
+    bool matches(uint32_t prefix) const;
+
+private:
+    typedef std::vector<uint32_t> values;
+
+    std::vector<uint8_t> lengths_;
+    std::vector<values> values_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
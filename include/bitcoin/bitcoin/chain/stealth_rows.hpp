@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_STEALTH_ROWS_HPP
+#define LIBBITCOIN_CHAIN_STEALTH_ROWS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/chain/stealth.hpp>
+#include <bitcoin/bitcoin/chain/stealth_filter.hpp>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// The stealth candidates of a block in columns, as for a stealth index. A
+/// candidate is a stealth null data output (see is_stealth_script) followed
+/// by an output with a payment address. Scripts are matched on their bytes
+/// and the prefix of each candidate is computed once, for matching against
+/// any number of filters. Columns are retained across extractions.
+class BC_API stealth_rows
+{
+public:
+    typedef std::vector<uint32_t> position_column;
+    typedef std::vector<uint32_t> prefix_column;
+    typedef std::vector<hash_digest> hash_column;
+    typedef std::vector<short_hash> short_hash_column;
+    typedef std::vector<size_t> row_list;
+
+    /// Reserve columns for the given number of rows.
+    void reserve(size_t rows);
+    void clear();
+    size_t size() const;
+
+    /// Replace the rows with the candidates of the block, in block order.
+    void extract(const block& block);
+
+    /// Append the candidates of the transaction at the given block position.
+    void extract(const transaction& tx, uint32_t position);
+
+    /// The rows with a prefix matched by any of the filters, in row order.
+    row_list match(const stealth_filter& filter) const;
+
+    /// The row in the forms of the client-server protocol.
+    stealth_compact to_compact(size_t row) const;
+    stealth to_stealth(size_t row) const;
+
+    /// The block position of the transaction of each row.
+    const position_column& transactions() const;
+
+    /// The position of the null data output within its transaction.
+    const position_column& indexes() const;
+
+    const prefix_column& prefixes() const;
+
+    /// The ephemeral public key, without its (even) sign byte.
+    const hash_column& ephemeral_keys() const;
+
+    /// The hash of the payment address of the following output.
+    const short_hash_column& public_key_hashes() const;
+
+    const hash_column& transaction_hashes() const;
+
+private:
+    position_column transactions_;
+    position_column indexes_;
+    prefix_column prefixes_;
+    hash_column ephemeral_keys_;
+    short_hash_column public_key_hashes_;
+    hash_column transaction_hashes_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -50,6 +50,7 @@ public:
     typedef output::list outs;
     typedef std::vector<transaction> list;
     typedef std::shared_ptr<hash_digest> hash_ptr;
+    typedef std::shared_ptr<const data_chunk> data_const_ptr;
 
     // THIS IS FOR LIBRARY USE ONLY, DO NOT CREATE A DEPENDENCY ON IT.
     struct validation
@@ -71,6 +72,29 @@ public:
         bool simulate = false;
     };
 
+    /// The sections of a wire transaction populated by a light parse.
+    enum parse: uint8_t
+    {
+        parse_input_points = 1 << 0,
+        parse_input_scripts = 1 << 1,
+        parse_outputs = 1 << 2,
+        parse_inputs = parse_input_points | parse_input_scripts,
+        parse_all = parse_inputs | parse_outputs
+    };
+
+    /// Byte offsets of the sections of a light parsed wire transaction, from
+    /// the start of the parsed buffer, so skipped sections may be read later.
+    struct offsets
+    {
+        typedef std::vector<offsets> list;
+
+        size_t transaction;
+        size_t inputs;
+        size_t outputs;
+        size_t witnesses;
+        size_t locktime;
+    };
+
     // Constructors.
     //-----------------------------------------------------------------------------
 
@@ -107,6 +131,17 @@ public:
     bool from_data(std::istream& stream, bool wire=true, bool witness=false, bool unconfirmed=false);
     bool from_data(reader& source, bool wire=true, bool witness=false, bool unconfirmed=false);
 
+    /// Light parse of a wire transaction. Skipped sections are length checked
+    /// and left default, witnesses are always skipped. Given the data, the
+    /// hash is set from it, as the parsed fields alone may not reproduce it.
+    /// From a reader the hash is not set, and hash() is valid for parse_all.
+    bool from_data(const data_chunk& data, parse fields, offsets& out);
+    bool from_data(reader& source, parse fields, offsets& out);
+
+    /// The hash of a light parsed transaction, from the buffer of its offsets.
+    /// The marker, flag and witnesses of a segregated transaction are skipped.
+    static hash_digest to_hash(const data_chunk& data, const offsets& at);
+
     bool is_valid() const;
 
     // Serialization.
@@ -116,6 +151,12 @@ public:
     void to_data(std::ostream& stream, bool wire=true, bool witness=false, bool unconfirmed=false) const;
     void to_data(writer& sink, bool wire=true, bool witness=false, bool unconfirmed=false) const;
 
+    /// The immutable wire serialization, shared as for relay to many peers.
+    /// Captured by from_data of a data_chunk or built here on first use, it
+    /// is then written by wire serialization and invalidated by the setters
+    /// and by mutable access. Messages serialize through it.
+    data_const_ptr wire_data(bool witness=false) const;
+
     // Properties (size, accessors, cache).
     //-----------------------------------------------------------------------------
 
@@ -203,6 +244,11 @@ protected:
     bool all_inputs_final() const;
 
 private:
+    void write_data(writer& sink, bool wire, bool witness,
+        bool unconfirmed) const;
+    data_chunk to_uncached_data(bool witness) const;
+    void invalidate_data() const;
+
     uint32_t version_;
     uint32_t locktime_;
     input::list inputs_;
@@ -225,6 +271,8 @@ private:
     mutable hash_ptr outputs_hash_;
     mutable hash_ptr inpoints_hash_;
     mutable hash_ptr sequences_hash_;
+    mutable data_const_ptr data_;
+    mutable data_const_ptr witness_data_;
     mutable upgrade_mutex hash_mutex_;
 
     // These share a mutex as they are not expected to contend.
@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_UTXO_COMMITMENT_HPP
+#define LIBBITCOIN_CHAIN_UTXO_COMMITMENT_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/chain/output.hpp>
+#include <bitcoin/bitcoin/chain/output_point.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// This class is not thread safe.
+/// Rolling multiset hash (MuHash3072) of unspent outputs. Each element maps
+/// to a number modulo the prime 2^3072 - 1103717, added elements multiply
+/// into a numerator and removed elements into a denominator, so add, remove
+/// and combine are constant time and independent of order. Only hash()
+/// performs the (costly) modular inversion. The element serialization and
+/// the digest match those of the satoshi client's MuHash UTXO set hash.
+class BC_API utxo_commitment
+{
+public:
+    /// The serialization of an unspent output as a set element.
+    static data_chunk to_element(const output_point& point,
+        const output& output, size_t height, bool coinbase);
+
+    /// The commitment to the empty set.
+    utxo_commitment();
+
+    /// Add or remove an unspent output.
+    void add(const output_point& point, const output& output, size_t height,
+        bool coinbase);
+    void remove(const output_point& point, const output& output,
+        size_t height, bool coinbase);
+
+    /// Add or remove a serialized element.
+    void add(data_slice element);
+    void remove(data_slice element);
+
+    /// Merge a commitment computed independently (such as on another
+    /// thread), including its removals.
+    void combine(const utxo_commitment& other);
+
+    /// The commitment to the current set.
+    hash_digest hash() const;
+
+    /// Persist and restore the unfinalized state (768 bytes).
+    data_chunk to_data() const;
+    bool from_data(const data_chunk& data);
+
+private:
+    typedef std::array<uint32_t, 96> number;
+
+    number numerator_;
+    number denominator_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
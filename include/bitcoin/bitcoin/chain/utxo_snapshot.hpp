@@ -0,0 +1,131 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_UTXO_SNAPSHOT_HPP
+#define LIBBITCOIN_CHAIN_UTXO_SNAPSHOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <vector>
+#include <bitcoin/bitcoin/chain/output.hpp>
+#include <bitcoin/bitcoin/chain/output_point.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/noncopyable.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// A snapshot file is a header followed by a sequence of chunks:
+///
+/// header: [magic:4][version:4][block hash:32][height:4][commitment:32]
+/// chunk:  [count:4][size:4][sha256(payload):32][payload:size]
+///
+/// The final chunk has a count and size of zero. Each payload entry is the
+/// wire output point, varint (height << 1 | coinbase) and the compressed
+/// output (see compression.hpp). The commitment is the utxo_commitment hash
+/// of the full set of entries.
+
+/// The block at which a snapshot was taken and a commitment to its set.
+struct BC_API utxo_snapshot_header
+{
+    hash_digest block_hash;
+    size_t height;
+    hash_digest commitment;
+};
+
+/// An unspent output with the metadata required for validation.
+struct BC_API unspent_output
+{
+    typedef std::vector<unspent_output> list;
+
+    output_point point;
+    chain::output output;
+    size_t height;
+    bool coinbase;
+};
+
+/// This class is not thread safe.
+/// Streams a snapshot, closing a chunk at a target payload size.
+class BC_API utxo_snapshot_writer
+  : noncopyable
+{
+public:
+    /// The header commitment must be of the entries that will be written.
+    /// Zero chunk size is the default target payload size.
+    utxo_snapshot_writer(std::ostream& stream,
+        const utxo_snapshot_header& header, size_t chunk_size=0);
+
+    /// Append an entry, false if the stream has failed.
+    bool write(const unspent_output& entry);
+
+    /// Write the partial chunk and the terminating chunk.
+    bool flush();
+
+private:
+    void write_chunk();
+
+    std::ostream& stream_;
+    const size_t chunk_size_;
+    data_chunk payload_;
+    uint32_t count_;
+};
+
+/// This class is not thread safe, load may not be called concurrently.
+/// Reads a snapshot serially and verifies, parses and delivers its chunks in
+/// parallel, then verifies the set commitment of all delivered entries.
+class BC_API utxo_snapshot_reader
+  : noncopyable
+{
+public:
+    /// Receive the entries of the chunk at the given zero-based position.
+    /// Invoked concurrently and in no particular order from load threads.
+    /// Return false to stop loading.
+    typedef std::function<bool(size_t chunk, unspent_output::list&& entries)>
+        chunk_handler;
+
+    utxo_snapshot_reader(std::istream& stream);
+
+    /// Read the header, false if it is not a supported snapshot header.
+    bool read_header();
+
+    /// The header, valid after read_header.
+    const utxo_snapshot_header& header() const;
+
+    /// Load all chunks, reading the header if not yet read. Returns
+    /// bad_stream for invalid framing or entries, store_snapshot_corrupt for
+    /// a chunk hash mismatch, store_snapshot_mismatch if the entries do not
+    /// match the header commitment and service_stopped if the handler
+    /// stopped the load. Zero threads is one per core.
+    code load(chunk_handler handler, size_t threads=0);
+
+private:
+    std::istream& stream_;
+    utxo_snapshot_header header_;
+    bool header_read_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -74,6 +74,8 @@ enum error_code_t
     store_block_duplicate = 66,
     store_block_invalid_height = 67,
     store_block_missing_parent = 68,
+    store_snapshot_corrupt = 85,
+    store_snapshot_mismatch = 86,
 
     // blockchain
     duplicate_block = 51,
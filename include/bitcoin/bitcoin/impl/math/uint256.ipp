@@ -0,0 +1,344 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_UINT256_IPP
+#define LIBBITCOIN_UINT256_IPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace libbitcoin {
+
+// Constructors.
+// ----------------------------------------------------------------------------
+
+BC_CONSTFUNC uint256_t::uint256_t()
+  : limbs_{ 0, 0, 0, 0 }
+{
+}
+
+BC_CONSTFUNC uint256_t::uint256_t(uint64_t low, uint64_t low_middle,
+    uint64_t high_middle, uint64_t high)
+  : limbs_{ low, low_middle, high_middle, high }
+{
+}
+
+template <typename Integer, typename>
+BC_CONSTFUNC uint256_t::uint256_t(Integer value)
+  : limbs_{
+        static_cast<uint64_t>(value),
+        extend(value, std::is_signed<Integer>()),
+        extend(value, std::is_signed<Integer>()),
+        extend(value, std::is_signed<Integer>()) }
+{
+}
+
+// Negative values extend to all ones (two's complement).
+template <typename Integer>
+BC_CONSTFUNC uint64_t uint256_t::extend(Integer value, std::true_type)
+{
+    return value < 0 ? ~uint64_t(0) : 0;
+}
+
+template <typename Integer>
+BC_CONSTFUNC uint64_t uint256_t::extend(Integer, std::false_type)
+{
+    return 0;
+}
+
+// Properties.
+// ----------------------------------------------------------------------------
+
+BC_CONSTFUNC uint64_t uint256_t::limb(size_t index) const
+{
+    return limbs_[index];
+}
+
+BC_CONSTFUNC bool uint256_t::is_zero(size_t from) const
+{
+    return from == 4 || (limbs_[from] == 0 && is_zero(from + 1));
+}
+
+BC_CONSTFUNC bool uint256_t::is_zero() const
+{
+    return is_zero(0);
+}
+
+// Most significant limb first.
+BC_CONSTFUNC int uint256_t::compare(const uint256_t& other) const
+{
+    return
+        limbs_[3] != other.limbs_[3] ? (limbs_[3] < other.limbs_[3] ? -1 : 1) :
+        limbs_[2] != other.limbs_[2] ? (limbs_[2] < other.limbs_[2] ? -1 : 1) :
+        limbs_[1] != other.limbs_[1] ? (limbs_[1] < other.limbs_[1] ? -1 : 1) :
+        limbs_[0] != other.limbs_[0] ? (limbs_[0] < other.limbs_[0] ? -1 : 1) :
+        0;
+}
+
+BC_CONSTFUNC uint256_t::operator bool() const
+{
+    return !is_zero();
+}
+
+template <typename Integer, typename>
+BC_CONSTFUNC uint256_t::operator Integer() const
+{
+    return static_cast<Integer>(limbs_[0]);
+}
+
+// Arithmetic.
+// ----------------------------------------------------------------------------
+
+inline uint256_t& uint256_t::operator+=(const uint256_t& other)
+{
+    uint64_t carry = 0;
+
+    for (size_t index = 0; index < 4; ++index)
+    {
+        const auto sum = limbs_[index] + other.limbs_[index];
+        const auto total = sum + carry;
+        carry = (sum < limbs_[index] ? 1 : 0) + (total < sum ? 1 : 0);
+        limbs_[index] = total;
+    }
+
+    return *this;
+}
+
+inline uint256_t& uint256_t::operator-=(const uint256_t& other)
+{
+    uint64_t borrow = 0;
+
+    for (size_t index = 0; index < 4; ++index)
+    {
+        const auto difference = limbs_[index] - other.limbs_[index];
+        const auto total = difference - borrow;
+        borrow = (limbs_[index] < other.limbs_[index] ? 1 : 0) +
+            (difference < borrow ? 1 : 0);
+        limbs_[index] = total;
+    }
+
+    return *this;
+}
+
+inline uint256_t& uint256_t::operator++()
+{
+    for (size_t index = 0; index < 4 && ++limbs_[index] == 0; ++index);
+    return *this;
+}
+
+inline uint256_t& uint256_t::operator--()
+{
+    for (size_t index = 0; index < 4 && limbs_[index]-- == 0; ++index);
+    return *this;
+}
+
+inline uint256_t uint256_t::operator++(int)
+{
+    const auto copy = *this;
+    ++(*this);
+    return copy;
+}
+
+inline uint256_t uint256_t::operator--(int)
+{
+    const auto copy = *this;
+    --(*this);
+    return copy;
+}
+
+// Bitwise.
+// ----------------------------------------------------------------------------
+
+inline uint256_t& uint256_t::operator&=(const uint256_t& other)
+{
+    for (size_t index = 0; index < 4; ++index)
+        limbs_[index] &= other.limbs_[index];
+
+    return *this;
+}
+
+inline uint256_t& uint256_t::operator|=(const uint256_t& other)
+{
+    for (size_t index = 0; index < 4; ++index)
+        limbs_[index] |= other.limbs_[index];
+
+    return *this;
+}
+
+inline uint256_t& uint256_t::operator^=(const uint256_t& other)
+{
+    for (size_t index = 0; index < 4; ++index)
+        limbs_[index] ^= other.limbs_[index];
+
+    return *this;
+}
+
+inline uint256_t& uint256_t::operator<<=(size_t shift)
+{
+    if (shift >= 256)
+        return *this = uint256_t();
+
+    const auto limbs = shift / 64;
+    const auto bits = shift % 64;
+
+    for (size_t index = 4; index-- > 0;)
+    {
+        const auto from = index - limbs;
+        uint64_t value = 0;
+
+        if (index >= limbs)
+        {
+            value = limbs_[from] << bits;
+
+            if (bits != 0 && from > 0)
+                value |= limbs_[from - 1] >> (64 - bits);
+        }
+
+        limbs_[index] = value;
+    }
+
+    return *this;
+}
+
+inline uint256_t& uint256_t::operator>>=(size_t shift)
+{
+    if (shift >= 256)
+        return *this = uint256_t();
+
+    const auto limbs = shift / 64;
+    const auto bits = shift % 64;
+
+    for (size_t index = 0; index < 4; ++index)
+    {
+        const auto from = index + limbs;
+        uint64_t value = 0;
+
+        if (from < 4)
+        {
+            value = limbs_[from] >> bits;
+
+            if (bits != 0 && from + 1 < 4)
+                value |= limbs_[from + 1] << (64 - bits);
+        }
+
+        limbs_[index] = value;
+    }
+
+    return *this;
+}
+
+// Operators.
+// ----------------------------------------------------------------------------
+
+BC_CONSTFUNC bool operator==(const uint256_t& left, const uint256_t& right)
+{
+    return left.compare(right) == 0;
+}
+
+BC_CONSTFUNC bool operator!=(const uint256_t& left, const uint256_t& right)
+{
+    return left.compare(right) != 0;
+}
+
+BC_CONSTFUNC bool operator<(const uint256_t& left, const uint256_t& right)
+{
+    return left.compare(right) < 0;
+}
+
+BC_CONSTFUNC bool operator>(const uint256_t& left, const uint256_t& right)
+{
+    return left.compare(right) > 0;
+}
+
+BC_CONSTFUNC bool operator<=(const uint256_t& left, const uint256_t& right)
+{
+    return left.compare(right) <= 0;
+}
+
+BC_CONSTFUNC bool operator>=(const uint256_t& left, const uint256_t& right)
+{
+    return left.compare(right) >= 0;
+}
+
+inline uint256_t operator+(uint256_t left, const uint256_t& right)
+{
+    return left += right;
+}
+
+inline uint256_t operator-(uint256_t left, const uint256_t& right)
+{
+    return left -= right;
+}
+
+inline uint256_t operator*(uint256_t left, const uint256_t& right)
+{
+    return left *= right;
+}
+
+inline uint256_t operator/(uint256_t left, const uint256_t& right)
+{
+    return left /= right;
+}
+
+inline uint256_t operator%(uint256_t left, const uint256_t& right)
+{
+    return left %= right;
+}
+
+inline uint256_t operator&(uint256_t left, const uint256_t& right)
+{
+    return left &= right;
+}
+
+inline uint256_t operator|(uint256_t left, const uint256_t& right)
+{
+    return left |= right;
+}
+
+inline uint256_t operator^(uint256_t left, const uint256_t& right)
+{
+    return left ^= right;
+}
+
+inline uint256_t operator<<(uint256_t left, size_t shift)
+{
+    return left <<= shift;
+}
+
+inline uint256_t operator>>(uint256_t left, size_t shift)
+{
+    return left >>= shift;
+}
+
+inline uint256_t operator~(const uint256_t& value)
+{
+    return
+    {
+        ~value.limb(0), ~value.limb(1), ~value.limb(2), ~value.limb(3)
+    };
+}
+
+inline uint256_t operator-(const uint256_t& value)
+{
+    return ++(~value);
+}
+
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MESSAGE_COMPACT_BLOCK_RECONSTRUCTOR_IPP
+#define LIBBITCOIN_MESSAGE_COMPACT_BLOCK_RECONSTRUCTOR_IPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+// Pool transactions offered per batch of short id hashes.
+static BC_CONSTEXPR size_t reconstructor_batch = 256;
+
+// Stops early once complete, as the remainder of the source cannot fill.
+template <typename Iterator>
+size_t compact_block_reconstructor::fill(Iterator first, Iterator last)
+{
+    size_t filled = 0;
+    hash_list hashes;
+    std::vector<uint64_t> ids;
+    hashes.reserve(reconstructor_batch);
+
+    while (first != last && !is_complete())
+    {
+        hashes.clear();
+
+        for (auto it = first; it != last &&
+            hashes.size() < reconstructor_batch; ++it)
+            hashes.push_back(short_id_hash(*it));
+
+        short_ids(hashes, ids);
+
+        for (const auto id: ids)
+        {
+            if (is_complete())
+                break;
+
+            if (fill(*first++, id))
+                ++filled;
+        }
+    }
+
+    return filled;
+}
+
+} // namespace message
+} // namespace libbitcoin
+
+#endif
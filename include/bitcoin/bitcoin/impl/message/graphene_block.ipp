@@ -0,0 +1,44 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MESSAGE_GRAPHENE_BLOCK_IPP
+#define LIBBITCOIN_MESSAGE_GRAPHENE_BLOCK_IPP
+
+namespace libbitcoin {
+namespace message {
+
+// Only transactions passing the filter are candidates, an empty filter is
+// sent when the receiver's pool is not expected to exceed the block.
+template <typename Iterator>
+graphene_block::result graphene_block::reconstruct(Iterator first,
+    Iterator last, chain::block& out, short_id_list& out_missing) const
+{
+    const auto unfiltered = filter_.filter().empty();
+    candidates pool;
+
+    for (; first != last; ++first)
+        if (unfiltered || filter_.contains(first->hash()))
+            pool.push_back(&*first);
+
+    return reconstruct(pool, out, out_missing);
+}
+
+} // namespace message
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,389 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_RING_WINDOW_IPP
+#define LIBBITCOIN_RING_WINDOW_IPP
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+
+namespace libbitcoin {
+
+// A new buffer holds twice the window, so a window of stable size is moved
+// once for each window length of appends.
+static BC_CONSTEXPR size_t ring_window_minimum_capacity = 16;
+
+template <typename Element, typename Total>
+ring_window<Element, Total>::buffer::buffer(size_t capacity)
+  : values(capacity), end(0)
+{
+}
+
+template <typename Element, typename Total>
+ring_window<Element, Total>::ring_window()
+  : first_(0), last_(0)
+{
+}
+
+// Copies share the buffer.
+template <typename Element, typename Total>
+ring_window<Element, Total>::ring_window(const ring_window& other)
+  : buffer_(other.buffer_), first_(other.first_), last_(other.last_)
+{
+}
+
+template <typename Element, typename Total>
+ring_window<Element, Total>::ring_window(ring_window&& other)
+  : buffer_(std::move(other.buffer_)), first_(other.first_),
+    last_(other.last_)
+{
+    other.first_ = 0;
+    other.last_ = 0;
+}
+
+template <typename Element, typename Total>
+ring_window<Element, Total>::ring_window(std::initializer_list<Element> values)
+  : first_(0), last_(0)
+{
+    assign(values);
+}
+
+template <typename Element, typename Total>
+ring_window<Element, Total>& ring_window<Element, Total>::operator=(
+    const ring_window& other)
+{
+    buffer_ = other.buffer_;
+    first_ = other.first_;
+    last_ = other.last_;
+    return *this;
+}
+
+template <typename Element, typename Total>
+ring_window<Element, Total>& ring_window<Element, Total>::operator=(
+    ring_window&& other)
+{
+    if (this == &other)
+        return *this;
+
+    buffer_ = std::move(other.buffer_);
+    first_ = other.first_;
+    last_ = other.last_;
+    other.first_ = 0;
+    other.last_ = 0;
+    return *this;
+}
+
+template <typename Element, typename Total>
+ring_window<Element, Total>& ring_window<Element, Total>::operator=(
+    std::initializer_list<Element> values)
+{
+    assign(values);
+    return *this;
+}
+
+// Properties.
+//-----------------------------------------------------------------------------
+
+template <typename Element, typename Total>
+bool ring_window<Element, Total>::empty() const
+{
+    return first_ == last_;
+}
+
+template <typename Element, typename Total>
+size_t ring_window<Element, Total>::size() const
+{
+    return last_ - first_;
+}
+
+// Read access.
+//-----------------------------------------------------------------------------
+
+template <typename Element, typename Total>
+typename ring_window<Element, Total>::const_iterator
+ring_window<Element, Total>::begin() const
+{
+    return buffer_ ? buffer_->values.data() + first_ : nullptr;
+}
+
+template <typename Element, typename Total>
+typename ring_window<Element, Total>::const_iterator
+ring_window<Element, Total>::end() const
+{
+    return buffer_ ? buffer_->values.data() + last_ : nullptr;
+}
+
+template <typename Element, typename Total>
+typename ring_window<Element, Total>::const_reverse_iterator
+ring_window<Element, Total>::rbegin() const
+{
+    return const_reverse_iterator(end());
+}
+
+template <typename Element, typename Total>
+typename ring_window<Element, Total>::const_reverse_iterator
+ring_window<Element, Total>::rend() const
+{
+    return const_reverse_iterator(begin());
+}
+
+template <typename Element, typename Total>
+typename ring_window<Element, Total>::const_reference
+ring_window<Element, Total>::operator[](size_t index) const
+{
+    BITCOIN_ASSERT(index < size());
+    return buffer_->values[first_ + index];
+}
+
+template <typename Element, typename Total>
+typename ring_window<Element, Total>::const_reference
+ring_window<Element, Total>::at(size_t index) const
+{
+    if (index >= size())
+        throw std::out_of_range("ring_window index out of range");
+
+    return buffer_->values[first_ + index];
+}
+
+template <typename Element, typename Total>
+typename ring_window<Element, Total>::const_reference
+ring_window<Element, Total>::front() const
+{
+    BITCOIN_ASSERT(!empty());
+    return buffer_->values[first_];
+}
+
+template <typename Element, typename Total>
+typename ring_window<Element, Total>::const_reference
+ring_window<Element, Total>::back() const
+{
+    BITCOIN_ASSERT(!empty());
+    return buffer_->values[last_ - 1u];
+}
+
+// Write access.
+//-----------------------------------------------------------------------------
+
+template <typename Element, typename Total>
+typename ring_window<Element, Total>::iterator
+ring_window<Element, Total>::begin()
+{
+    writable();
+    return buffer_ ? buffer_->values.data() + first_ : nullptr;
+}
+
+template <typename Element, typename Total>
+typename ring_window<Element, Total>::iterator
+ring_window<Element, Total>::end()
+{
+    writable();
+    return buffer_ ? buffer_->values.data() + last_ : nullptr;
+}
+
+template <typename Element, typename Total>
+typename ring_window<Element, Total>::reverse_iterator
+ring_window<Element, Total>::rbegin()
+{
+    return reverse_iterator(end());
+}
+
+template <typename Element, typename Total>
+typename ring_window<Element, Total>::reverse_iterator
+ring_window<Element, Total>::rend()
+{
+    return reverse_iterator(begin());
+}
+
+template <typename Element, typename Total>
+typename ring_window<Element, Total>::reference
+ring_window<Element, Total>::operator[](size_t index)
+{
+    BITCOIN_ASSERT(index < size());
+    writable();
+    return buffer_->values[first_ + index];
+}
+
+template <typename Element, typename Total>
+typename ring_window<Element, Total>::reference
+ring_window<Element, Total>::at(size_t index)
+{
+    if (index >= size())
+        throw std::out_of_range("ring_window index out of range");
+
+    writable();
+    return buffer_->values[first_ + index];
+}
+
+template <typename Element, typename Total>
+typename ring_window<Element, Total>::reference
+ring_window<Element, Total>::front()
+{
+    BITCOIN_ASSERT(!empty());
+    writable();
+    return buffer_->values[first_];
+}
+
+template <typename Element, typename Total>
+typename ring_window<Element, Total>::reference
+ring_window<Element, Total>::back()
+{
+    BITCOIN_ASSERT(!empty());
+    writable();
+    return buffer_->values[last_ - 1u];
+}
+
+// Modifiers.
+//-----------------------------------------------------------------------------
+
+template <typename Element, typename Total>
+void ring_window<Element, Total>::push_back(const Element& value)
+{
+    // Claim the next slot if no copy has extended the buffer past this one.
+    if (buffer_ && last_ < buffer_->values.size())
+    {
+        auto expected = last_;
+
+        if (buffer_->end.compare_exchange_strong(expected, last_ + 1u))
+        {
+            buffer_->values[last_++] = value;
+            return;
+        }
+    }
+
+    detach(std::max(ring_window_minimum_capacity, 2u * (size() + 1u)));
+    buffer_->values[last_++] = value;
+    buffer_->end = last_;
+}
+
+template <typename Element, typename Total>
+void ring_window<Element, Total>::pop_front()
+{
+    BITCOIN_ASSERT(!empty());
+    ++first_;
+}
+
+template <typename Element, typename Total>
+void ring_window<Element, Total>::resize(size_t size)
+{
+    if (size <= this->size())
+    {
+        last_ = first_ + size;
+        return;
+    }
+
+    detach(std::max(ring_window_minimum_capacity, 2u * size));
+    std::fill(buffer_->values.begin() + last_, buffer_->values.begin() + size,
+        Element{});
+    last_ = size;
+    buffer_->end = last_;
+}
+
+template <typename Element, typename Total>
+void ring_window<Element, Total>::clear()
+{
+    buffer_.reset();
+    first_ = 0;
+    last_ = 0;
+}
+
+template <typename Element, typename Total>
+template <typename Measure>
+Total ring_window<Element, Total>::total(size_t first, size_t last,
+    Measure measure) const
+{
+    BITCOIN_ASSERT(first <= last && last <= size());
+
+    if (first == last)
+        return Total{};
+
+    const auto from = first_ + first;
+    const auto to = first_ + last;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(buffer_->mutex);
+    auto& totals = buffer_->totals;
+
+    if (totals.empty())
+        totals.push_back(Total{});
+
+    // Slots below the end of any copy are never rewritten while shared.
+    while (totals.size() <= to)
+        totals.push_back(totals.back() +
+            measure(buffer_->values[totals.size() - 1u]));
+
+    return totals[to] - totals[from];
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Utilities.
+//-----------------------------------------------------------------------------
+
+template <typename Element, typename Total>
+void ring_window<Element, Total>::assign(std::initializer_list<Element> values)
+{
+    const auto size = values.size();
+    buffer_ = std::make_shared<buffer>(std::max(ring_window_minimum_capacity,
+        2u * size));
+    std::copy(values.begin(), values.end(), buffer_->values.begin());
+    buffer_->end = size;
+    first_ = 0;
+    last_ = size;
+}
+
+// Move the window to the front of a new buffer owned by this instance.
+template <typename Element, typename Total>
+void ring_window<Element, Total>::detach(size_t capacity)
+{
+    const auto size = this->size();
+    BITCOIN_ASSERT(capacity >= size);
+    auto fresh = std::make_shared<buffer>(capacity);
+
+    if (buffer_)
+        std::copy(buffer_->values.begin() + first_,
+            buffer_->values.begin() + last_, fresh->values.begin());
+
+    fresh->end = size;
+    buffer_ = fresh;
+    first_ = 0;
+    last_ = size;
+}
+
+// Detach if shared, otherwise invalidate the memoized totals.
+template <typename Element, typename Total>
+void ring_window<Element, Total>::writable()
+{
+    if (!buffer_)
+        return;
+
+    if (buffer_.use_count() == 1)
+        buffer_->totals.clear();
+    else
+        detach(buffer_->values.size());
+}
+
+} // namespace libbitcoin
+
+#endif
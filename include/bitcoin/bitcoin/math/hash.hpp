@@ -23,9 +23,9 @@
 #include <string>
 #include <vector>
 #include <boost/functional/hash_fwd.hpp>
-#include <boost/multiprecision/cpp_int.hpp>
 #include <bitcoin/bitcoin/compat.hpp>
 #include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/uint256.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
 #include <bitcoin/bitcoin/utility/endian.hpp>
 
@@ -55,9 +55,6 @@ typedef std::vector<long_hash> long_hash_list;
 typedef std::vector<short_hash> short_hash_list;
 typedef std::vector<mini_hash> mini_hash_list;
 
-// Alias for boost big integer type.
-typedef boost::multiprecision::uint256_t uint256_t;
-
 // Null-valued common bitcoin hashes.
 
 BC_CONSTEXPR hash_digest null_hash
@@ -111,7 +108,7 @@ BC_CONSTEXPR mini_hash null_mini_hash
 
 inline uint256_t to_uint256(const hash_digest& hash)
 {
-    return from_little_endian<uint256_t>(hash.begin(), hash.end());
+    return uint256_t(hash);
 }
 
 /// Generate a scrypt hash to fill a byte array.
@@ -163,6 +160,13 @@ BC_API long_hash hmac_sha512_hash(data_slice data, data_slice key);
 BC_API long_hash pkcs5_pbkdf2_hmac_sha512(data_slice passphrase,
     data_slice salt, size_t iterations);
 
+/// Generate a murmur3 (x86 32 bit) hash, as used by bloom filters (BIP37).
+BC_API uint32_t murmur3(data_slice data, uint32_t seed);
+
+/// Generate a murmur3 hash for each of count seeds in one pass over the data.
+BC_API void murmur3(data_slice data, const uint32_t* seeds, uint32_t* out,
+    size_t count);
+
 } // namespace libbitcoin
 
 // Extend std and boost namespaces with our hash wrappers.
@@ -20,7 +20,9 @@
 #define BITPRIM_SIP_HASH_HPP_
 
 #include <cstdint>
+#include <vector>
 
+#include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
 //#include <bitcoin/bitcoin/math/uint256.hpp>
 
@@ -94,6 +96,13 @@ public:
 uint64_t sip_hash_uint256(uint64_t k0, uint64_t k1, hash_digest const& val);
 uint64_t sip_hash_uint256_extra(uint64_t k0, uint64_t k1, hash_digest const& val, uint32_t extra);
 
+/** SipHash-2-4 of each value, identical to sip_hash_uint256 per value.
+ *
+ *  Values are hashed four at a time in vector lanes where supported.
+ */
+BC_API void sip_hash_uint256(uint64_t k0, uint64_t k1, hash_list const& values,
+    std::vector<uint64_t>& out);
+
 } // namespace libbitcoin
 
 #endif /* BITPRIM_SIP_HASH_HPP_ */
@@ -19,12 +19,125 @@
 #ifndef LIBBBITCOIN_UINT256_HPP
 #define LIBBBITCOIN_UINT256_HPP
 
-#include <boost/multiprecision/cpp_int.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <bitcoin/bitcoin/define.hpp>
 
 namespace libbitcoin {
 
+/// A fixed width 256 bit unsigned integer of four 64 bit limbs.
+/// Arithmetic is modulo 2^256 and conversion from a negative integer is
+/// two's complement. This is the type of proof, target and chain work values.
+class BC_API uint256_t
+{
+public:
+    /// Constructors.
+    BC_CONSTFUNC uint256_t();
+    BC_CONSTFUNC uint256_t(uint64_t low, uint64_t low_middle,
+        uint64_t high_middle, uint64_t high);
 
+    template <typename Integer, typename = typename std::enable_if<
+        std::is_integral<Integer>::value>::type>
+    BC_CONSTFUNC uint256_t(Integer value);
+
+    /// Construct from 32 little endian bytes, such as a hash.
+    explicit uint256_t(const std::array<uint8_t, 32>& little_endian);
+
+    /// Construct from a hexadecimal (0x prefixed) or decimal string.
+    /// Throws std::invalid_argument if the text is not a valid number.
+    explicit uint256_t(const std::string& text);
+    explicit uint256_t(const char* text);
+
+    /// Properties, limbs are ordered from least to most significant.
+    BC_CONSTFUNC uint64_t limb(size_t index) const;
+    BC_CONSTFUNC bool is_zero() const;
+    size_t bit_length() const;
+    BC_CONSTFUNC int compare(const uint256_t& other) const;
+
+    /// The little endian byte representation.
+    std::array<uint8_t, 32> to_little_endian() const;
+
+    /// Conversion to the low bits of an integer (or non-zero for bool).
+    BC_CONSTFUNC explicit operator bool() const;
+
+    template <typename Integer, typename = typename std::enable_if<
+        std::is_integral<Integer>::value &&
+        !std::is_same<Integer, bool>::value>::type>
+    BC_CONSTFUNC explicit operator Integer() const;
+
+    /// Arithmetic, divide and modulo throw std::overflow_error on zero.
+    uint256_t& operator+=(const uint256_t& other);
+    uint256_t& operator-=(const uint256_t& other);
+    uint256_t& operator*=(const uint256_t& other);
+    uint256_t& operator/=(const uint256_t& other);
+    uint256_t& operator%=(const uint256_t& other);
+    uint256_t& operator++();
+    uint256_t& operator--();
+    uint256_t operator++(int);
+    uint256_t operator--(int);
+
+    /// Bitwise.
+    uint256_t& operator&=(const uint256_t& other);
+    uint256_t& operator|=(const uint256_t& other);
+    uint256_t& operator^=(const uint256_t& other);
+    uint256_t& operator<<=(size_t shift);
+    uint256_t& operator>>=(size_t shift);
+
+    /// Multiply by a 64 bit value, returning the carry out of the high limb.
+    uint64_t multiply(uint64_t factor);
+
+    /// Divide by a non-zero 64 bit value, returning the remainder.
+    uint64_t divide(uint64_t divisor);
+
+    /// Quotient and remainder, throws std::overflow_error on zero divisor.
+    static void divide(const uint256_t& dividend, const uint256_t& divisor,
+        uint256_t& quotient, uint256_t& remainder);
+
+private:
+    template <typename Integer>
+    static BC_CONSTFUNC uint64_t extend(Integer value, std::true_type);
+
+    template <typename Integer>
+    static BC_CONSTFUNC uint64_t extend(Integer value, std::false_type);
+
+    BC_CONSTFUNC bool is_zero(size_t from) const;
+
+    // A plain array is constexpr accessible in C++11.
+    uint64_t limbs_[4];
+};
+
+// Operators.
+// ----------------------------------------------------------------------------
+
+BC_CONSTFUNC bool operator==(const uint256_t& left, const uint256_t& right);
+BC_CONSTFUNC bool operator!=(const uint256_t& left, const uint256_t& right);
+BC_CONSTFUNC bool operator<(const uint256_t& left, const uint256_t& right);
+BC_CONSTFUNC bool operator>(const uint256_t& left, const uint256_t& right);
+BC_CONSTFUNC bool operator<=(const uint256_t& left, const uint256_t& right);
+BC_CONSTFUNC bool operator>=(const uint256_t& left, const uint256_t& right);
+
+uint256_t operator+(uint256_t left, const uint256_t& right);
+uint256_t operator-(uint256_t left, const uint256_t& right);
+uint256_t operator*(uint256_t left, const uint256_t& right);
+uint256_t operator/(uint256_t left, const uint256_t& right);
+uint256_t operator%(uint256_t left, const uint256_t& right);
+uint256_t operator&(uint256_t left, const uint256_t& right);
+uint256_t operator|(uint256_t left, const uint256_t& right);
+uint256_t operator^(uint256_t left, const uint256_t& right);
+uint256_t operator<<(uint256_t left, size_t shift);
+uint256_t operator>>(uint256_t left, size_t shift);
+uint256_t operator~(const uint256_t& value);
+uint256_t operator-(const uint256_t& value);
+
+/// Decimal, or hexadecimal if the stream has the hex flag.
+BC_API std::ostream& operator<<(std::ostream& output, const uint256_t& value);
 
 } // namespace libbitcoin
 
+#include <bitcoin/bitcoin/impl/math/uint256.ipp>
+
 #endif
@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MESSAGE_COMPACT_BLOCK_RECONSTRUCTOR_HPP
+#define LIBBITCOIN_MESSAGE_COMPACT_BLOCK_RECONSTRUCTOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/message/block_transactions.hpp>
+#include <bitcoin/bitcoin/message/compact_block.hpp>
+#include <bitcoin/bitcoin/message/get_block_transactions.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+/// Rebuilds a block from a compact block (BIP152), the transactions already
+/// known to the node and, for those not known, a block_transactions reply.
+/// Transaction slots are found by short id through one hash table. A slot
+/// matched by two distinct transactions is treated as missing. Indexes
+/// exchanged with peers are differentially encoded, as on the wire.
+class BC_API compact_block_reconstructor
+{
+public:
+    typedef std::vector<uint64_t> indexes;
+
+    compact_block_reconstructor(const compact_block& block);
+
+    /// False if prefilled indexes are out of order or range, or if short ids
+    /// of the compact block collide (the full block must be requested).
+    bool is_valid() const;
+
+    /// True when every transaction slot is filled.
+    bool is_complete() const;
+
+    /// Offer a known transaction, true if it filled an empty slot.
+    bool fill(const chain::transaction& tx);
+
+    /// Offer each transaction of a source, such as the memory pool. Short ids
+    /// are hashed in batches, so the iterator must be multipass.
+    template <typename Iterator>
+    size_t fill(Iterator first, Iterator last);
+
+    /// Fill the missing slots, in order, from the peer's reply. False if the
+    /// reply is for another block or does not fill exactly the missing slots.
+    bool fill(const block_transactions& reply);
+
+    /// Block positions of the transactions still missing.
+    indexes missing() const;
+
+    /// The request for the missing transactions.
+    get_block_transactions to_request() const;
+
+    /// The reconstructed block. False if incomplete or if the merkle root does
+    /// not match, as is the case for an undetected short id collision.
+    bool to_block(chain::block& out) const;
+
+private:
+    enum class slot: uint8_t
+    {
+        empty,
+        filled,
+        collided
+    };
+
+    static hash_digest short_id_hash(const chain::transaction& tx);
+    uint64_t short_id(const chain::transaction& tx) const;
+    void short_ids(const hash_list& hashes, std::vector<uint64_t>& out) const;
+    bool fill(const chain::transaction& tx, uint64_t short_id);
+
+    chain::header header_;
+    hash_digest hash_;
+    uint64_t key0_;
+    uint64_t key1_;
+    bool valid_;
+    size_t remaining_;
+    chain::transaction::list transactions_;
+    std::vector<slot> slots_;
+    std::unordered_map<uint64_t, size_t> positions_;
+};
+
+} // namespace message
+} // namespace libbitcoin
+
+#include <bitcoin/bitcoin/impl/message/compact_block_reconstructor.ipp>
+
+#endif
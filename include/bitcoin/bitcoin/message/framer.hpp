@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MESSAGE_FRAMER_HPP
+#define LIBBITCOIN_MESSAGE_FRAMER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/message/heading.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+/// Finds message frames in a contiguous receive buffer. The heading is read
+/// and the payload checksum verified in place, and the payload is returned
+/// as a slice of the buffer, to be parsed with deserialize without a copy.
+/// The buffer must outlive the payload slice and any parse of it.
+class BC_API framer
+{
+public:
+    enum class result
+    {
+        /// A checked frame is at the front of the buffer.
+        complete,
+
+        /// The buffer holds only part of the next frame.
+        incomplete,
+
+        /// The frame is for another network, oversized or fails checksum.
+        invalid
+    };
+
+    framer(uint32_t magic, uint32_t version, bool witness);
+
+    uint32_t magic() const;
+    size_t maximum_payload_size() const;
+
+    /// Read the frame at the front of the buffer. When complete, out_size is
+    /// the size of the frame, to be consumed from the buffer by the caller.
+    result read(data_slice buffer, heading& out_heading,
+        data_slice& out_payload, size_t& out_size) const;
+
+private:
+    const uint32_t magic_;
+    const size_t maximum_payload_size_;
+};
+
+} // namespace message
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,130 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MESSAGE_GRAPHENE_BLOCK_HPP
+#define LIBBITCOIN_MESSAGE_GRAPHENE_BLOCK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <vector>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/chain/bloom_filter.hpp>
+#include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/chain/iblt.hpp>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/reader.hpp>
+#include <bitcoin/bitcoin/utility/writer.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+/// A block encoded for set reconciliation (Graphene). The transaction hashes
+/// are sent as a bloom filter and an invertible bloom lookup table of short
+/// ids, sized from the receiver's estimated pool size. The receiver passes
+/// its pool through the filter and peels the table against the result,
+/// which yields the block's transactions it lacks and the filter's false
+/// positives. Canonically ordered (CTOR) blocks carry no ordering.
+class BC_API graphene_block
+{
+public:
+    typedef std::vector<uint64_t> short_id_list;
+    typedef std::vector<uint32_t> order_list;
+
+    enum class result
+    {
+        /// The block is reconstructed.
+        complete,
+
+        /// The block's transactions of the returned short ids are missing
+        /// from the pool, reconstruct again once they are obtained.
+        incomplete,
+
+        /// The table did not decode or the result is not the block, the
+        /// block must be requested by other means (compact or full block).
+        failed
+    };
+
+    static graphene_block factory_from_data(uint32_t version,
+        const data_chunk& data);
+    static graphene_block factory_from_data(uint32_t version,
+        std::istream& stream);
+    static graphene_block factory_from_data(uint32_t version,
+        reader& source);
+
+    graphene_block();
+
+    /// Encode the block for a receiver of about pool_size pool transactions.
+    graphene_block(const chain::block& block, uint64_t nonce,
+        size_t pool_size);
+
+    const chain::header& header() const;
+    uint64_t nonce() const;
+    const chain::transaction& coinbase() const;
+    uint32_t transaction_count() const;
+    const chain::bloom_filter& filter() const;
+    const chain::iblt& table() const;
+
+    /// The block position of each transaction, in short id order, excluding
+    /// the coinbase. Empty if the block is canonically ordered.
+    const order_list& order() const;
+
+    /// The short id of a transaction in this encoding.
+    uint64_t short_id(const chain::transaction& tx) const;
+
+    /// Rebuild the block from the pool, such as the memory pool.
+    template <typename Iterator>
+    result reconstruct(Iterator first, Iterator last, chain::block& out,
+        short_id_list& out_missing) const;
+
+    bool from_data(uint32_t version, const data_chunk& data);
+    bool from_data(uint32_t version, std::istream& stream);
+    bool from_data(uint32_t version, reader& source);
+    data_chunk to_data(uint32_t version) const;
+    void to_data(uint32_t version, std::ostream& stream) const;
+    void to_data(uint32_t version, writer& sink) const;
+    bool is_valid() const;
+    void reset();
+    size_t serialized_size(uint32_t version) const;
+
+private:
+    typedef std::vector<const chain::transaction*> candidates;
+
+    void set_keys();
+    result reconstruct(const candidates& pool, chain::block& out,
+        short_id_list& out_missing) const;
+
+    chain::header header_;
+    uint64_t nonce_;
+    chain::transaction coinbase_;
+    uint32_t transaction_count_;
+    chain::bloom_filter filter_;
+    chain::iblt table_;
+    order_list order_;
+    uint64_t key0_;
+    uint64_t key1_;
+};
+
+} // namespace message
+} // namespace libbitcoin
+
+#include <bitcoin/bitcoin/impl/message/graphene_block.ipp>
+
+#endif
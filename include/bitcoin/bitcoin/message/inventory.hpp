@@ -25,6 +25,7 @@
 #include <istream>
 #include <memory>
 #include <string>
+#include <bitcoin/bitcoin/chain/rolling_bloom_filter.hpp>
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/message/inventory_vector.hpp>
@@ -73,6 +74,12 @@ public:
     size_t serialized_size(uint32_t version) const;
     size_t count(type_id type) const;
 
+    /// Remove the entries the peer is known to have, return the count removed.
+    size_t remove_known(const chain::rolling_bloom_filter& known);
+
+    /// Record each entry as known to the peer.
+    void add_known(chain::rolling_bloom_filter& known) const;
+
     // This class is move assignable but not copy assignable.
     inventory& operator=(inventory&& other);
     void operator=(const inventory&) = delete;
@@ -25,6 +25,8 @@
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/chain/block.hpp>
 #include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/chain/merkle_tree.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
@@ -51,6 +53,14 @@ public:
     merkle_block(chain::header&& header, size_t total_transactions,
         hash_list&& hashes, data_chunk&& flags);
     merkle_block(const chain::block& block);
+
+    /// Partial merkle tree (BIP37) proving the matched transactions, one
+    /// match per transaction. The block form uses the block's cached tree.
+    merkle_block(const chain::block& block,
+        const chain::merkle_tree::matches& matched);
+    merkle_block(const chain::header& header, const chain::merkle_tree& tree,
+        const chain::merkle_tree::matches& matched);
+
     merkle_block(const merkle_block& other);
     merkle_block(merkle_block&& other);
 
@@ -80,6 +90,12 @@ public:
     void to_data(uint32_t version, writer& sink) const;
     bool is_valid() const;
     void reset();
+
+    /// Verify the partial merkle tree against the header merkle root and
+    /// extract the matched transaction hashes and their block positions.
+    bool extract(hash_list& out_hashes,
+        chain::merkle_tree::indexes& out_positions) const;
+
     size_t serialized_size(uint32_t version) const;
 
     // This class is move assignable but not copy assignable.
@@ -47,6 +47,7 @@
 #include <bitcoin/bitcoin/message/network_address.hpp>
 #include <bitcoin/bitcoin/message/not_found.hpp>
 #include <bitcoin/bitcoin/message/ping.hpp>
+#include <bitcoin/bitcoin/message/pooled_message.hpp>
 #include <bitcoin/bitcoin/message/pong.hpp>
 #include <bitcoin/bitcoin/message/reject.hpp>
 #include <bitcoin/bitcoin/message/send_compact.hpp>
@@ -54,8 +55,11 @@
 #include <bitcoin/bitcoin/message/transaction.hpp>
 #include <bitcoin/bitcoin/message/verack.hpp>
 #include <bitcoin/bitcoin/message/version.hpp>
+#include <bitcoin/bitcoin/utility/buffer_pool.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
+#include <bitcoin/bitcoin/utility/serializer.hpp>
 
 // Minimum current libbitcoin protocol version:     31402
 // Minimum current satoshi client protocol version: 31800
@@ -179,17 +183,50 @@ data_chunk serialize(uint32_t version, const Message& packet,
     const auto check = bitcoin_checksum(slice);
     const auto payload_size32 = safe_unsigned<uint32_t>(payload_size);
 
-    // Create and serialize the heading to a temporary variable (12 bytes).
-    heading head(magic, Message::command, payload_size32, check);
-    auto heading = head.to_data();
-
-    // Move the heading into the allocated beginning of the message buffer.
-    std::move(heading.begin(), heading.end(), data.begin());
+    // Serialize the heading into the allocated beginning of the buffer.
+    const heading head(magic, Message::command, payload_size32, check);
+    auto sink = make_unsafe_serializer(data.begin());
+    head.to_data(sink);
     return data;
 }
 
+/// Serialize a message object into a pooled payload buffer and an in place
+/// heading, for a vectored write without concatenation of the two.
+template <typename Message>
+pooled_message serialize(uint32_t version, const Message& packet,
+    uint32_t magic, buffer_pool& pool)
+{
+    const auto payload_size = packet.serialized_size(version);
+
+    pooled_message out;
+    out.payload = pool.acquire(payload_size);
+    auto payload = make_unsafe_serializer(out.payload->begin());
+    packet.to_data(version, payload);
+
+    const auto check = bitcoin_checksum(*out.payload);
+    const auto payload_size32 = safe_unsigned<uint32_t>(payload_size);
+    BITCOIN_ASSERT(out.heading.size() == heading::satoshi_fixed_size());
+
+    const heading head(magic, Message::command, payload_size32, check);
+    auto sink = make_unsafe_serializer(out.heading.begin());
+    head.to_data(sink);
+    return out;
+}
+
+/// Deserialize a message payload in place, such as a slice of the receive
+/// buffer returned by the framer, without copying the payload.
+template <typename Message>
+bool deserialize(uint32_t version, data_slice payload, Message& out)
+{
+    auto source = make_safe_deserializer(payload.begin(), payload.end());
+    return out.from_data(version, source);
+}
+
 BC_API size_t variable_uint_size(uint64_t value);
 
+/// The encoded size of a variable integer, given its first byte.
+BC_API size_t variable_prefix_size(uint8_t prefix);
+
 } // namespace message
 } // namespace libbitcoin
 
@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MESSAGE_POOLED_MESSAGE_HPP
+#define LIBBITCOIN_MESSAGE_POOLED_MESSAGE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/utility/asio.hpp>
+#include <bitcoin/bitcoin/utility/buffer_pool.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+/// A message serialized for a vectored write, the heading in place and the
+/// payload in a pooled buffer. The message must be retained until the write
+/// completes, after which the payload buffer returns to its pool.
+struct pooled_message
+{
+    typedef byte_array<sizeof(uint32_t) + command_size + sizeof(uint32_t) +
+        sizeof(uint32_t)> heading_bytes;
+
+    typedef std::array<boost::asio::const_buffer, 2> buffers;
+
+    heading_bytes heading;
+    buffer_pool::buffer_ptr payload;
+
+    /// The heading and payload buffer sequence, as for async_write.
+    buffers to_buffers() const
+    {
+        return
+        {
+            {
+                boost::asio::buffer(heading),
+                boost::asio::buffer(*payload)
+            }
+        };
+    }
+
+    size_t size() const
+    {
+        return heading.size() + payload->size();
+    }
+};
+
+} // namespace message
+} // namespace libbitcoin
+
+#endif
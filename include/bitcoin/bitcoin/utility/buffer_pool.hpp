@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BUFFER_POOL_HPP
+#define LIBBITCOIN_BUFFER_POOL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/noncopyable.hpp>
+#include <bitcoin/bitcoin/utility/thread.hpp>
+
+namespace libbitcoin {
+
+/// A pool of byte buffers, thread safe. A buffer returns to the pool, with
+/// its allocation, when its last reference is released. Buffers released to
+/// a full pool, or once the pool is destroyed, are freed.
+class BC_API buffer_pool
+  : noncopyable
+{
+public:
+    typedef std::shared_ptr<data_chunk> buffer_ptr;
+
+    /// Retain at most capacity idle buffers.
+    buffer_pool(size_t capacity);
+
+    /// A buffer of the given size, reusing an idle buffer when available.
+    buffer_ptr acquire(size_t size);
+
+    /// The number of idle buffers.
+    size_t idle() const;
+
+private:
+    struct store
+    {
+        size_t capacity;
+        std::vector<data_chunk> buffers;
+        mutable shared_mutex mutex;
+    };
+
+    typedef std::shared_ptr<store> store_ptr;
+
+    static void release(const std::weak_ptr<store>& weak, data_chunk* buffer);
+
+    const store_ptr store_;
+};
+
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_RING_WINDOW_HPP
+#define LIBBITCOIN_RING_WINDOW_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace libbitcoin {
+
+/// A sliding window of values, shared copy-on-write between copies.
+/// This class is not thread safe, but distinct copies may be used
+/// concurrently. Copies share one append-only buffer. A copy that appends at
+/// the end of the buffer extends it in place, a copy that appends behind the
+/// end (a fork) or at capacity moves its window into a new buffer. Slots that
+/// any copy can see are never overwritten, so copy, push_back and pop_front
+/// are amortized constant time. Mutable element access detaches a shared
+/// window first. Totals of a measure over ranges are memoized as prefix sums
+/// in the buffer and so are shared by all copies of the window.
+template <typename Element, typename Total=Element>
+class ring_window
+{
+public:
+    typedef Element value_type;
+    typedef size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef Element& reference;
+    typedef const Element& const_reference;
+    typedef Element* iterator;
+    typedef const Element* const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    ring_window();
+    ring_window(const ring_window& other);
+    ring_window(ring_window&& other);
+    ring_window(std::initializer_list<Element> values);
+
+    ring_window& operator=(const ring_window& other);
+    ring_window& operator=(ring_window&& other);
+    ring_window& operator=(std::initializer_list<Element> values);
+
+    /// Properties.
+    bool empty() const;
+    size_t size() const;
+
+    /// Read access, does not detach.
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_reverse_iterator rbegin() const;
+    const_reverse_iterator rend() const;
+    const_reference operator[](size_t index) const;
+    const_reference at(size_t index) const;
+    const_reference front() const;
+    const_reference back() const;
+
+    /// Write access, detaches the window from any copies.
+    iterator begin();
+    iterator end();
+    reverse_iterator rbegin();
+    reverse_iterator rend();
+    reference operator[](size_t index);
+    reference at(size_t index);
+    reference front();
+    reference back();
+
+    /// Modifiers.
+    void push_back(const Element& value);
+    void pop_front();
+    void resize(size_t size);
+    void clear();
+
+    /// The sum of measure(element) over the elements [first, last).
+    /// The measure must be the same function for all copies of the window.
+    template <typename Measure>
+    Total total(size_t first, size_t last, Measure measure) const;
+
+private:
+    struct buffer
+    {
+        explicit buffer(size_t capacity);
+
+        std::vector<Element> values;
+        std::atomic<size_t> end;
+
+        // Prefix sums of the measure over values, protected by mutex.
+        std::vector<Total> totals;
+        std::mutex mutex;
+    };
+
+    typedef std::shared_ptr<buffer> buffer_ptr;
+
+    void assign(std::initializer_list<Element> values);
+    void detach(size_t capacity);
+    void writable();
+
+    buffer_ptr buffer_;
+    size_t first_;
+    size_t last_;
+};
+
+} // namespace libbitcoin
+
+#include <bitcoin/bitcoin/impl/utility/ring_window.ipp>
+
+#endif
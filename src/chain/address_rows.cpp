@@ -0,0 +1,342 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/address_rows.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/chain/input.hpp>
+#include <bitcoin/bitcoin/chain/output.hpp>
+#include <bitcoin/bitcoin/machine/opcode.hpp>
+#include <bitcoin/bitcoin/machine/operation.hpp>
+#include <bitcoin/bitcoin/math/elliptic_curve.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+#include <bitcoin/bitcoin/utility/thread.hpp>
+#include <bitcoin/bitcoin/utility/threadpool.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+using namespace bc::machine;
+
+// Script bytes.
+//-----------------------------------------------------------------------------
+
+// An operation of the script, with its pushed data if any.
+struct script_operation
+{
+    opcode code;
+    const uint8_t* data;
+    size_t size;
+};
+
+// Read the next operation of the script, false if truncated.
+static bool read_operation(const uint8_t*& it, const uint8_t* end,
+    script_operation& out)
+{
+    out.code = static_cast<opcode>(*it++);
+    auto remaining = static_cast<size_t>(end - it);
+
+    switch (out.code)
+    {
+        case opcode::push_one_size:
+            if (remaining < 1u)
+                return false;
+
+            out.size = *it;
+            it += 1;
+            break;
+        case opcode::push_two_size:
+            if (remaining < 2u)
+                return false;
+
+            out.size = from_little_endian_unsafe<uint16_t>(it);
+            it += 2;
+            break;
+        case opcode::push_four_size:
+            if (remaining < 4u)
+                return false;
+
+            out.size = from_little_endian_unsafe<uint32_t>(it);
+            it += 4;
+            break;
+        default:
+            out.size = out.code <= opcode::push_size_75 ?
+                static_cast<size_t>(out.code) : 0u;
+            break;
+    }
+
+    remaining = static_cast<size_t>(end - it);
+
+    if (out.size > remaining)
+        return false;
+
+    out.data = it;
+    it += out.size;
+    return true;
+}
+
+static data_slice to_slice(const script_operation& op)
+{
+    return { op.data, op.data + op.size };
+}
+
+// The patterns of script::output_pattern that yield an address.
+static bool extract_output(const data_chunk& script, short_hash& out,
+    address_rows::kind& out_kind)
+{
+    static const size_t max_operations = 5;
+    script_operation ops[max_operations];
+    const auto end = script.data() + script.size();
+    size_t count = 0;
+
+    for (auto it = script.data(); it != end; ++count)
+        if (count == max_operations || !read_operation(it, end, ops[count]))
+            return false;
+
+    if (count == 5
+        && ops[0].code == opcode::dup
+        && ops[1].code == opcode::hash160
+        && ops[2].size == short_hash_size
+        && ops[3].code == opcode::equalverify
+        && ops[4].code == opcode::checksig)
+    {
+        std::copy_n(ops[2].data, short_hash_size, out.begin());
+        out_kind = address_rows::kind::output_key_hash;
+        return true;
+    }
+
+    if (count == 3
+        && ops[0].code == opcode::hash160
+        && ops[1].code == opcode::push_size_20
+        && ops[2].code == opcode::equal)
+    {
+        std::copy_n(ops[1].data, short_hash_size, out.begin());
+        out_kind = address_rows::kind::output_script_hash;
+        return true;
+    }
+
+    // pay_public_key is not p2kh but is conflated for tracking.
+    if (count == 2
+        && is_public_key(to_slice(ops[0]))
+        && ops[1].code == opcode::checksig)
+    {
+        out = bitcoin_short_hash(to_slice(ops[0]));
+        out_kind = address_rows::kind::output_key_hash;
+        return true;
+    }
+
+    return false;
+}
+
+// The patterns of script::input_pattern that yield an address, returns true
+// with out_key_hash set if sign_key_hash, in which case the hash is of both.
+static bool extract_input(const data_chunk& script, short_hash& out,
+    bool& out_key_hash)
+{
+    const auto end = script.data() + script.size();
+    script_operation first{ opcode::push_size_0, nullptr, 0 };
+    script_operation last{ opcode::push_size_0, nullptr, 0 };
+    size_t count = 0;
+
+    for (auto it = script.data(); it != end; ++count)
+    {
+        if (!read_operation(it, end, last) || !operation::is_push(last.code))
+            return false;
+
+        if (count == 0)
+            first = last;
+    }
+
+    if (count == 0 || last.size == 0)
+        return false;
+
+    out = bitcoin_short_hash(to_slice(last));
+    out_key_hash = count == 2
+        && first.size >= min_endorsement_size
+        && first.size <= max_endorsement_size
+        && is_public_key(to_slice(last));
+    return true;
+}
+
+// Rows.
+//-----------------------------------------------------------------------------
+
+void address_rows::reserve(size_t rows)
+{
+    transactions_.reserve(rows);
+    indexes_.reserve(rows);
+    kinds_.reserve(rows);
+    hashes_.reserve(rows);
+    values_.reserve(rows);
+}
+
+void address_rows::clear()
+{
+    transactions_.clear();
+    indexes_.clear();
+    kinds_.clear();
+    hashes_.clear();
+    values_.clear();
+}
+
+size_t address_rows::size() const
+{
+    return transactions_.size();
+}
+
+void address_rows::push(uint32_t position, uint32_t index, kind type,
+    const short_hash& hash, uint64_t value)
+{
+    transactions_.push_back(position);
+    indexes_.push_back(index);
+    kinds_.push_back(type);
+    hashes_.push_back(hash);
+    values_.push_back(value);
+}
+
+void address_rows::append(const address_rows& other)
+{
+    extend_data(transactions_, other.transactions_);
+    extend_data(indexes_, other.indexes_);
+    extend_data(kinds_, other.kinds_);
+    extend_data(hashes_, other.hashes_);
+    extend_data(values_, other.values_);
+}
+
+// Extraction.
+//-----------------------------------------------------------------------------
+
+// Inputs precede outputs, as in the transaction.
+void address_rows::extract(const transaction& tx, uint32_t position)
+{
+    short_hash hash;
+
+    if (!tx.is_coinbase())
+    {
+        const auto& inputs = tx.inputs();
+
+        for (uint32_t index = 0; index < inputs.size(); ++index)
+        {
+            const auto& input = inputs[index];
+            auto key_hash = false;
+
+            if (!extract_input(input.script().bytes(), hash, key_hash))
+                continue;
+
+            const auto& prevout = input.previous_output().validation.cache;
+            const auto value = prevout.value();
+
+            if (key_hash)
+                push(position, index, kind::input_key_hash, hash, value);
+
+            push(position, index, kind::input_script_hash, hash, value);
+        }
+    }
+
+    const auto& outputs = tx.outputs();
+    auto type = kind::output_key_hash;
+
+    for (uint32_t index = 0; index < outputs.size(); ++index)
+    {
+        const auto& output = outputs[index];
+
+        if (extract_output(output.script().bytes(), hash, type))
+            push(position, index, type, hash, output.value());
+    }
+}
+
+// Each thread extracts a contiguous run of transactions, then the runs are
+// appended in order.
+void address_rows::extract(const block& block, size_t threads)
+{
+    clear();
+    const auto& txs = block.transactions();
+    const auto parts = std::min(thread_default(threads), txs.size());
+
+    if (parts <= 1u)
+    {
+        for (uint32_t position = 0; position < txs.size(); ++position)
+            extract(txs[position], position);
+
+        return;
+    }
+
+    const auto span = (txs.size() + parts - 1u) / parts;
+    std::vector<address_rows> runs(parts);
+    threadpool pool(parts);
+
+    for (size_t part = 0; part < parts; ++part)
+    {
+        pool.service().post([&txs, &runs, span, part]()
+        {
+            const auto first = part * span;
+            const auto last = std::min(first + span, txs.size());
+
+            for (auto position = first; position < last; ++position)
+                runs[part].extract(txs[position],
+                    static_cast<uint32_t>(position));
+        });
+    }
+
+    pool.shutdown();
+    pool.join();
+
+    size_t rows = 0;
+    for (const auto& run: runs)
+        rows += run.size();
+
+    reserve(rows);
+
+    for (const auto& run: runs)
+        append(run);
+}
+
+// Columns.
+//-----------------------------------------------------------------------------
+
+const address_rows::position_column& address_rows::transactions() const
+{
+    return transactions_;
+}
+
+const address_rows::position_column& address_rows::indexes() const
+{
+    return indexes_;
+}
+
+const address_rows::kind_column& address_rows::kinds() const
+{
+    return kinds_;
+}
+
+const address_rows::hash_column& address_rows::hashes() const
+{
+    return hashes_;
+}
+
+const address_rows::value_column& address_rows::values() const
+{
+    return values_;
+}
+
+} // namespace chain
+} // namespace libbitcoin
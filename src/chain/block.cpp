@@ -173,16 +173,27 @@ block::block()
 {
 }
 
+// The immutable wire serialization is shared with the copy.
 block::block(const block& other)
   : block(other.header_, other.transactions_)
 {
     validation = other.validation;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    other.mutex_.lock_shared();
+    data_ = other.data_;
+    witness_data_ = other.witness_data_;
+    other.mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 block::block(block&& other)
   : block(std::move(other.header_), std::move(other.transactions_))
 {
     validation = std::move(other.validation);
+    data_ = std::move(other.data_);
+    witness_data_ = std::move(other.witness_data_);
 }
 
 // TODO: deal with possibility of inconsistent merkle root in relation to txs.
@@ -207,6 +218,14 @@ block& block::operator=(block&& other)
     header_ = std::move(other.header_);
     transactions_ = std::move(other.transactions_);
     validation = std::move(other.validation);
+
+    // The caches of the previous value no longer apply.
+    segregated_ = boost::none;
+    total_inputs_ = boost::none;
+    base_size_ = boost::none;
+    total_size_ = boost::none;
+    merkle_tree_.reset();
+    invalidate_data();
     return *this;
 }
 
@@ -262,7 +281,26 @@ bool block::from_data(const data_chunk& data, bool witness)
     witness = false;
 #endif
     data_source istream(data);
-    return from_data(istream, witness);
+
+    if (!from_data(istream, witness))
+        return false;
+
+    witness &= is_segregated();
+
+    // The data is captured unless it has trailing bytes or stripped witness.
+    if (data.size() == serialized_size(witness))
+    {
+        const auto captured = std::make_shared<const data_chunk>(data);
+
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        mutex_.lock();
+        (witness ? witness_data_ : data_) = captured;
+        mutex_.unlock();
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    return true;
 }
 
 bool block::from_data(std::istream& stream, bool witness)
@@ -310,12 +348,88 @@ bool block::from_data(reader& source, bool witness)
     return source;
 }
 
+bool block::from_data(const data_chunk& data, transaction::parse fields,
+    transaction::offsets::list& out)
+{
+    data_source istream(data);
+    istream_reader source(istream);
+
+    if (!from_data(source, fields, out))
+        return false;
+
+    // Assignment does not retain the hash, so the list is rebuilt.
+    transaction::list hashed;
+    hashed.reserve(transactions_.size());
+
+    for (size_t index = 0; index < transactions_.size(); ++index)
+        hashed.emplace_back(std::move(transactions_[index]),
+            transaction::to_hash(data, out[index]));
+
+    transactions_ = std::move(hashed);
+    return true;
+}
+
+bool block::from_data(reader& source, transaction::parse fields,
+    transaction::offsets::list& out)
+{
+    reset();
+    out.clear();
+
+    if (!header_.from_data(source, true))
+        return false;
+
+    auto offset = chain::header::satoshi_fixed_size() +
+        message::variable_prefix_size(source.peek_byte());
+    const auto count = source.read_size_little_endian();
+
+    // Guard against potential for arbitary memory allocation.
+    if (count > get_max_block_size())
+    {
+        source.invalidate();
+    }
+    else
+    {
+        transactions_.resize(count);
+        out.resize(count);
+    }
+
+    // Transaction offsets are relative to the transaction.
+    for (size_t index = 0; index < transactions_.size(); ++index)
+    {
+        auto& offsets = out[index];
+
+        if (!transactions_[index].from_data(source, fields, offsets))
+            break;
+
+        offsets.transaction = offset;
+        offsets.inputs += offset;
+        offsets.outputs += offset;
+        offsets.witnesses += offset;
+        offsets.locktime += offset;
+        offset = offsets.locktime + sizeof(uint32_t);
+    }
+
+    if (!source)
+    {
+        reset();
+        out.clear();
+    }
+
+    return source;
+}
+
 // private
 void block::reset()
 {
     header_.reset();
     transactions_.clear();
     transactions_.shrink_to_fit();
+    segregated_ = boost::none;
+    total_inputs_ = boost::none;
+    base_size_ = boost::none;
+    total_size_ = boost::none;
+    merkle_tree_.reset();
+    invalidate_data();
 }
 
 bool block::is_valid() const
@@ -335,7 +449,7 @@ data_chunk block::to_data(bool witness) const
     const auto size = serialized_size(witness);
     data.reserve(size);
     data_sink ostream(data);
-    to_data(ostream);
+    to_data(ostream, witness);
     ostream.flush();
     BITCOIN_ASSERT(data.size() == size);
     return data;
@@ -350,12 +464,31 @@ void block::to_data(std::ostream& stream, bool witness) const
     to_data(sink, witness);
 }
 
-// Full block serialization is always canonical encoding.
+// The cached wire serialization is written if present.
 void block::to_data(writer& sink, bool witness) const
 {
 #ifdef BITPRIM_CURRENCY_BCH
     witness = false;
 #endif
+    witness &= is_segregated();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_shared();
+    const auto cached = witness ? witness_data_ : data_;
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (cached)
+        sink.write_bytes(*cached);
+    else
+        write_data(sink, witness);
+}
+
+// private
+// Full block serialization is always canonical encoding.
+void block::write_data(writer& sink, bool witness) const
+{
     header_.to_data(sink, true);
     sink.write_size_little_endian(transactions_.size());
     const auto to = [&sink, witness](const transaction& tx)
@@ -366,6 +499,51 @@ void block::to_data(writer& sink, bool witness) const
     std::for_each(transactions_.begin(), transactions_.end(), to);
 }
 
+block::data_const_ptr block::wire_data(bool witness) const
+{
+#ifdef BITPRIM_CURRENCY_BCH
+    witness = false;
+#endif
+    witness &= is_segregated();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_upgrade();
+    auto& data = witness ? witness_data_ : data_;
+
+    if (!data)
+    {
+        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        mutex_.unlock_upgrade_and_lock();
+        const auto built = std::make_shared<data_chunk>();
+        data_sink ostream(*built);
+        ostream_writer sink(ostream);
+        write_data(sink, witness);
+        ostream.flush();
+        data = built;
+        mutex_.unlock_and_lock_upgrade();
+        //---------------------------------------------------------------------
+    }
+
+    const auto out = data;
+    mutex_.unlock_upgrade();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return out;
+}
+
+// private
+void block::invalidate_data() const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+    data_.reset();
+    witness_data_.reset();
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
 hash_list block::to_hashes(bool witness) const
 {
 #ifdef BITPRIM_CURRENCY_BCH
@@ -438,8 +616,10 @@ size_t block::serialized_size(bool witness) const
     return value;
 }
 
+// The wire serialization may be shared, so mutable access detaches it.
 chain::header& block::header()
 {
+    invalidate_data();
     return header_;
 }
 
@@ -454,16 +634,25 @@ const chain::header& block::header() const
 void block::set_header(const chain::header& value)
 {
     header_ = value;
+    invalidate_data();
 }
 
 // TODO: see set_header comments.
 void block::set_header(chain::header&& value)
 {
     header_ = std::move(value);
+    invalidate_data();
 }
 
+// As with set_transactions, the memoized values no longer apply.
 transaction::list& block::transactions()
 {
+    segregated_ = boost::none;
+    total_inputs_ = boost::none;
+    base_size_ = boost::none;
+    total_size_ = boost::none;
+    merkle_tree_.reset();
+    invalidate_data();
     return transactions_;
 }
 
@@ -480,6 +669,8 @@ void block::set_transactions(const transaction::list& value)
     total_inputs_ = boost::none;
     base_size_ = boost::none;
     total_size_ = boost::none;
+    merkle_tree_.reset();
+    invalidate_data();
 }
 
 // TODO: see set_header comments.
@@ -490,6 +681,8 @@ void block::set_transactions(transaction::list&& value)
     total_inputs_ = boost::none;
     base_size_ = boost::none;
     total_size_ = boost::none;
+    merkle_tree_.reset();
+    invalidate_data();
 }
 
 // Convenience property.
@@ -761,6 +954,38 @@ hash_digest block::generate_merkle_root(bool witness) const
     return merkle.front();
 }
 
+merkle_tree::const_ptr block::to_merkle_tree() const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_upgrade();
+
+    if (merkle_tree_)
+    {
+        const auto tree = merkle_tree_;
+        mutex_.unlock_upgrade();
+        //---------------------------------------------------------------------
+        return tree;
+    }
+
+    mutex_.unlock_upgrade_and_lock();
+    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    if (!merkle_tree_)
+        merkle_tree_ = std::make_shared<const merkle_tree>(to_hashes());
+
+    const auto tree = merkle_tree_;
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return tree;
+}
+
+hash_list block::merkle_branch(size_t position) const
+{
+    return to_merkle_tree()->branch(position);
+}
+
 size_t block::non_coinbase_input_count() const
 {
     if (transactions_.empty())
@@ -800,11 +1025,159 @@ bool block::is_forward_reference() const
     return false;
 }
 
+// The positions of the in-block transactions spent by each transaction.
+// Hashes are collected first since canonical order permits spends of later
+// transactions. Duplicate hashes resolve to the first occurrence.
+block::index_sets block::dependency_parents() const
+{
+    const auto count = transactions_.size();
+    std::unordered_map<hash_digest, size_t> positions(count);
+
+    for (size_t position = 0; position < count; ++position)
+        positions.emplace(transactions_[position].hash(), position);
+
+    index_sets parents(count);
+
+    for (size_t position = 0; position < count; ++position)
+    {
+        const auto& tx = transactions_[position];
+
+        if (tx.is_coinbase())
+            continue;
+
+        auto& spent = parents[position];
+
+        for (const auto& input: tx.inputs())
+        {
+            const auto it = positions.find(input.previous_output().hash());
+
+            if (it != positions.end() && it->second != position)
+                spent.push_back(it->second);
+        }
+
+        std::sort(spent.begin(), spent.end());
+        spent.erase(std::unique(spent.begin(), spent.end()), spent.end());
+    }
+
+    return parents;
+}
+
+// Depths are memoized over an explicit stack, so this is linear in spends.
+// A cycle cannot be committed to by transaction hashes, but an edge back to
+// a transaction still on the stack is ignored so that the walk terminates.
+block::index_sets block::dependency_levels() const
+{
+    static const auto unvisited = max_size_t;
+    static const auto visiting = max_size_t - 1u;
+
+    const auto parents = dependency_parents();
+    const auto count = parents.size();
+    indexes depths(count, unvisited);
+    indexes cursors(count, 0);
+    indexes stack;
+    size_t top = 0;
+
+    for (size_t position = 0; position < count; ++position)
+    {
+        if (depths[position] != unvisited)
+            continue;
+
+        stack.push_back(position);
+        depths[position] = visiting;
+
+        // The stack is the current path, so only it is marked as visiting.
+        while (!stack.empty())
+        {
+            const auto current = stack.back();
+            const auto& spent = parents[current];
+            auto& cursor = cursors[current];
+
+            while (cursor < spent.size() && depths[spent[cursor]] != unvisited)
+                ++cursor;
+
+            if (cursor < spent.size())
+            {
+                depths[spent[cursor]] = visiting;
+                stack.push_back(spent[cursor]);
+                continue;
+            }
+
+            size_t depth = 0;
+
+            for (const auto parent: spent)
+                if (depths[parent] != visiting)
+                    depth = std::max(depth, depths[parent] + 1u);
+
+            depths[current] = depth;
+            top = std::max(top, depth);
+            stack.pop_back();
+        }
+    }
+
+    index_sets levels(count == 0 ? 0 : top + 1u);
+
+    for (size_t position = 0; position < count; ++position)
+        levels[depths[position]].push_back(position);
+
+    return levels;
+}
+
+// Union-find over spends, sets are ordered by their lowest position.
+block::index_sets block::dependency_components() const
+{
+    const auto parents = dependency_parents();
+    const auto count = parents.size();
+    indexes roots(count);
+    std::iota(roots.begin(), roots.end(), size_t(0));
+
+    const auto find = [&roots](size_t position)
+    {
+        while (roots[position] != position)
+            position = roots[position] = roots[roots[position]];
+
+        return position;
+    };
+
+    for (size_t position = 0; position < count; ++position)
+    {
+        for (const auto parent: parents[position])
+        {
+            const auto left = find(position);
+            const auto right = find(parent);
+
+            if (left != right)
+                roots[std::max(left, right)] = std::min(left, right);
+        }
+    }
+
+    index_sets components;
+    indexes component_of(count);
+
+    for (size_t position = 0; position < count; ++position)
+    {
+        const auto root = find(position);
+
+        if (root == position)
+        {
+            component_of[position] = components.size();
+            components.emplace_back();
+        }
+
+        components[component_of[root]].push_back(position);
+    }
+
+    return components;
+}
+
 bool block::is_canonical_ordered() const {
     //precondition: transactions_.size() > 1
     
+    // The hashes are returned by value, so each must be bound before taking
+    // its iterators.
     auto const hash_cmp = [](transaction const& a, transaction const& b){
-        return std::lexicographical_compare(a.hash().rbegin(), a.hash().rend(), b.hash().rbegin(), b.hash().rend());
+        auto const a_hash = a.hash();
+        auto const b_hash = b.hash();
+        return std::lexicographical_compare(a_hash.rbegin(), a_hash.rend(), b_hash.rbegin(), b_hash.rend());
     };
 
     // Skip the coinbase
@@ -1127,6 +1500,10 @@ code block::connect(const chain_state& state) const
     if (state.is_under_checkpoint())
         return error::success;
 
+    // Only script verification is skipped, accept checks remain in force.
+    else if (state.is_under_assume_valid())
+        return error::success;
+
     else
         return connect_transactions(state);
 }
@@ -0,0 +1,519 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/block_assembler.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/chain/input.hpp>
+#include <bitcoin/bitcoin/chain/output.hpp>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/math/limits.hpp>
+#include <bitcoin/bitcoin/message/messages.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+#include <bitcoin/bitcoin/utility/pseudo_random.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+// Selection gives up after this many consecutive packages do not fit once
+// the block is within the margin of its size limit.
+static BC_CONSTEXPR size_t max_consecutive_failures = 1000;
+static BC_CONSTEXPR size_t near_full_margin = 4000;
+
+static BC_CONSTEXPR size_t unindexed = max_size_t;
+
+// Open addressed index of candidate positions by hash, with linear probing.
+// Buckets are the high bits of a word of the hash times a random odd salt,
+// so that candidates cannot be mined into a common bucket.
+class candidate_index
+{
+public:
+    candidate_index(const std::vector<hash_digest>& hashes)
+      : hashes_(hashes),
+        bits_(table_bits(hashes.size())),
+        mask_((size_t(1) << bits_) - 1u),
+        salt_(pseudo_random::next() | 1u),
+        table_(mask_ + 1u, unindexed)
+    {
+    }
+
+    // False if the hash is already indexed.
+    bool insert(size_t position)
+    {
+        for (auto slot = bucket(hashes_[position]);; slot = (slot + 1) & mask_)
+        {
+            if (table_[slot] == unindexed)
+            {
+                table_[slot] = position;
+                return true;
+            }
+
+            if (hashes_[table_[slot]] == hashes_[position])
+                return false;
+        }
+    }
+
+    // The position of the hash or unindexed.
+    size_t find(const hash_digest& hash) const
+    {
+        for (auto slot = bucket(hash);; slot = (slot + 1) & mask_)
+        {
+            const auto position = table_[slot];
+
+            if (position == unindexed || hashes_[position] == hash)
+                return position;
+        }
+    }
+
+private:
+    // At most half full.
+    static size_t table_bits(size_t count)
+    {
+        size_t bits = 1;
+        while ((size_t(1) << bits) < 2 * count)
+            ++bits;
+
+        return bits;
+    }
+
+    size_t bucket(const hash_digest& hash) const
+    {
+        const auto word = from_little_endian_unsafe<uint64_t>(hash.begin());
+        return static_cast<size_t>((word * salt_) >> (64 - bits_));
+    }
+
+    const std::vector<hash_digest>& hashes_;
+    const size_t bits_;
+    const size_t mask_;
+    const uint64_t salt_;
+    std::vector<size_t> table_;
+};
+
+// The totals of a candidate and its unselected ancestors. The version counts
+// reductions and so invalidates entries made before the last of them.
+struct package_totals
+{
+    uint64_t fees;
+    size_t size;
+    size_t sigops;
+    size_t version;
+};
+
+struct package_entry
+{
+    double rate;
+    size_t position;
+    size_t version;
+};
+
+// Highest fee rate first, ties to the lower position.
+static bool lower_priority(const package_entry& left,
+    const package_entry& right)
+{
+    return left.rate < right.rate ||
+        (left.rate == right.rate && left.position > right.position);
+}
+
+static bool higher_priority(const package_entry& left,
+    const package_entry& right)
+{
+    return lower_priority(right, left);
+}
+
+static package_entry make_entry(const package_totals& totals,
+    size_t position)
+{
+    const auto rate = totals.size == 0 ? 0.0 :
+        static_cast<double>(totals.fees) / totals.size;
+    return { rate, position, totals.version };
+}
+
+// Collect the positions reachable over the edges from the position, not
+// including itself. Marks are compared to the mark of this walk so that they
+// need not be cleared. If selected is provided the walk stops at selected
+// positions, which is valid for ancestors since those of a selected
+// candidate are also selected.
+static void collect(const block::index_sets& edges, size_t position,
+    const std::vector<bool>* selected, block::indexes& marks, size_t mark,
+    block::indexes& stack, block::indexes& out)
+{
+    marks[position] = mark;
+    stack.assign(1, position);
+
+    while (!stack.empty())
+    {
+        const auto next = stack.back();
+        stack.pop_back();
+
+        for (const auto edge: edges[next])
+        {
+            if (marks[edge] == mark || (selected && (*selected)[edge]))
+                continue;
+
+            marks[edge] = mark;
+            out.push_back(edge);
+            stack.push_back(edge);
+        }
+    }
+}
+
+static size_t default_max_size(const chain_state& state)
+{
+#ifdef BITPRIM_CURRENCY_BCH
+    return state.is_monolith_enabled() ? get_max_block_size() :
+        max_block_size_old;
+#else
+    return get_max_block_size();
+#endif
+}
+
+static bool is_canonical(const chain_state& state)
+{
+#ifdef BITPRIM_CURRENCY_BCH
+    return state.is_magnetic_anomaly_enabled();
+#else
+    return false;
+#endif
+}
+
+block_assembler::block_assembler(const chain_state& state, size_t max_size,
+    size_t max_sigops)
+  : height_(state.height()),
+    version_(chain_state::signal_version(state.enabled_forks())),
+    bits_(state.work_required()),
+    median_time_past_(state.median_time_past()),
+    canonical_(is_canonical(state)),
+    max_size_(max_size == 0 ? default_max_size(state) : max_size),
+    max_sigops_(max_sigops)
+{
+}
+
+// Bitcoin Cash allows sigops in proportion to the serialized block size, as
+// in block::accept, so the limit is taken at the size of the block so far.
+size_t block_assembler::sigop_limit(size_t block_size) const
+{
+    if (max_sigops_ != 0)
+        return max_sigops_;
+
+#ifdef BITPRIM_CURRENCY_BCH
+    return get_allowed_sigops(block_size);
+#else
+    return get_max_block_sigops();
+#endif
+}
+
+// Hashes, sizes and sigops are read once per candidate and package totals
+// are kept current by subtracting selected ancestors from their descendants.
+// Candidates are visited in one sorted pass, and only those with reduced
+// totals pass through a heap, so in the common case of few in-pool
+// dependencies selection is dominated by a sort.
+block::indexes block_assembler::select(const transaction::list& candidates,
+    size_t reserved_size, size_t reserved_sigops) const
+{
+    const auto count = candidates.size();
+    std::vector<hash_digest> hashes;
+    hashes.reserve(count);
+    std::vector<bool> eligible(count, false);
+
+    for (const auto& tx: candidates)
+        hashes.push_back(tx.hash());
+
+    candidate_index index(hashes);
+
+    for (size_t position = 0; position < count; ++position)
+        eligible[position] = !candidates[position].is_coinbase() &&
+            index.insert(position);
+
+    block::index_sets parents(count);
+    block::index_sets children(count);
+    std::vector<package_totals> packages(count, { 0, 0, 0, 0 });
+
+    for (size_t position = 0; position < count; ++position)
+    {
+        if (!eligible[position])
+            continue;
+
+        const auto& tx = candidates[position];
+        auto& spent = parents[position];
+        packages[position] = { tx.cached_fees(), tx.serialized_size(),
+            tx.cached_sigops(), 0 };
+
+        for (const auto& input: tx.inputs())
+        {
+            const auto parent = index.find(input.previous_output().hash());
+
+            if (parent != unindexed && parent != position)
+                spent.push_back(parent);
+        }
+
+        if (spent.size() > 1u)
+        {
+            std::sort(spent.begin(), spent.end());
+            spent.erase(std::unique(spent.begin(), spent.end()), spent.end());
+        }
+
+        for (const auto parent: spent)
+            children[parent].push_back(position);
+    }
+
+    // Own totals are retained for reduction of descendant totals.
+    const auto own = packages;
+    block::indexes ancestor_counts(count, 0);
+    block::indexes marks(count, max_size_t);
+    block::indexes stack;
+    block::indexes relatives;
+    std::vector<package_entry> order;
+    order.reserve(count);
+    size_t mark = 0;
+
+    for (size_t position = 0; position < count; ++position)
+    {
+        if (!eligible[position])
+            continue;
+
+        if (!parents[position].empty())
+        {
+            relatives.clear();
+            collect(parents, position, nullptr, marks, mark++, stack,
+                relatives);
+            ancestor_counts[position] = relatives.size();
+
+            auto& totals = packages[position];
+
+            for (const auto ancestor: relatives)
+            {
+                totals.fees = ceiling_add(totals.fees, own[ancestor].fees);
+                totals.size = ceiling_add(totals.size, own[ancestor].size);
+                totals.sigops = ceiling_add(totals.sigops,
+                    own[ancestor].sigops);
+            }
+        }
+
+        order.push_back(make_entry(packages[position], position));
+    }
+
+    std::sort(order.begin(), order.end(), higher_priority);
+
+    const auto ancestors_first = [&](size_t left, size_t right)
+    {
+        return ancestor_counts[left] < ancestor_counts[right] ||
+            (ancestor_counts[left] == ancestor_counts[right] && left < right);
+    };
+
+    std::vector<bool> selected(count, false);
+    const auto is_current = [&](const package_entry& entry)
+    {
+        return !selected[entry.position] &&
+            entry.version == packages[entry.position].version;
+    };
+
+    std::vector<package_entry> reduced;
+    block::indexes touched(count, max_size_t);
+    block::indexes descendants;
+    block::indexes updated;
+    block::indexes out;
+    out.reserve(count);
+    auto next = order.begin();
+    auto block_size = reserved_size;
+    auto block_sigops = reserved_sigops;
+    size_t failures = 0;
+    size_t selection = 0;
+
+    while (true)
+    {
+        while (next != order.end() && !is_current(*next))
+            ++next;
+
+        while (!reduced.empty() && !is_current(reduced.front()))
+        {
+            std::pop_heap(reduced.begin(), reduced.end(), lower_priority);
+            reduced.pop_back();
+        }
+
+        const auto sorted = next != order.end();
+
+        if (!sorted && reduced.empty())
+            break;
+
+        // Take the better of the next sorted and the best reduced entry.
+        package_entry entry;
+
+        if (sorted && (reduced.empty() ||
+            !lower_priority(*next, reduced.front())))
+        {
+            entry = *next++;
+        }
+        else
+        {
+            entry = reduced.front();
+            std::pop_heap(reduced.begin(), reduced.end(), lower_priority);
+            reduced.pop_back();
+        }
+
+        const auto position = entry.position;
+        const auto& totals = packages[position];
+        const auto size = ceiling_add(block_size, totals.size);
+        const auto sigops = ceiling_add(block_sigops, totals.sigops);
+
+        if (size > max_size_ || sigops > sigop_limit(size))
+        {
+            if (++failures > max_consecutive_failures &&
+                block_size > max_size_ - std::min(max_size_, near_full_margin))
+                break;
+
+            continue;
+        }
+
+        failures = 0;
+        block_size = size;
+        block_sigops = sigops;
+
+        // The package is the candidate and its unselected ancestors.
+        relatives.clear();
+
+        if (!parents[position].empty())
+        {
+            collect(parents, position, &selected, marks, mark++, stack,
+                relatives);
+            std::sort(relatives.begin(), relatives.end(), ancestors_first);
+        }
+
+        relatives.push_back(position);
+
+        for (const auto member: relatives)
+        {
+            selected[member] = true;
+            out.push_back(member);
+        }
+
+        // Remove each member from the totals of its descendants. The walk
+        // passes through selected members to reach their descendants.
+        updated.clear();
+        ++selection;
+
+        for (const auto member: relatives)
+        {
+            if (children[member].empty())
+                continue;
+
+            descendants.clear();
+            collect(children, member, nullptr, marks, mark++, stack,
+                descendants);
+
+            for (const auto descendant: descendants)
+            {
+                if (selected[descendant])
+                    continue;
+
+                auto& totals = packages[descendant];
+                totals.fees -= std::min(totals.fees, own[member].fees);
+                totals.size -= std::min(totals.size, own[member].size);
+                totals.sigops -= std::min(totals.sigops, own[member].sigops);
+
+                if (touched[descendant] != selection)
+                {
+                    touched[descendant] = selection;
+                    updated.push_back(descendant);
+                }
+            }
+        }
+
+        for (const auto descendant: updated)
+        {
+            auto& totals = packages[descendant];
+            ++totals.version;
+            reduced.push_back(make_entry(totals, descendant));
+            std::push_heap(reduced.begin(), reduced.end(), lower_priority);
+        }
+    }
+
+    return out;
+}
+
+block block_assembler::assemble(const hash_digest& previous,
+    const transaction& coinbase, const transaction::list& candidates,
+    uint32_t timestamp) const
+{
+    // The header, the largest transaction count prefix and the coinbase.
+    const auto reserved_size = header::satoshi_fixed_size() +
+        message::variable_uint_size(max_uint32) + coinbase.serialized_size();
+    const auto reserved_sigops = coinbase.signature_operations(false, false);
+    const auto positions = select(candidates, reserved_size, reserved_sigops);
+
+    // Pair positions with hashes, so that hashes are computed once and the
+    // canonical sort moves no transactions.
+    std::vector<std::pair<hash_digest, size_t>> ordered;
+    ordered.reserve(positions.size());
+    uint64_t fees = 0;
+
+    for (const auto position: positions)
+    {
+        const auto& tx = candidates[position];
+        fees = ceiling_add(fees, tx.cached_fees());
+        ordered.emplace_back(tx.hash(), position);
+    }
+
+    if (canonical_)
+    {
+        const auto hash_less = [](const std::pair<hash_digest, size_t>& left,
+            const std::pair<hash_digest, size_t>& right)
+        {
+            return std::lexicographical_compare(left.first.rbegin(),
+                left.first.rend(), right.first.rbegin(), right.first.rend());
+        };
+
+        std::sort(ordered.begin(), ordered.end(), hash_less);
+    }
+
+    transaction::list transactions;
+    transactions.reserve(ordered.size() + 1u);
+    transactions.push_back(coinbase);
+
+    for (const auto& item: ordered)
+        transactions.emplace_back(candidates[item.second], item.first);
+
+    auto outputs = coinbase.outputs();
+
+    if (!outputs.empty())
+    {
+        uint64_t other = 0;
+        for (auto output = outputs.begin() + 1; output != outputs.end();
+            ++output)
+            other = ceiling_add(other, output->value());
+
+        const auto reward = ceiling_add(fees, block::subsidy(height_));
+        outputs.front().set_value(reward - std::min(reward, other));
+        transactions.front().set_outputs(std::move(outputs));
+    }
+
+    const auto time = std::max(timestamp,
+        ceiling_add(median_time_past_, uint32_t(1)));
+
+    block out(chain::header(version_, previous, null_hash, time, bits_, 0),
+        std::move(transactions));
+    out.header().set_merkle(out.generate_merkle_root());
+    return out;
+}
+
+} // namespace chain
+} // namespace libbitcoin
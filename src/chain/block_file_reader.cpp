@@ -0,0 +1,326 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/block_file_reader.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+
+#ifndef _WIN32
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+namespace libbitcoin {
+namespace chain {
+
+// Each record is prefixed by the network magic and the block size.
+static BC_CONSTEXPR size_t record_prefix_size = 2 * sizeof(uint32_t);
+static BC_CONSTEXPR size_t previous_hash_offset = sizeof(uint32_t);
+
+// Apply the readahead advice to the page-aligned range covering the slice.
+static void advise(const uint8_t* begin, size_t size, int advice)
+{
+#ifndef _WIN32
+    if (size == 0)
+        return;
+
+    static const auto page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto start = reinterpret_cast<uintptr_t>(begin);
+    const auto aligned = start - (start % page);
+
+    // Advice is a hint, so failure is of no consequence.
+    ::madvise(reinterpret_cast<void*>(aligned), size + (start - aligned),
+        advice);
+#endif
+}
+
+static int to_advice(block_file_reader::access hint)
+{
+#ifndef _WIN32
+    switch (hint)
+    {
+        case block_file_reader::access::sequential:
+            return MADV_SEQUENTIAL;
+        case block_file_reader::access::random:
+            return MADV_RANDOM;
+        case block_file_reader::access::normal:
+        default:
+            return MADV_NORMAL;
+    }
+#else
+    return 0;
+#endif
+}
+
+// mapping
+//-----------------------------------------------------------------------------
+
+class block_file_reader::mapping
+{
+public:
+    mapping(const path& file)
+      : file_(file.string())
+    {
+    }
+
+    data_slice data() const
+    {
+        const auto begin = reinterpret_cast<const uint8_t*>(file_.data());
+        return { begin, begin + file_.size() };
+    }
+
+private:
+    boost::iostreams::mapped_file_source file_;
+};
+
+// entry
+//-----------------------------------------------------------------------------
+
+hash_digest block_file_reader::entry::hash() const
+{
+    BITCOIN_ASSERT(data.size() >= header::satoshi_fixed_size());
+    const auto begin = data.begin();
+    return bitcoin_hash({ begin, begin + header::satoshi_fixed_size() });
+}
+
+hash_digest block_file_reader::entry::previous_block_hash() const
+{
+    BITCOIN_ASSERT(data.size() >= header::satoshi_fixed_size());
+    hash_digest out;
+    const auto begin = data.begin() + previous_hash_offset;
+    std::copy_n(begin, out.size(), out.begin());
+    return out;
+}
+
+bool block_file_reader::entry::to_block(block& out) const
+{
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    return out.from_data(source);
+}
+
+// block_file_reader
+//-----------------------------------------------------------------------------
+
+// static
+block_file_reader::path block_file_reader::file_path(const path& directory,
+    size_t number)
+{
+    std::ostringstream name;
+    name << "blk" << std::setw(5) << std::setfill('0') << number << ".dat";
+    return directory / name.str();
+}
+
+block_file_reader::block_file_reader(uint32_t magic)
+  : magic_(magic)
+{
+}
+
+block_file_reader::~block_file_reader()
+{
+    close();
+}
+
+bool block_file_reader::open(const path& file, access hint)
+{
+    boost::system::error_code ec;
+    const auto size = boost::filesystem::file_size(file, ec);
+
+    if (ec)
+        return false;
+
+    const auto index = mappings_.size();
+
+    // An empty file cannot be mapped but is validly empty.
+    if (size == 0)
+    {
+        mappings_.push_back(nullptr);
+        return true;
+    }
+
+    try
+    {
+        mappings_.push_back(std::make_shared<mapping>(file));
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+
+    const auto data = mappings_.back()->data();
+    advise(data.begin(), data.size(), to_advice(hint));
+    scan(index, data);
+    return true;
+}
+
+size_t block_file_reader::open_directory(const path& directory, access hint)
+{
+    size_t count = 0;
+
+    for (auto file = file_path(directory, count);
+        boost::filesystem::exists(file) && open(file, hint);
+        file = file_path(directory, ++count));
+
+    return count;
+}
+
+void block_file_reader::close()
+{
+    entries_.clear();
+    entries_.shrink_to_fit();
+    mappings_.clear();
+}
+
+size_t block_file_reader::files() const
+{
+    return mappings_.size();
+}
+
+const block_file_reader::entry::list& block_file_reader::entries() const
+{
+    return entries_;
+}
+
+void block_file_reader::prefetch(const entry& value) const
+{
+#ifndef _WIN32
+    advise(value.data.begin(), value.data.size(), MADV_WILLNEED);
+#endif
+}
+
+// Records may be separated by garbage (such as zero preallocation following
+// an unclean shutdown), so a failed magic match resumes searching for magic.
+void block_file_reader::scan(size_t file, const data_slice& data)
+{
+    const auto magic = to_little_endian(magic_);
+    const auto begin = data.begin();
+    const auto end = data.end();
+    auto it = begin;
+
+    while ((it = std::search(it, end, magic.begin(), magic.end())) != end)
+    {
+        const auto remaining = static_cast<size_t>(std::distance(it, end));
+
+        if (remaining < record_prefix_size)
+            break;
+
+        const auto size = from_little_endian_unsafe<uint32_t>(
+            it + sizeof(uint32_t));
+
+        // A size too small for a header cannot be a record, keep searching.
+        if (size < header::satoshi_fixed_size())
+        {
+            ++it;
+            continue;
+        }
+
+        // A size beyond the end of the file is a partially written record.
+        if (size > remaining - record_prefix_size)
+            break;
+
+        const auto block = it + record_prefix_size;
+        const auto offset = static_cast<size_t>(std::distance(begin, block));
+        entries_.push_back({ file, offset, { block, block + size } });
+        it = block + size;
+    }
+}
+
+// Heights are memoized along each walk, so this is linear in entry count.
+block_file_reader::entry::list block_file_reader::chain_order(
+    const hash_digest& start) const
+{
+    static const auto unknown = max_size_t;
+    static const auto unlinked = max_size_t - 1u;
+
+    const auto count = entries_.size();
+    std::unordered_map<hash_digest, size_t> index(count);
+
+    // Duplicate records of the same block resolve to the first.
+    for (size_t position = 0; position < count; ++position)
+        index.emplace(entries_[position].hash(), position);
+
+    const auto root = index.find(start);
+    if (root == index.end())
+        return {};
+
+    std::vector<size_t> parents(count, unlinked);
+    std::vector<size_t> heights(count, unknown);
+    heights[root->second] = 0;
+
+    for (size_t position = 0; position < count; ++position)
+    {
+        const auto parent = index.find(entries_[position].previous_block_hash());
+
+        if (parent != index.end() && position != root->second)
+            parents[position] = parent->second;
+    }
+
+    size_t tip = root->second;
+    std::vector<size_t> walk;
+
+    for (size_t position = 0; position < count; ++position)
+    {
+        walk.clear();
+        auto current = position;
+
+        // Walk back to a block of known height or to an unlinked block.
+        while (current != unlinked && heights[current] == unknown)
+        {
+            walk.push_back(current);
+            current = parents[current];
+        }
+
+        auto height = current == unlinked ? unlinked : heights[current];
+
+        for (auto it = walk.rbegin(); it != walk.rend(); ++it)
+        {
+            height = height == unlinked ? unlinked : height + 1u;
+            heights[*it] = height;
+        }
+
+        // The first block seen at the greatest height wins a tie.
+        if (heights[position] != unlinked && heights[position] > heights[tip])
+            tip = position;
+    }
+
+    entry::list out(heights[tip] + 1u, entries_[tip]);
+
+    for (auto current = tip; current != unlinked; current = parents[current])
+        out[heights[current]] = entries_[current];
+
+    return out;
+}
+
+} // namespace chain
+} // namespace libbitcoin
@@ -0,0 +1,338 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/block_pipeline.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/utility/asio.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
+#include <bitcoin/bitcoin/utility/thread.hpp>
+#include <bitcoin/bitcoin/utility/threadpool.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+// Blocks in flight per parallel stage thread when capacity is defaulted.
+static BC_CONSTEXPR size_t default_depth = 4;
+
+// One block as it passes through the pipeline.
+struct pipeline_item
+{
+    size_t sequence;
+    data_chunk data;
+    uint64_t size;
+    block_pipeline::block_ptr block;
+    code ec;
+};
+
+typedef std::shared_ptr<pipeline_item> pipeline_item_ptr;
+
+// A closable blocking queue, push blocks while full and pop while empty.
+// Once closed pop drains remaining items, once stopped they are discarded.
+class pipeline_queue
+{
+public:
+    pipeline_queue(size_t capacity)
+      : capacity_(capacity), closed_(false)
+    {
+    }
+
+    bool push(pipeline_item_ptr item)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this]()
+        {
+            return closed_ || items_.size() < capacity_;
+        });
+
+        if (closed_)
+            return false;
+
+        items_.push_back(std::move(item));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    bool pop(pipeline_item_ptr& out)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this]()
+        {
+            return closed_ || !items_.empty();
+        });
+
+        if (items_.empty())
+            return false;
+
+        out = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    void stop()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        items_.clear();
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+private:
+    const size_t capacity_;
+    bool closed_;
+    std::deque<pipeline_item_ptr> items_;
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+};
+
+// Stages.
+//-----------------------------------------------------------------------------
+
+static void parse_block(pipeline_item& item)
+{
+    item.block = std::make_shared<block>();
+    auto source = make_safe_deserializer(item.data.begin(), item.data.end());
+
+    if (!item.block->from_data(source))
+        item.ec = error::bad_stream;
+
+    // The serialization is no longer required, release it.
+    data_chunk().swap(item.data);
+}
+
+// Populate the header and tx hash caches, which check then reuses.
+static void hash_block(pipeline_item& item)
+{
+    item.block->header().hash();
+
+    for (const auto& tx: item.block->transactions())
+        tx.hash();
+}
+
+static void check_block(pipeline_item& item)
+{
+    item.ec = item.block->check();
+}
+
+// block_pipeline::stage_metrics
+//-----------------------------------------------------------------------------
+
+double block_pipeline::stage_metrics::rate() const
+{
+    typedef std::chrono::duration<double> seconds;
+    const auto time = std::chrono::duration_cast<seconds>(busy).count();
+    return time > 0.0 ? items / time : 0.0;
+}
+
+// block_pipeline
+//-----------------------------------------------------------------------------
+
+block_pipeline::block_pipeline(size_t threads, size_t capacity)
+  : threads_(thread_default(threads)),
+    capacity_(capacity == 0 ? default_depth * threads_ : capacity),
+    elapsed_(asio::duration::zero())
+{
+}
+
+const block_pipeline::stage_statistics& block_pipeline::statistics() const
+{
+    return statistics_;
+}
+
+asio::duration block_pipeline::elapsed() const
+{
+    return elapsed_;
+}
+
+// Back-pressure is applied at the reader, which may not run more than
+// capacity blocks ahead of in-order delivery. So each queue is bounded by
+// capacity and the reorder buffer cannot grow beyond it either.
+code block_pipeline::run(read_handler reader, result_handler handler)
+{
+    typedef std::function<void(pipeline_item&)> processor;
+    const auto start = asio::steady_clock::now();
+    statistics_ = stage_statistics();
+
+    std::mutex mutex;
+    std::condition_variable window;
+    size_t in_flight = 0;
+    bool stopped = false;
+
+    // Each stage writes to its own queue, which the following stage reads.
+    std::array<std::unique_ptr<pipeline_queue>, stages> queues;
+    for (auto& queue: queues)
+        queue.reset(new pipeline_queue(capacity_));
+
+    const auto record = [&](stage index, asio::time_point begin,
+        uint64_t bytes)
+    {
+        const auto busy = asio::steady_clock::now() - begin;
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& metrics = statistics_[index];
+        ++metrics.items;
+        metrics.bytes += bytes;
+        metrics.busy += busy;
+    };
+
+    const auto stop_all = [&]()
+    {
+        for (auto& queue: queues)
+            queue->stop();
+    };
+
+    // The read stage is serial, the sequence number is its read order.
+    const auto read_stage = [&]()
+    {
+        for (size_t sequence = 0; ; ++sequence)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                window.wait(lock, [&]()
+                {
+                    return stopped || in_flight < capacity_;
+                });
+
+                if (stopped)
+                    break;
+
+                ++in_flight;
+            }
+
+            const auto begin = asio::steady_clock::now();
+            auto item = std::make_shared<pipeline_item>();
+            item->sequence = sequence;
+
+            if (!reader(item->data))
+                break;
+
+            item->size = item->data.size();
+            record(stage::read, begin, item->size);
+
+            if (!queues[stage::read]->push(item))
+                break;
+        }
+
+        queues[stage::read]->close();
+    };
+
+    // The last thread out of a parallel stage closes the following queue.
+    std::array<std::atomic<size_t>, stages> running;
+    for (auto& count: running)
+        count = threads_;
+
+    const auto parallel_stage = [&](stage index, processor process)
+    {
+        pipeline_item_ptr item;
+        auto& in = queues[index - 1];
+        auto& out = queues[index];
+
+        while (in->pop(item))
+        {
+            const auto begin = asio::steady_clock::now();
+
+            // Failed items pass through to be reported in order.
+            if (!item->ec)
+                process(*item);
+
+            record(index, begin, item->size);
+
+            if (!out->push(std::move(item)))
+                break;
+        }
+
+        if (--running[index] == 0)
+            out->close();
+    };
+
+    auto& results = queues[stage::check];
+    threadpool pool(1 + threads_ * (stages - 1));
+    pool.service().post(read_stage);
+
+    for (size_t thread = 0; thread < threads_; ++thread)
+    {
+        pool.service().post(std::bind(parallel_stage, stage::parse,
+            parse_block));
+        pool.service().post(std::bind(parallel_stage, stage::hash,
+            hash_block));
+        pool.service().post(std::bind(parallel_stage, stage::check,
+            check_block));
+    }
+
+    size_t next = 0;
+    pipeline_item_ptr item;
+    std::map<size_t, pipeline_item_ptr> pending;
+
+    // Deliver in read order, releasing a reader slot for each delivery.
+    while (!stopped && results->pop(item))
+    {
+        pending.emplace(item->sequence, std::move(item));
+
+        for (auto it = pending.begin();
+            !stopped && it != pending.end() && it->first == next;
+            it = pending.erase(it), ++next)
+        {
+            auto& current = *it->second;
+            const auto keep = handler(current.ec, current.sequence,
+                current.block);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            --in_flight;
+            stopped = !keep;
+            window.notify_one();
+        }
+    }
+
+    if (stopped)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            window.notify_all();
+        }
+
+        stop_all();
+    }
+
+    pool.shutdown();
+    pool.join();
+    elapsed_ = asio::steady_clock::now() - start;
+    return stopped ? error::service_stopped : error::success;
+}
+
+} // namespace chain
+} // namespace libbitcoin
@@ -0,0 +1,312 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/bloom_filter.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <bitcoin/bitcoin/chain/input.hpp>
+#include <bitcoin/bitcoin/chain/output.hpp>
+#include <bitcoin/bitcoin/chain/script.hpp>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+// The seed of each hash function is spaced by this multiplier (BIP37).
+static const uint32_t seed_multiplier = 0xfba4c795;
+
+// The wire serialization of an outpoint, without allocation.
+typedef byte_array<hash_size + sizeof(uint32_t)> outpoint_bytes;
+
+static outpoint_bytes to_outpoint_bytes(const hash_digest& hash,
+    uint32_t index)
+{
+    outpoint_bytes out;
+    std::copy(hash.begin(), hash.end(), out.begin());
+
+    for (size_t byte = 0; byte < sizeof(uint32_t); ++byte)
+        out[hash_size + byte] = static_cast<uint8_t>(index >> (8 * byte));
+
+    return out;
+}
+
+// Constructors.
+//-----------------------------------------------------------------------------
+
+bloom_filter::bloom_filter()
+  : hash_functions_(0), tweak_(0), flags_(update::none), empty_(true),
+    full_(false)
+{
+}
+
+bloom_filter::bloom_filter(const data_chunk& filter, uint32_t hash_functions,
+    uint32_t tweak, uint8_t flags)
+  : filter_(filter), hash_functions_(hash_functions), tweak_(tweak),
+    flags_(flags)
+{
+    initialize();
+}
+
+bloom_filter::bloom_filter(data_chunk&& filter, uint32_t hash_functions,
+    uint32_t tweak, uint8_t flags)
+  : filter_(std::move(filter)), hash_functions_(hash_functions),
+    tweak_(tweak), flags_(flags)
+{
+    initialize();
+}
+
+// Optimal size is -n*ln(p)/ln(2)^2 bits with (bits/n)*ln(2) hash functions.
+bloom_filter::bloom_filter(size_t elements, double false_positive_rate,
+    uint32_t tweak, uint8_t flags)
+  : tweak_(tweak), flags_(flags)
+{
+    const auto ln2 = std::log(2.0);
+    const auto count = static_cast<double>(std::max(elements, size_t(1)));
+    const auto bits = -1.0 / (ln2 * ln2) * count *
+        std::log(false_positive_rate);
+    const auto limit = static_cast<double>(max_filter_load * byte_bits);
+
+    filter_.resize(static_cast<size_t>(std::min(bits, limit)) / byte_bits);
+    const auto functions = filter_.size() * byte_bits / count * ln2;
+    hash_functions_ = static_cast<uint32_t>(std::min(functions,
+        static_cast<double>(max_filter_functions)));
+    initialize();
+}
+
+bloom_filter::bloom_filter(const message::filter_load& load)
+  : bloom_filter(load.filter(), load.hash_functions(), load.tweak(),
+        load.flags())
+{
+}
+
+// An empty or full filter short-circuits every test.
+void bloom_filter::initialize()
+{
+    const auto zero = [](uint8_t byte) { return byte == 0x00; };
+    const auto one = [](uint8_t byte) { return byte == 0xff; };
+
+    empty_ = std::all_of(filter_.begin(), filter_.end(), zero);
+    full_ = !filter_.empty() && std::all_of(filter_.begin(), filter_.end(),
+        one);
+
+    // An invalid function count is bounded, though is_valid reports it.
+    const auto functions = std::min(hash_functions_,
+        static_cast<uint32_t>(max_filter_functions));
+
+    seeds_.resize(functions);
+
+    for (uint32_t function = 0; function < functions; ++function)
+        seeds_[function] = function * seed_multiplier + tweak_;
+}
+
+// Properties.
+//-----------------------------------------------------------------------------
+
+bool bloom_filter::is_valid() const
+{
+    return filter_.size() <= max_filter_load &&
+        hash_functions_ <= max_filter_functions;
+}
+
+const data_chunk& bloom_filter::filter() const
+{
+    return filter_;
+}
+
+uint32_t bloom_filter::hash_functions() const
+{
+    return hash_functions_;
+}
+
+uint32_t bloom_filter::tweak() const
+{
+    return tweak_;
+}
+
+uint8_t bloom_filter::flags() const
+{
+    return flags_;
+}
+
+// Elements.
+//-----------------------------------------------------------------------------
+
+// All probes for the element are computed in one pass over its bytes.
+void bloom_filter::indexes(data_slice element, uint32_t* out) const
+{
+    const auto bits = static_cast<uint32_t>(filter_.size() * byte_bits);
+    murmur3(element, seeds_.data(), out, seeds_.size());
+
+    for (size_t function = 0; function < seeds_.size(); ++function)
+        out[function] %= bits;
+}
+
+bool bloom_filter::contains(data_slice element) const
+{
+    if (full_)
+        return true;
+
+    if (empty_)
+        return false;
+
+    std::array<uint32_t, max_filter_functions> probes;
+    indexes(element, probes.data());
+
+    for (size_t function = 0; function < seeds_.size(); ++function)
+    {
+        const auto bit = probes[function];
+
+        if ((filter_[bit / byte_bits] & (1u << (bit % byte_bits))) == 0)
+            return false;
+    }
+
+    return true;
+}
+
+bool bloom_filter::contains(const point& outpoint) const
+{
+    return contains(to_outpoint_bytes(outpoint.hash(), outpoint.index()));
+}
+
+void bloom_filter::insert(data_slice element)
+{
+    if (full_ || filter_.empty())
+        return;
+
+    std::array<uint32_t, max_filter_functions> probes;
+    indexes(element, probes.data());
+
+    for (size_t function = 0; function < seeds_.size(); ++function)
+    {
+        const auto bit = probes[function];
+        filter_[bit / byte_bits] |= (1u << (bit % byte_bits));
+    }
+
+    empty_ = false;
+}
+
+void bloom_filter::insert(const point& outpoint)
+{
+    insert(to_outpoint_bytes(outpoint.hash(), outpoint.index()));
+}
+
+// Matching.
+//-----------------------------------------------------------------------------
+
+// A matched output is added to the filter so that its spend also matches.
+bool bloom_filter::match_output(const output& output, const hash_digest& hash,
+    uint32_t index)
+{
+    const auto& ops = output.script().operations();
+
+    for (const auto& op: ops)
+    {
+        const auto& data = op.data();
+
+        if (data.empty() || !contains(data))
+            continue;
+
+        const auto mode = flags_ & update::mask;
+
+        if (mode == update::all || (mode == update::pay_public_key_only &&
+            (script::is_pay_public_key_pattern(ops) ||
+                script::is_pay_multisig_pattern(ops))))
+            insert(to_outpoint_bytes(hash, index));
+
+        return true;
+    }
+
+    return false;
+}
+
+bool bloom_filter::match_input(const input& input) const
+{
+    if (contains(input.previous_output()))
+        return true;
+
+    for (const auto& op: input.script().operations())
+    {
+        const auto& data = op.data();
+
+        if (!data.empty() && contains(data))
+            return true;
+    }
+
+    return false;
+}
+
+// Every output is tested, as each match may update the filter.
+bool bloom_filter::match(const transaction& tx)
+{
+    if (full_)
+        return true;
+
+    if (empty_)
+        return false;
+
+    const auto hash = tx.hash();
+    auto matched = contains(hash);
+    const auto& outputs = tx.outputs();
+
+    for (uint32_t index = 0; index < outputs.size(); ++index)
+        if (match_output(outputs[index], hash, index))
+            matched = true;
+
+    if (matched)
+        return true;
+
+    for (const auto& input: tx.inputs())
+        if (match_input(input))
+            return true;
+
+    return false;
+}
+
+merkle_tree::matches bloom_filter::match(const block& block)
+{
+    const auto& txs = block.transactions();
+    merkle_tree::matches matched(txs.size(), false);
+
+    for (size_t position = 0; position < txs.size(); ++position)
+        matched[position] = match(txs[position]);
+
+    return matched;
+}
+
+message::merkle_block bloom_filter::to_merkle_block(const block& block,
+    transaction::list& out_matched)
+{
+    const auto matched = match(block);
+    const auto& txs = block.transactions();
+    out_matched.clear();
+
+    for (size_t position = 0; position < txs.size(); ++position)
+        if (matched[position])
+            out_matched.push_back(txs[position]);
+
+    return message::merkle_block(block, matched);
+}
+
+} // namespace chain
+} // namespace libbitcoin
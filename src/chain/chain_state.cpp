@@ -19,6 +19,7 @@
 #include <bitcoin/bitcoin/chain/chain_state.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
 
@@ -453,6 +454,13 @@ size_t chain_state::bip9_bit1_height(size_t height, uint32_t forks)
     return height > activation_height ? activation_height : map::unrequested;
 }
 
+size_t chain_state::assume_valid_height(size_t height, config::checkpoint const& assume_valid)
+{
+    // Require assume valid hash at heights up to and including assume valid.
+    return assume_valid.hash() != null_hash && height <= assume_valid.height() ?
+        assume_valid.height() : map::unrequested;
+}
+
 // median_time_past
 //-----------------------------------------------------------------------------
 
@@ -575,27 +583,24 @@ timestamps_position(chain_state::timestamps const& times, bool tip) {
     return times.begin();
 }
 
-std::vector<typename chain_state::timestamps::value_type> 
-timestamps_subset(chain_state::timestamps const& times, bool tip) {
-    auto at = timestamps_position(times, tip);
-    auto n = (std::min)((size_t)std::distance(at, times.end()), median_time_past_interval);
-
-    std::vector<typename chain_state::timestamps::value_type> subset(n);
-    std::copy_n(at, n, subset.begin());
-
-    return subset;
-}
-
 uint32_t chain_state::median_time_past(data const& values, uint32_t, bool tip /*= true*/) {
-    // Create a copy for the in-place sort.
-    auto subset = timestamps_subset(values.timestamp.ordered, tip);
+    auto const& times = values.timestamp.ordered;
+    auto const at = timestamps_position(times, tip);
+    auto const n = (std::min)(size_t(std::distance(at, times.end())), median_time_past_interval);
 
-    // Sort the times by value to obtain the median.
-    std::sort(subset.begin(), subset.end());
+    if (n == 0) {
+        return 0;
+    }
+
+    // Select within a fixed-size copy, the window never exceeds the interval.
+    std::array<uint32_t, median_time_past_interval> subset;
+    std::copy_n(at, n, subset.begin());
 
     // Consensus defines median time using modulo 2 element selection.
     // This differs from arithmetic median which averages two middle values.
-    return subset.empty() ? 0 : subset[subset.size() / 2];
+    auto const median = subset.begin() + n / 2;
+    std::nth_element(subset.begin(), median, subset.begin() + n);
+    return *median;
 }
 
 // ------------------------------------------------------------------------------------------------------------
@@ -658,10 +663,9 @@ uint32_t chain_state::cash_difficulty_adjustment(data const& values) {
                                  make_pair(bits_size - 145, values.timestamp.ordered[2]),
                                  pair_cmp);
 
-    uint256_t work = 0;
-    for (size_t i = last_block.first + 1; i <= first_block.first; ++i) {
-        work += header::proof(values.bits.ordered[i]);
-    }
+    // The proofs are summed once per bits value and shared by descendants.
+    auto const proof = [](uint32_t bits) { return header::proof(bits); };
+    auto work = values.bits.ordered.total(last_block.first + 1, first_block.first + 1, proof);
 
     work *= target_spacing_seconds; //10 * 60
 
@@ -887,7 +891,8 @@ size_t chain_state::retarget_distance(size_t height) {
 //-----------------------------------------------------------------------------
 
 // static
-chain_state::map chain_state::get_map(size_t height, checkpoints const& checkpoints, uint32_t forks) {
+chain_state::map chain_state::get_map(size_t height, checkpoints const& checkpoints, uint32_t forks,
+    config::checkpoint const& assume_valid) {
     if (height == 0)
         return{};
 
@@ -920,6 +925,9 @@ chain_state::map chain_state::get_map(size_t height, checkpoints const& checkpoi
     // The checkpoint above which bip9_bit1 rules are enforced.
     map.bip9_bit1_height = bip9_bit1_height(height, forks);
 
+    // The configured block at and below which scripts are presumed valid.
+    map.assume_valid_height = assume_valid_height(height, assume_valid);
+
     return map;
 }
 
@@ -950,15 +958,18 @@ uint32_t chain_state::signal_version(uint32_t forks) {
 // This is promotion from a preceding height to the next.
 chain_state::data chain_state::to_pool(const chain_state& top)
 {
-    // Alias configured forks.
-    const auto forks = top.forks_;
+    // Copy data from presumed previous-height block state.
+    auto data = top.data_;
+    promote_pool(data, top.forks_);
+    return data;
+}
 
+// Promote previous-height block state data in place to pool state data.
+void chain_state::promote_pool(data& data, uint32_t forks)
+{
     // Retargeting is only activated via configuration.
     const auto retarget = script::is_enabled(forks, rule_fork::retarget);
 
-    // Copy data from presumed previous-height block state.
-    auto data = top.data_;
-
     // If this overflows height is zero and result is handled as invalid.
     auto const height = data.height + 1u;
 
@@ -987,7 +998,8 @@ chain_state::data chain_state::to_pool(const chain_state& top)
         // LTC retarget function is like BTC/BCH but uses the index -1.
         // data.timestamps.orderder.back() = current block timestamp = data.timestamp.self (this is used for BTC)
         // data.timestamps.orderder.at(size-2) = retarget block timestamp
-        data.timestamp.retarget = data.timestamp.ordered.at(data.timestamp.ordered.size() - 2);
+        auto const& timestamps = data.timestamp.ordered;
+        data.timestamp.retarget = timestamps.at(timestamps.size() - 2);
 #else
         data.timestamp.retarget = data.timestamp.self;
 #endif
@@ -998,18 +1010,18 @@ chain_state::data chain_state::to_pool(const chain_state& top)
     // Preserve data.allow_collisions_hash promotion.
     // Preserve data.bip9_bit0_hash promotion.
     // Preserve data.bip9_bit1_hash promotion.
+    // Preserve data.assume_valid_hash promotion.
     data.height = height;
     data.hash = null_hash;
     data.bits.self = work_limit(retarget);
     data.version.self = signal_version(forks);
     data.timestamp.self = max_uint32;
-    return data;
 }
 
 // Constructor (top to pool).
 // This generates a state for the pool above the presumed top block state.
 chain_state::chain_state(chain_state const& top)
-    : data_(to_pool(top)), forks_(top.forks_), checkpoints_(top.checkpoints_), active_(activation(data_, forks_
+    : data_(to_pool(top)), forks_(top.forks_), checkpoints_(top.checkpoints_), assume_valid_(top.assume_valid_), active_(activation(data_, forks_
 #ifdef BITPRIM_CURRENCY_BCH
             , top.magnetic_anomaly_activation_time_
             , top.great_wall_activation_time_
@@ -1060,13 +1072,17 @@ chain_state::data chain_state::to_block(const chain_state& pool,
         data.bip9_bit1_hash = data.hash;
 #endif
 
+    // Cache hash of assume valid height block, otherwise use preceding state.
+    if (data.height == pool.assume_valid_.height())
+        data.assume_valid_hash = data.hash;
+
     return data;
 }
 
 // Constructor (tx pool to block).
 // This assumes that the pool state is the same height as the block.
 chain_state::chain_state(chain_state const& pool, block const& block)
-    : data_(to_block(pool, block)), forks_(pool.forks_), checkpoints_(pool.checkpoints_), active_(activation(data_, forks_
+    : data_(to_block(pool, block)), forks_(pool.forks_), checkpoints_(pool.checkpoints_), assume_valid_(pool.assume_valid_), active_(activation(data_, forks_
 #ifdef BITPRIM_CURRENCY_BCH
         , pool.magnetic_anomaly_activation_time_
         , pool.great_wall_activation_time_
@@ -1083,20 +1099,25 @@ chain_state::chain_state(chain_state const& pool, block const& block)
 chain_state::data chain_state::to_header(const chain_state& parent,
     const header& header)
 {
-    // Alias configured forks.
-    const auto forks = parent.forks_;
+    // Copy and promote data from presumed parent-height header/block state.
+    auto data = to_pool(parent);
+    promote_header(data, header, header.hash(), parent.forks_,
+        parent.assume_valid_);
+    return data;
+}
 
+// Replace the pool (empty) current block state data with given header state.
+void chain_state::promote_header(data& data, const header& header,
+    const hash_digest& hash, uint32_t forks,
+    const config::checkpoint& assume_valid)
+{
     // Retargeting and testnet are only activated via configuration.
     const auto testnet = script::is_enabled(forks, rule_fork::easy_blocks);
     const auto retarget = script::is_enabled(forks, rule_fork::retarget);
     const auto mainnet = retarget && !testnet;
 
-    // Copy and promote data from presumed parent-height header/block state.
-    auto data = to_pool(parent);
-
-    // Replace the pool (empty) current block state with given header state.
     // Preserve data.timestamp.retarget promotion.
-    data.hash = header.hash();
+    data.hash = hash;
     data.bits.self = header.bits();
     data.version.self = header.version();
     data.timestamp.self = header.timestamp();
@@ -1115,13 +1136,15 @@ chain_state::data chain_state::to_header(const chain_state& parent,
         data.bip9_bit1_hash = data.hash;
 #endif
 
-    return data;
+    // Cache hash of assume valid height block, otherwise use preceding state.
+    if (data.height == assume_valid.height())
+        data.assume_valid_hash = data.hash;
 }
 
 // Constructor (parent to header).
 // This assumes that parent is the state of the header's previous block.
 chain_state::chain_state(chain_state const& parent, header const& header)
-    : data_(to_header(parent, header)), forks_(parent.forks_), checkpoints_(parent.checkpoints_), active_(activation(data_, forks_
+    : data_(to_header(parent, header)), forks_(parent.forks_), checkpoints_(parent.checkpoints_), assume_valid_(parent.assume_valid_), active_(activation(data_, forks_
 #ifdef BITPRIM_CURRENCY_BCH
         , parent.magnetic_anomaly_activation_time_
         , parent.great_wall_activation_time_
@@ -1142,8 +1165,9 @@ chain_state::chain_state(data&& values, checkpoints const& checkpoints, uint32_t
         , magnetic_anomaly_t magnetic_anomaly_activation_time
         , great_wall_t great_wall_activation_time
 #endif  //BITPRIM_CURRENCY_BCH
+        , config::checkpoint const& assume_valid
                          )
-    : data_(std::move(values)), forks_(forks | rule_fork::allow_collisions), checkpoints_(checkpoints), active_(activation(data_, forks_
+    : data_(std::move(values)), forks_(forks | rule_fork::allow_collisions), checkpoints_(checkpoints), assume_valid_(assume_valid), active_(activation(data_, forks_
 #ifdef BITPRIM_CURRENCY_BCH
             , magnetic_anomaly_activation_time
             , great_wall_activation_time
@@ -1218,6 +1242,13 @@ bool chain_state::is_under_checkpoint() const {
     return checkpoint::covered(data_.height, checkpoints_);
 }
 
+bool chain_state::is_under_assume_valid() const {
+    // The populated hash ties this height to the assume valid block's chain.
+    return assume_valid_.hash() != null_hash &&
+        data_.height <= assume_valid_.height() &&
+        data_.assume_valid_hash == assume_valid_.hash();
+}
+
 // Mining.
 //-----------------------------------------------------------------------------
 
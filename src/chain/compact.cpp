@@ -79,14 +79,9 @@ inline uint32_t shift_high(uint8_t exponent)
     return  8 * (exponent - 3);
 }
 
-inline size_t logical_size(uint256_t value)
+inline size_t logical_size(const uint256_t& value)
 {
-    auto byte = 0;
-
-    for (; value != 0; ++byte)
-        value >>= 8;
-
-    return byte;
+    return (value.bit_length() + 7) / 8;
 }
 
 // Constructors
@@ -0,0 +1,412 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/compact_filter.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <bitcoin/bitcoin/chain/input.hpp>
+#include <bitcoin/bitcoin/chain/output.hpp>
+#include <bitcoin/bitcoin/chain/script.hpp>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/machine/opcode.hpp>
+#include <bitcoin/bitcoin/math/sip_hash.hpp>
+#include <bitcoin/bitcoin/message/messages.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
+#include <bitcoin/bitcoin/utility/serializer.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+const uint8_t compact_filter::basic = 0x00;
+const uint8_t compact_filter::golomb_bits = 19;
+const uint64_t compact_filter::inverse_false_positive_rate = 784931;
+
+// Helpers.
+//-----------------------------------------------------------------------------
+
+// The high half of the 128 bit product, mapping a hash uniformly to a range.
+static inline uint64_t to_range(uint64_t hash, uint64_t range)
+{
+#ifdef __SIZEOF_INT128__
+    __extension__ typedef unsigned __int128 uint128;
+    return static_cast<uint64_t>((static_cast<uint128>(hash) * range) >> 64);
+#else
+    const uint64_t mask = 0xffffffff;
+    const auto hash_low = hash & mask;
+    const auto hash_high = hash >> 32;
+    const auto range_low = range & mask;
+    const auto range_high = range >> 32;
+
+    const auto low_low = hash_low * range_low;
+    const auto high_low = hash_high * range_low;
+    const auto low_high = hash_low * range_high;
+    const auto middle = (low_low >> 32) + (high_low & mask) + low_high;
+    return hash_high * range_high + (high_low >> 32) + (middle >> 32);
+#endif
+}
+
+// Bits are written and read most significant first.
+class bit_writer
+{
+public:
+    bit_writer(data_chunk& out)
+      : out_(out), byte_(0), bits_(0)
+    {
+    }
+
+    void write_bit(bool bit)
+    {
+        byte_ = static_cast<uint8_t>((byte_ << 1) | (bit ? 1 : 0));
+
+        if (++bits_ == byte_bits)
+            flush();
+    }
+
+    void write_bits(uint64_t value, uint8_t count)
+    {
+        while (count-- > 0)
+            write_bit(((value >> count) & 1) != 0);
+    }
+
+    void flush()
+    {
+        if (bits_ == 0)
+            return;
+
+        out_.push_back(static_cast<uint8_t>(byte_ << (byte_bits - bits_)));
+        byte_ = 0;
+        bits_ = 0;
+    }
+
+private:
+    data_chunk& out_;
+    uint8_t byte_;
+    uint8_t bits_;
+};
+
+class bit_reader
+{
+public:
+    bit_reader(const data_chunk& in, size_t offset)
+      : in_(in), position_(offset * byte_bits)
+    {
+    }
+
+    bool read_bit(bool& out)
+    {
+        if (position_ >= in_.size() * byte_bits)
+            return false;
+
+        const auto byte = in_[position_ / byte_bits];
+        out = ((byte >> (byte_bits - 1 - position_ % byte_bits)) & 1) != 0;
+        ++position_;
+        return true;
+    }
+
+    bool read_bits(uint64_t& out, uint8_t count)
+    {
+        bool bit;
+        out = 0;
+
+        while (count-- > 0)
+        {
+            if (!read_bit(bit))
+                return false;
+
+            out = (out << 1) | (bit ? 1 : 0);
+        }
+
+        return true;
+    }
+
+    // Golomb-Rice: the quotient in unary, then the remainder in fixed bits.
+    bool read_golomb(uint64_t& out, uint8_t remainder_bits)
+    {
+        bool bit;
+        uint64_t quotient = 0;
+
+        while (true)
+        {
+            if (!read_bit(bit))
+                return false;
+
+            if (!bit)
+                break;
+
+            ++quotient;
+        }
+
+        uint64_t remainder;
+
+        if (!read_bits(remainder, remainder_bits))
+            return false;
+
+        out = (quotient << remainder_bits) | remainder;
+        return true;
+    }
+
+private:
+    const data_chunk& in_;
+    size_t position_;
+};
+
+// The output scripts that are not null data and the spent prevout scripts.
+static data_stack basic_elements(const block& block)
+{
+    data_stack elements;
+    const auto& txs = block.transactions();
+
+    for (const auto& tx: txs)
+    {
+        for (const auto& output: tx.outputs())
+        {
+            auto script = output.script().to_data(false);
+
+            if (!script.empty() && script.front() !=
+                static_cast<uint8_t>(machine::opcode::return_))
+                elements.push_back(std::move(script));
+        }
+
+        if (tx.is_coinbase())
+            continue;
+
+        for (const auto& input: tx.inputs())
+        {
+            const auto& prevout = input.previous_output().validation.cache;
+            auto script = prevout.script().to_data(false);
+
+            if (!script.empty())
+                elements.push_back(std::move(script));
+        }
+    }
+
+    return elements;
+}
+
+// Constructors.
+//-----------------------------------------------------------------------------
+
+compact_filter::compact_filter()
+  : block_hash_(null_hash), count_(0), offset_(0), key0_(0), key1_(0),
+    valid_(false)
+{
+}
+
+compact_filter::compact_filter(const hash_digest& block_hash,
+    const data_stack& elements)
+  : block_hash_(block_hash), count_(0), offset_(0), valid_(true)
+{
+    set_keys();
+    encode(elements);
+}
+
+compact_filter::compact_filter(const hash_digest& block_hash,
+    const data_chunk& encoded)
+  : block_hash_(block_hash), encoded_(encoded), count_(0), offset_(0)
+{
+    set_keys();
+    valid_ = decode_count();
+}
+
+compact_filter::compact_filter(const hash_digest& block_hash,
+    data_chunk&& encoded)
+  : block_hash_(block_hash), encoded_(std::move(encoded)), count_(0),
+    offset_(0)
+{
+    set_keys();
+    valid_ = decode_count();
+}
+
+compact_filter::compact_filter(const block& block)
+  : compact_filter(block.hash(), basic_elements(block))
+{
+}
+
+// The siphash key is the first half of the block hash.
+void compact_filter::set_keys()
+{
+    key0_ = get_uint64<0>(block_hash_);
+    key1_ = get_uint64<1>(block_hash_);
+}
+
+// Each element requires at least golomb_bits + 1 bits of the stream.
+bool compact_filter::decode_count()
+{
+    auto source = make_safe_deserializer(encoded_.begin(), encoded_.end());
+    count_ = source.read_variable_little_endian();
+
+    if (!source)
+        return false;
+
+    offset_ = message::variable_uint_size(count_);
+    const auto bits = (encoded_.size() - offset_) * byte_bits;
+    return count_ <= bits / (golomb_bits + 1u);
+}
+
+uint64_t compact_filter::to_value(data_slice element) const
+{
+    return sip_hasher(key0_, key1_).write(element.data(), element.size())
+        .finalize();
+}
+
+// Mapping to the range is monotonic, so hashes are sorted once, before the
+// distinct count (and so the range) is known. Distinct elements are found by
+// hash, with elements compared only where hashes are equal.
+void compact_filter::encode(const data_stack& elements)
+{
+    std::vector<std::pair<uint64_t, size_t>> hashes;
+    hashes.reserve(elements.size());
+
+    for (size_t index = 0; index < elements.size(); ++index)
+        hashes.emplace_back(to_value(elements[index]), index);
+
+    std::sort(hashes.begin(), hashes.end());
+
+    const auto same = [&elements](const std::pair<uint64_t, size_t>& left,
+        const std::pair<uint64_t, size_t>& right)
+    {
+        return left.first == right.first &&
+            elements[left.second] == elements[right.second];
+    };
+
+    hashes.erase(std::unique(hashes.begin(), hashes.end(), same),
+        hashes.end());
+
+    count_ = hashes.size();
+    offset_ = message::variable_uint_size(count_);
+    const auto range = count_ * inverse_false_positive_rate;
+
+    // Each delta averages golomb_bits + 2 bits.
+    encoded_.reserve(offset_ + (count_ * (golomb_bits + 2u) + 7u) / 8u);
+    encoded_.resize(offset_);
+    make_unsafe_serializer(encoded_.begin()).write_variable_little_endian(
+        count_);
+
+    bit_writer sink(encoded_);
+    uint64_t previous = 0;
+
+    for (const auto& hash: hashes)
+    {
+        const auto value = to_range(hash.first, range);
+        const auto delta = value - previous;
+        previous = value;
+
+        for (auto quotient = delta >> golomb_bits; quotient > 0; --quotient)
+            sink.write_bit(true);
+
+        sink.write_bit(false);
+        sink.write_bits(delta, golomb_bits);
+    }
+
+    sink.flush();
+}
+
+// Properties.
+//-----------------------------------------------------------------------------
+
+bool compact_filter::is_valid() const
+{
+    return valid_;
+}
+
+const hash_digest& compact_filter::block_hash() const
+{
+    return block_hash_;
+}
+
+const data_chunk& compact_filter::encoded() const
+{
+    return encoded_;
+}
+
+uint64_t compact_filter::size() const
+{
+    return count_;
+}
+
+hash_digest compact_filter::hash() const
+{
+    return bitcoin_hash(encoded_);
+}
+
+hash_digest compact_filter::header(const hash_digest& previous_header) const
+{
+    return bitcoin_hash(build_chunk({ hash(), previous_header }));
+}
+
+// Matching.
+//-----------------------------------------------------------------------------
+
+bool compact_filter::match(data_slice element) const
+{
+    if (!valid_ || count_ == 0)
+        return false;
+
+    const auto range = count_ * inverse_false_positive_rate;
+    return match_sorted({ to_range(to_value(element), range) });
+}
+
+bool compact_filter::match_any(const data_stack& elements) const
+{
+    if (!valid_ || count_ == 0 || elements.empty())
+        return false;
+
+    const auto range = count_ * inverse_false_positive_rate;
+    values queries;
+    queries.reserve(elements.size());
+
+    for (const auto& element: elements)
+        queries.push_back(to_range(to_value(element), range));
+
+    std::sort(queries.begin(), queries.end());
+    return match_sorted(queries);
+}
+
+// Merge the sorted queries with the set as it is decoded, stopping early.
+bool compact_filter::match_sorted(const values& queries) const
+{
+    bit_reader source(encoded_, offset_);
+    auto query = queries.begin();
+    uint64_t value = 0;
+
+    for (uint64_t element = 0; element < count_; ++element)
+    {
+        uint64_t delta;
+
+        if (!source.read_golomb(delta, golomb_bits))
+            return false;
+
+        value += delta;
+
+        while (*query < value)
+            if (++query == queries.end())
+                return false;
+
+        if (*query == value)
+            return true;
+    }
+
+    return false;
+}
+
+} // namespace chain
+} // namespace libbitcoin
@@ -0,0 +1,494 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/compression.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <bitcoin/bitcoin/chain/input.hpp>
+#include <bitcoin/bitcoin/chain/output_point.hpp>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/machine/opcode.hpp>
+#include <bitcoin/bitcoin/math/elliptic_curve.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/container_sink.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
+#include <bitcoin/bitcoin/utility/ostream_writer.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+using namespace bc::machine;
+
+// Compressed script types, any other value is (raw script size + specials).
+static BC_CONSTEXPR uint8_t key_hash_type = 0x00;
+static BC_CONSTEXPR uint8_t script_hash_type = 0x01;
+static BC_CONSTEXPR uint8_t compressed_even_type = 0x02;
+static BC_CONSTEXPR uint8_t compressed_odd_type = 0x03;
+static BC_CONSTEXPR uint8_t uncompressed_even_type = 0x04;
+static BC_CONSTEXPR uint8_t uncompressed_odd_type = 0x05;
+static BC_CONSTEXPR uint64_t special_scripts = 6;
+
+// The largest amount for which the compressed amount does not overflow.
+static BC_CONSTEXPR uint64_t max_compressible_amount = max_uint64 / 9 - 1;
+
+static BC_CONSTEXPR size_t key_hash_script_size = 25;
+static BC_CONSTEXPR size_t script_hash_script_size = 23;
+static BC_CONSTEXPR size_t compressed_key_script_size = 35;
+static BC_CONSTEXPR size_t uncompressed_key_script_size = 67;
+static BC_CONSTEXPR size_t compressed_key_size = 33;
+static BC_CONSTEXPR size_t uncompressed_key_size = 65;
+static BC_CONSTEXPR size_t coordinate_size = 32;
+
+// Point hashes already written to a transaction, by one-based ordinal.
+typedef std::unordered_map<hash_digest, size_t> ordinal_map;
+
+static uint8_t to_byte(opcode code)
+{
+    return static_cast<uint8_t>(code);
+}
+
+static bool is_key_hash(const data_chunk& bytes)
+{
+    return bytes.size() == key_hash_script_size
+        && bytes[0] == to_byte(opcode::dup)
+        && bytes[1] == to_byte(opcode::hash160)
+        && bytes[2] == short_hash_size
+        && bytes[23] == to_byte(opcode::equalverify)
+        && bytes[24] == to_byte(opcode::checksig);
+}
+
+static bool is_script_hash(const data_chunk& bytes)
+{
+    return bytes.size() == script_hash_script_size
+        && bytes[0] == to_byte(opcode::hash160)
+        && bytes[1] == short_hash_size
+        && bytes[22] == to_byte(opcode::equal);
+}
+
+static bool is_compressed_key(const data_chunk& bytes)
+{
+    return bytes.size() == compressed_key_script_size
+        && bytes[0] == compressed_key_size
+        && (bytes[1] == compressed_even_type || bytes[1] == compressed_odd_type)
+        && bytes[34] == to_byte(opcode::checksig);
+}
+
+static bool is_uncompressed_key(const data_chunk& bytes)
+{
+    return bytes.size() == uncompressed_key_script_size
+        && bytes[0] == uncompressed_key_size
+        && bytes[1] == uncompressed_even_type
+        && bytes[66] == to_byte(opcode::checksig);
+}
+
+// Amounts.
+//-----------------------------------------------------------------------------
+
+// The value is factored into (n * 10^e) with e <= 9 and the last digit of n
+// (which cannot be zero if e < 9) is stored in base 9. The result is at most
+// 9n + 9, so larger values overflow and are not reversible.
+uint64_t compress_amount(uint64_t value)
+{
+    BITCOIN_ASSERT(value <= max_compressible_amount);
+
+    if (value == 0)
+        return 0;
+
+    uint64_t exponent = 0;
+    for (; value % 10 == 0 && exponent < 9; ++exponent)
+        value /= 10;
+
+    if (exponent < 9)
+    {
+        const auto digit = value % 10;
+        value /= 10;
+        return 1 + (value * 9 + digit - 1) * 10 + exponent;
+    }
+
+    return 1 + (value - 1) * 10 + 9;
+}
+
+bool decompress_amount(uint64_t& out, uint64_t value)
+{
+    if (value == 0)
+    {
+        out = 0;
+        return true;
+    }
+
+    --value;
+    auto exponent = value % 10;
+    value /= 10;
+    uint64_t amount;
+
+    if (exponent < 9)
+    {
+        const auto digit = (value % 9) + 1;
+        value /= 9;
+
+        if (value > (max_uint64 - digit) / 10)
+            return false;
+
+        amount = value * 10 + digit;
+    }
+    else
+    {
+        if (value == max_uint64)
+            return false;
+
+        amount = value + 1;
+    }
+
+    for (; exponent > 0; --exponent)
+    {
+        if (amount > max_uint64 / 10)
+            return false;
+
+        amount *= 10;
+    }
+
+    out = amount;
+    return true;
+}
+
+// Scripts.
+//-----------------------------------------------------------------------------
+
+void to_compressed_data(writer& sink, const script& value)
+{
+    const auto bytes = value.to_data(false);
+    const auto begin = bytes.begin();
+
+    if (is_key_hash(bytes))
+    {
+        sink.write_byte(key_hash_type);
+        sink.write_bytes(&bytes[3], short_hash_size);
+        return;
+    }
+
+    if (is_script_hash(bytes))
+    {
+        sink.write_byte(script_hash_type);
+        sink.write_bytes(&bytes[2], short_hash_size);
+        return;
+    }
+
+    if (is_compressed_key(bytes))
+    {
+        sink.write_bytes(&bytes[1], compressed_key_size);
+        return;
+    }
+
+    // Only a point on the curve can be restored from its x coordinate.
+    if (is_uncompressed_key(bytes))
+    {
+        ec_uncompressed point;
+        ec_compressed compressed;
+        std::copy_n(begin + 1, point.size(), point.begin());
+
+        if (compress(compressed, point))
+        {
+            const auto odd = compressed.front() == compressed_odd_type;
+            sink.write_byte(odd ? uncompressed_odd_type :
+                uncompressed_even_type);
+            sink.write_bytes(&compressed[1], coordinate_size);
+            return;
+        }
+    }
+
+    sink.write_variable_little_endian(bytes.size() + special_scripts);
+    sink.write_bytes(bytes);
+}
+
+bool from_compressed_data(reader& source, script& out)
+{
+    const auto type = source.read_variable_little_endian();
+    data_chunk bytes;
+
+    switch (type)
+    {
+        case key_hash_type:
+        {
+            const auto hash = source.read_short_hash();
+            bytes = build_chunk(
+            {
+                data_chunk{ to_byte(opcode::dup), to_byte(opcode::hash160),
+                    static_cast<uint8_t>(short_hash_size) },
+                hash,
+                data_chunk{ to_byte(opcode::equalverify),
+                    to_byte(opcode::checksig) }
+            });
+            break;
+        }
+        case script_hash_type:
+        {
+            const auto hash = source.read_short_hash();
+            bytes = build_chunk(
+            {
+                data_chunk{ to_byte(opcode::hash160),
+                    static_cast<uint8_t>(short_hash_size) },
+                hash,
+                data_chunk{ to_byte(opcode::equal) }
+            });
+            break;
+        }
+        case compressed_even_type:
+        case compressed_odd_type:
+        {
+            const auto x = source.read_bytes(coordinate_size);
+            bytes = build_chunk(
+            {
+                data_chunk{ static_cast<uint8_t>(compressed_key_size),
+                    static_cast<uint8_t>(type) },
+                x,
+                data_chunk{ to_byte(opcode::checksig) }
+            });
+            break;
+        }
+        case uncompressed_even_type:
+        case uncompressed_odd_type:
+        {
+            ec_compressed compressed;
+            ec_uncompressed point;
+            compressed.front() = static_cast<uint8_t>(type - 2);
+            const auto x = source.read_bytes(coordinate_size);
+
+            if (!source)
+                return false;
+
+            std::copy(x.begin(), x.end(), compressed.begin() + 1);
+
+            if (!decompress(point, compressed))
+            {
+                source.invalidate();
+                return false;
+            }
+
+            bytes = build_chunk(
+            {
+                data_chunk{ static_cast<uint8_t>(uncompressed_key_size) },
+                point,
+                data_chunk{ to_byte(opcode::checksig) }
+            });
+            break;
+        }
+        default:
+        {
+            // As with script::from_data, guard memory allocation.
+            const auto size = type - special_scripts;
+
+            if (size > get_max_block_size())
+                source.invalidate();
+            else
+                bytes = source.read_bytes(static_cast<size_t>(size));
+
+            break;
+        }
+    }
+
+    if (!source)
+        return false;
+
+    out.from_data(bytes, false);
+    return true;
+}
+
+// Outputs.
+//-----------------------------------------------------------------------------
+
+data_chunk to_compressed_data(const output& value)
+{
+    data_chunk data;
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    to_compressed_data(sink, value);
+    ostream.flush();
+    return data;
+}
+
+void to_compressed_data(writer& sink, const output& value)
+{
+    sink.write_variable_little_endian(compress_amount(value.value()));
+    to_compressed_data(sink, value.script());
+}
+
+bool from_compressed_data(const data_chunk& data, output& out)
+{
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    return from_compressed_data(source, out);
+}
+
+bool from_compressed_data(reader& source, output& out)
+{
+    uint64_t value;
+    script script;
+
+    if (!decompress_amount(value, source.read_variable_little_endian()))
+        source.invalidate();
+
+    if (!source || !from_compressed_data(source, script))
+        return false;
+
+    out = output(value, std::move(script));
+    return true;
+}
+
+// Transactions.
+//-----------------------------------------------------------------------------
+
+// A point hash is written in full on first occurrence (tag zero) and
+// thereafter as the one-based ordinal of that first occurrence.
+static void write_point(writer& sink, const output_point& point,
+    ordinal_map& ordinals)
+{
+    const auto ordinal = ordinals.size() + 1u;
+    const auto it = ordinals.emplace(point.hash(), ordinal);
+
+    if (it.second)
+    {
+        sink.write_variable_little_endian(0);
+        sink.write_hash(point.hash());
+    }
+    else
+    {
+        sink.write_variable_little_endian(it.first->second);
+    }
+
+    sink.write_variable_little_endian(point.index());
+}
+
+static output_point read_point(reader& source, hash_list& hashes)
+{
+    const auto tag = source.read_variable_little_endian();
+    hash_digest hash = null_hash;
+
+    if (tag == 0)
+    {
+        hash = source.read_hash();
+        hashes.push_back(hash);
+    }
+    else if (tag <= hashes.size())
+    {
+        hash = hashes[static_cast<size_t>(tag - 1)];
+    }
+    else
+    {
+        source.invalidate();
+    }
+
+    const auto index = source.read_variable_little_endian();
+
+    if (index > max_uint32)
+        source.invalidate();
+
+    return { hash, static_cast<uint32_t>(index) };
+}
+
+data_chunk to_compressed_data(const transaction& value)
+{
+    data_chunk data;
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    to_compressed_data(sink, value);
+    ostream.flush();
+    return data;
+}
+
+// Outputs forward, as with the database serialization. The final sequence
+// is by far the most common so sequences are stored as their complement.
+void to_compressed_data(writer& sink, const transaction& value)
+{
+    sink.write_variable_little_endian(value.version());
+    sink.write_variable_little_endian(value.locktime());
+
+    const auto& outputs = value.outputs();
+    sink.write_variable_little_endian(outputs.size());
+
+    for (const auto& output: outputs)
+        to_compressed_data(sink, output);
+
+    ordinal_map ordinals;
+    const auto& inputs = value.inputs();
+    sink.write_variable_little_endian(inputs.size());
+
+    for (const auto& input: inputs)
+    {
+        write_point(sink, input.previous_output(), ordinals);
+        input.script().to_data(sink, true);
+        sink.write_variable_little_endian(max_uint32 - input.sequence());
+    }
+}
+
+bool from_compressed_data(const data_chunk& data, transaction& out)
+{
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    return from_compressed_data(source, out);
+}
+
+bool from_compressed_data(reader& source, transaction& out)
+{
+    const auto version = source.read_variable_little_endian();
+    const auto locktime = source.read_variable_little_endian();
+
+    if (version > max_uint32 || locktime > max_uint32)
+        source.invalidate();
+
+    // Counts are not trusted for allocation, elements are appended as read.
+    const auto output_count = source.read_size_little_endian();
+    output::list outputs;
+
+    for (size_t index = 0; source && index < output_count; ++index)
+    {
+        outputs.emplace_back();
+        from_compressed_data(source, outputs.back());
+    }
+
+    hash_list hashes;
+    const auto input_count = source.read_size_little_endian();
+    input::list inputs;
+
+    for (size_t index = 0; source && index < input_count; ++index)
+    {
+        auto point = read_point(source, hashes);
+        script script;
+        script.from_data(source, true);
+        const auto sequence = source.read_variable_little_endian();
+
+        if (sequence > max_uint32)
+            source.invalidate();
+
+        inputs.emplace_back(std::move(point), std::move(script),
+            static_cast<uint32_t>(max_uint32 - sequence));
+    }
+
+    if (!source)
+        return false;
+
+    out = transaction(static_cast<uint32_t>(version),
+        static_cast<uint32_t>(locktime), std::move(inputs),
+        std::move(outputs));
+    return true;
+}
+
+} // namespace chain
+} // namespace libbitcoin
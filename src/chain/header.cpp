@@ -467,24 +467,32 @@ bool header::is_valid_timestamp() const
 // [CheckProofOfWork]
 bool header::is_valid_proof_of_work(bool retarget) const
 {
-    const auto bits = compact(bits_);
-    static const uint256_t pow_limit(compact{ work_limit(retarget) });
+#ifdef BITPRIM_CURRENCY_LTC
+    return is_valid_proof_of_work(litecoin_proof_of_work_hash(), bits_,
+        retarget);
+#else //BITPRIM_CURRENCY_LTC
+    return is_valid_proof_of_work(hash(), bits_, retarget);
+#endif //BITPRIM_CURRENCY_LTC
+}
+
+// static
+bool header::is_valid_proof_of_work(const hash_digest& hash, uint32_t bits,
+    bool retarget)
+{
+    const auto target_bits = compact(bits);
+    const uint256_t pow_limit(compact{ work_limit(retarget) });
 
-    if (bits.is_overflowed())
+    if (target_bits.is_overflowed())
         return false;
 
-    uint256_t target(bits);
+    uint256_t target(target_bits);
 
     // Ensure claimed work is within limits.
     if (target < 1 || target > pow_limit)
         return false;
 
     // Ensure actual work is at least claimed amount (smaller is more work).
-#ifdef BITPRIM_CURRENCY_LTC
-    return to_uint256(litecoin_proof_of_work_hash()) <= target;
-#else //BITPRIM_CURRENCY_LTC
-    return to_uint256(hash()) <= target;
-#endif //BITPRIM_CURRENCY_LTC
+    return to_uint256(hash) <= target;
 }
 
 // Validation.
@@ -0,0 +1,254 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/header_batch.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include <bitcoin/bitcoin/chain/script.hpp>
+#include <bitcoin/bitcoin/config/checkpoint.hpp>
+#include <bitcoin/bitcoin/machine/rule_fork.hpp>
+#include <bitcoin/bitcoin/math/limits.hpp>
+#include <bitcoin/bitcoin/message/header.hpp>
+#include <bitcoin/bitcoin/utility/serializer.hpp>
+#include <bitcoin/bitcoin/utility/thread.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+using namespace bc::config;
+using namespace bc::machine;
+
+// Smaller partitions do not amortize the cost of dispatch.
+static BC_CONSTEXPR size_t min_partition = 64;
+
+header_batch::header_batch(size_t threads)
+  : pool_(thread_default(threads)), valid_(0)
+{
+}
+
+header_batch::~header_batch()
+{
+    pool_.shutdown();
+    pool_.join();
+}
+
+code header_batch::validate(const chain_state& parent,
+    const header::list& headers)
+{
+    header_pointers pointers;
+    pointers.reserve(headers.size());
+
+    for (const auto& header: headers)
+        pointers.push_back(&header);
+
+    return validate(parent, pointers);
+}
+
+code header_batch::validate(const chain_state& parent,
+    const std::vector<message::header>& headers)
+{
+    header_pointers pointers;
+    pointers.reserve(headers.size());
+
+    for (const auto& header: headers)
+        pointers.push_back(&header);
+
+    return validate(parent, pointers);
+}
+
+const hash_list& header_batch::hashes() const
+{
+    return hashes_;
+}
+
+size_t header_batch::valid() const
+{
+    return valid_;
+}
+
+chain_state::ptr header_batch::top() const
+{
+    return top_;
+}
+
+code header_batch::validate(const chain_state& parent,
+    const header_pointers& headers)
+{
+    valid_ = 0;
+    top_.reset();
+
+    const auto retarget = script::is_enabled(parent.forks_,
+        rule_fork::retarget);
+    check(headers, retarget);
+    return accept(parent, headers);
+}
+
+// Hash and check each header, independent of the others. Each partition
+// serializes into one reused buffer rather than allocating per header.
+void header_batch::check(const header_pointers& headers, bool retarget)
+{
+    const auto count = headers.size();
+    hashes_.assign(count, null_hash);
+    checks_.assign(count, error::success);
+
+    if (count == 0)
+        return;
+
+    const auto threads = std::max(pool_.size(), size_t(1));
+    const auto partitions = std::min(threads,
+        (count + min_partition - 1u) / min_partition);
+    const auto span = (count + partitions - 1u) / partitions;
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    auto remaining = partitions;
+
+    const auto check_partition = [&](size_t begin, size_t end)
+    {
+        data_chunk buffer(header::satoshi_fixed_size());
+
+        for (auto index = begin; index < end; ++index)
+        {
+            const auto& header = *headers[index];
+            auto sink = make_unsafe_serializer(buffer.begin());
+            header.to_data(sink);
+            hashes_[index] = bitcoin_hash(buffer);
+
+#ifdef BITPRIM_CURRENCY_LTC
+            const auto pow_hash = litecoin_hash(buffer);
+#else
+            const auto& pow_hash = hashes_[index];
+#endif
+
+            if (!header::is_valid_proof_of_work(pow_hash, header.bits(),
+                retarget))
+                checks_[index] = error::invalid_proof_of_work;
+            else if (!header.is_valid_timestamp())
+                checks_[index] = error::futuristic_timestamp;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (--remaining == 0)
+            finished.notify_one();
+    };
+
+    for (size_t partition = 0; partition < partitions; ++partition)
+    {
+        const auto begin = partition * span;
+        const auto end = std::min(begin + span, count);
+        pool_.service().post(std::bind(check_partition, begin, end));
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&]()
+    {
+        return remaining == 0;
+    });
+}
+
+// Promote one copy of the parent state data through the headers, evaluating
+// the state rules as header::accept does against a constructed state.
+code header_batch::accept(const chain_state& parent,
+    const header_pointers& headers)
+{
+    const auto forks = parent.forks_;
+    const auto& checkpoints = parent.checkpoints_;
+    const auto& assume_valid = parent.assume_valid_;
+    auto previous = parent.data_;
+    auto values = previous;
+    code ec = error::success;
+
+    for (size_t index = 0; index < headers.size(); ++index)
+    {
+        const auto& header = *headers[index];
+        const auto& hash = hashes_[index];
+        const auto& parent_hash = index == 0 ? parent.data_.hash :
+            hashes_[index - 1u];
+
+        if (header.previous_block_hash() != parent_hash)
+        {
+            ec = error::orphan_block;
+            break;
+        }
+
+        if ((ec = checks_[index]))
+            break;
+
+        chain_state::promote_pool(values, forks);
+        chain_state::promote_header(values, header, hash, forks,
+            assume_valid);
+
+        const auto height = values.height;
+
+        if (header.bits() != chain_state::work_required(values, forks))
+            ec = error::incorrect_proof_of_work;
+
+        else if (!checkpoint::validate(hash, height, checkpoints))
+            ec = error::checkpoints_failed;
+
+        else if (!checkpoint::covered(height, checkpoints))
+        {
+            const auto active = chain_state::activation(values, forks
+#ifdef BITPRIM_CURRENCY_BCH
+                , parent.magnetic_anomaly_activation_time_
+                , parent.great_wall_activation_time_
+#endif
+                );
+
+            if (header.version() < active.minimum_version)
+                ec = error::old_version_block;
+
+            else if (header.timestamp() <=
+                chain_state::median_time_past(values, forks))
+                ec = error::timestamp_too_early;
+        }
+
+        if (ec)
+        {
+            values = std::move(previous);
+            break;
+        }
+
+        ++valid_;
+
+        // Retain the last valid data only while a failure remains possible.
+        if (index + 1u < headers.size())
+            previous = values;
+    }
+
+    if (valid_ != 0)
+        top_ = std::make_shared<chain_state>(std::move(values), checkpoints,
+            forks
+#ifdef BITPRIM_CURRENCY_BCH
+            , parent.magnetic_anomaly_activation_time_
+            , parent.great_wall_activation_time_
+#endif
+            , assume_valid);
+
+    return ec;
+}
+
+} // namespace chain
+} // namespace libbitcoin
@@ -0,0 +1,311 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/iblt.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/message/messages.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+const uint8_t iblt::default_hash_functions = 3;
+const uint8_t iblt::max_hash_functions = 8;
+
+// The seed of each hash function is spaced by this multiplier (as BIP37).
+static const uint32_t seed_multiplier = 0xfba4c795;
+
+// The serialized size of a cell (count, key sum and check sum).
+static const size_t cell_size = sizeof(uint32_t) + sizeof(uint64_t) +
+    sizeof(uint32_t);
+
+// Constructors.
+//-----------------------------------------------------------------------------
+
+iblt::iblt()
+  : hash_functions_(default_hash_functions), seed_(0)
+{
+    set_seeds();
+}
+
+// About half again as many cells as keys peel with high probability, and
+// small tables need a few more cells per hash function than that.
+iblt::iblt(size_t capacity, uint32_t seed, uint8_t hash_functions)
+  : hash_functions_(std::max(std::min(hash_functions, max_hash_functions),
+        uint8_t(1))),
+    seed_(seed)
+{
+    const size_t functions = hash_functions_;
+    const auto minimum = capacity + capacity / 2u + 2u * functions;
+    const auto partition = (minimum + functions - 1u) / functions;
+    cells_.resize(partition * functions, cell{ 0, 0, 0 });
+    set_seeds();
+}
+
+// The last seed is that of the key check sum.
+void iblt::set_seeds()
+{
+    seeds_.resize(hash_functions_ + 1u);
+
+    for (uint32_t function = 0; function < seeds_.size(); ++function)
+        seeds_[function] = function * seed_multiplier + seed_;
+}
+
+// Properties.
+//-----------------------------------------------------------------------------
+
+bool iblt::is_valid() const
+{
+    return hash_functions_ != 0 && hash_functions_ <= max_hash_functions &&
+        !cells_.empty() && cells_.size() % hash_functions_ == 0;
+}
+
+size_t iblt::cells() const
+{
+    return cells_.size();
+}
+
+uint8_t iblt::hash_functions() const
+{
+    return hash_functions_;
+}
+
+uint32_t iblt::seed() const
+{
+    return seed_;
+}
+
+bool iblt::is_compatible(const iblt& other) const
+{
+    return hash_functions_ == other.hash_functions_ && seed_ == other.seed_ &&
+        cells_.size() == other.cells_.size();
+}
+
+// Updates.
+//-----------------------------------------------------------------------------
+
+// Set the cell index of each hash function and return the key check sum.
+uint32_t iblt::hash(uint64_t key, size_t* out_indexes) const
+{
+    uint32_t hashes[max_hash_functions + 1];
+    const auto data = to_little_endian(key);
+    murmur3(data, seeds_.data(), hashes, seeds_.size());
+
+    const auto partition = cells_.size() / hash_functions_;
+
+    for (size_t function = 0; function < hash_functions_; ++function)
+        out_indexes[function] = function * partition +
+            hashes[function] % partition;
+
+    return hashes[hash_functions_];
+}
+
+void iblt::update(table& cells, const size_t* indexes, size_t count,
+    uint64_t key, uint32_t check, int32_t sign)
+{
+    for (size_t function = 0; function < count; ++function)
+    {
+        auto& cell = cells[indexes[function]];
+        cell.count += sign;
+        cell.key_sum ^= key;
+        cell.check_sum ^= check;
+    }
+}
+
+void iblt::insert(uint64_t key)
+{
+    if (!is_valid())
+        return;
+
+    size_t indexes[max_hash_functions];
+    const auto check = hash(key, indexes);
+    update(cells_, indexes, hash_functions_, key, check, 1);
+}
+
+void iblt::erase(uint64_t key)
+{
+    if (!is_valid())
+        return;
+
+    size_t indexes[max_hash_functions];
+    const auto check = hash(key, indexes);
+    update(cells_, indexes, hash_functions_, key, check, -1);
+}
+
+bool iblt::subtract(const iblt& other)
+{
+    if (!is_compatible(other))
+        return false;
+
+    for (size_t index = 0; index < cells_.size(); ++index)
+    {
+        auto& cell = cells_[index];
+        const auto& subtrahend = other.cells_[index];
+        cell.count -= subtrahend.count;
+        cell.key_sum ^= subtrahend.key_sum;
+        cell.check_sum ^= subtrahend.check_sum;
+    }
+
+    return true;
+}
+
+// Decoding.
+//-----------------------------------------------------------------------------
+
+bool iblt::is_empty(const cell& cell)
+{
+    return cell.count == 0 && cell.key_sum == 0 && cell.check_sum == 0;
+}
+
+// A cell of one key, as opposed to a sum of keys that cancel in count.
+bool iblt::is_pure(const cell& cell, uint32_t check)
+{
+    return (cell.count == 1 || cell.count == -1) && cell.check_sum == check;
+}
+
+// Each pure cell yields a key, the removal of which may expose more pure
+// cells. Pure cells are found by rescanning only the cells a key touched.
+bool iblt::decode(keys& out_inserted, keys& out_erased) const
+{
+    out_inserted.clear();
+    out_erased.clear();
+
+    if (!is_valid())
+        return false;
+
+    auto cells = cells_;
+    std::vector<size_t> pending(cells.size());
+
+    for (size_t index = 0; index < pending.size(); ++index)
+        pending[index] = index;
+
+    size_t indexes[max_hash_functions];
+
+    while (!pending.empty())
+    {
+        const auto& cell = cells[pending.back()];
+        pending.pop_back();
+
+        if (cell.count != 1 && cell.count != -1)
+            continue;
+
+        const auto key = cell.key_sum;
+        const auto check = hash(key, indexes);
+
+        if (!is_pure(cell, check))
+            continue;
+
+        // A hostile table could otherwise peel without end.
+        if (out_inserted.size() + out_erased.size() == cells.size())
+            return false;
+
+        const auto sign = cell.count;
+        (sign > 0 ? out_inserted : out_erased).push_back(key);
+        update(cells, indexes, hash_functions_, key, check, -sign);
+        pending.insert(pending.end(), indexes, indexes + hash_functions_);
+    }
+
+    return std::all_of(cells.begin(), cells.end(), is_empty);
+}
+
+// Serialization.
+//-----------------------------------------------------------------------------
+
+bool iblt::from_data(reader& source)
+{
+    const auto count = source.read_size_little_endian();
+    hash_functions_ = source.read_byte();
+    seed_ = source.read_4_bytes_little_endian();
+
+    // Guard against potential for arbitary memory allocation.
+    if (count > get_max_block_size() / cell_size)
+        source.invalidate();
+    else
+        cells_.resize(count);
+
+    for (auto& cell: cells_)
+    {
+        cell.count = static_cast<int32_t>(source.read_4_bytes_little_endian());
+        cell.key_sum = source.read_8_bytes_little_endian();
+        cell.check_sum = source.read_4_bytes_little_endian();
+    }
+
+    if (!is_valid())
+        source.invalidate();
+
+    if (!source)
+        *this = iblt();
+    else
+        set_seeds();
+
+    return source;
+}
+
+void iblt::to_data(writer& sink) const
+{
+    sink.write_variable_little_endian(cells_.size());
+    sink.write_byte(hash_functions_);
+    sink.write_4_bytes_little_endian(seed_);
+
+    for (const auto& cell: cells_)
+    {
+        sink.write_4_bytes_little_endian(static_cast<uint32_t>(cell.count));
+        sink.write_8_bytes_little_endian(cell.key_sum);
+        sink.write_4_bytes_little_endian(cell.check_sum);
+    }
+}
+
+size_t iblt::serialized_size() const
+{
+    return message::variable_uint_size(cells_.size()) + sizeof(uint8_t) +
+        sizeof(uint32_t) + cells_.size() * cell_size;
+}
+
+// Operators.
+//-----------------------------------------------------------------------------
+
+bool iblt::operator==(const iblt& other) const
+{
+    if (!is_compatible(other))
+        return false;
+
+    for (size_t index = 0; index < cells_.size(); ++index)
+    {
+        const auto& left = cells_[index];
+        const auto& right = other.cells_[index];
+
+        if (left.count != right.count || left.key_sum != right.key_sum ||
+            left.check_sum != right.check_sum)
+            return false;
+    }
+
+    return true;
+}
+
+bool iblt::operator!=(const iblt& other) const
+{
+    return !(*this == other);
+}
+
+} // namespace chain
+} // namespace libbitcoin
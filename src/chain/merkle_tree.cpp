@@ -0,0 +1,317 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/merkle_tree.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+// Node hashing.
+//-----------------------------------------------------------------------------
+
+// Hash a pair of nodes through a stack buffer rather than a data_chunk.
+static hash_digest combine(const hash_digest& left, const hash_digest& right)
+{
+    std::array<uint8_t, 2 * hash_size> pair;
+    std::copy(left.begin(), left.end(), pair.begin());
+    std::copy(right.begin(), right.end(), pair.begin() + hash_size);
+    return bitcoin_hash(pair);
+}
+
+// The number of nodes at the level of a tree with the given leaf count.
+static size_t level_width(size_t leaves, size_t level)
+{
+    return (leaves + (size_t(1) << level) - 1u) >> level;
+}
+
+static size_t tree_height(size_t leaves)
+{
+    size_t height = 0;
+
+    while (level_width(leaves, height) > 1u)
+        ++height;
+
+    return height;
+}
+
+// Constructors.
+//-----------------------------------------------------------------------------
+
+merkle_tree::merkle_tree(const hash_list& leaves)
+  : nodes_(leaves), leaves_(leaves.size())
+{
+    build();
+}
+
+merkle_tree::merkle_tree(hash_list&& leaves)
+  : nodes_(std::move(leaves)), leaves_(nodes_.size())
+{
+    build();
+}
+
+// Each level is appended to the one buffer, reserved for all levels.
+void merkle_tree::build()
+{
+    const auto height = tree_height(leaves_);
+    size_t total = 0;
+
+    for (size_t level = 0; level <= height; ++level)
+        total += level_width(leaves_, level);
+
+    nodes_.reserve(total);
+    offsets_.reserve(height + 1u);
+    offsets_.push_back(0);
+
+    for (size_t level = 1; level <= height; ++level)
+    {
+        const auto below = offsets_.back();
+        const auto count = level_width(leaves_, level - 1u);
+        offsets_.push_back(nodes_.size());
+
+        for (size_t position = 0; position < count; position += 2)
+        {
+            const auto right = std::min(position + 1u, count - 1u);
+            nodes_.push_back(combine(nodes_[below + position],
+                nodes_[below + right]));
+        }
+    }
+}
+
+// Properties.
+//-----------------------------------------------------------------------------
+
+size_t merkle_tree::size() const
+{
+    return leaves_;
+}
+
+hash_digest merkle_tree::root() const
+{
+    return nodes_.empty() ? null_hash : nodes_.back();
+}
+
+size_t merkle_tree::width(size_t level) const
+{
+    return level_width(leaves_, level);
+}
+
+const hash_digest& merkle_tree::node(size_t level, size_t position) const
+{
+    BITCOIN_ASSERT(position < width(level));
+    return nodes_[offsets_[level] + position];
+}
+
+// Branches.
+//-----------------------------------------------------------------------------
+
+hash_list merkle_tree::branch(size_t position) const
+{
+    hash_list out;
+
+    if (position >= leaves_)
+        return out;
+
+    const auto height = offsets_.size() - 1u;
+    out.reserve(height);
+
+    for (size_t level = 0; level < height; ++level, position >>= 1)
+    {
+        const auto sibling = std::min(position ^ 1u, width(level) - 1u);
+        out.push_back(node(level, sibling));
+    }
+
+    return out;
+}
+
+hash_digest merkle_tree::branch_root(const hash_digest& leaf,
+    const hash_list& branch, size_t position)
+{
+    auto hash = leaf;
+
+    for (const auto& sibling: branch)
+    {
+        hash = (position % 2 == 0) ? combine(hash, sibling) :
+            combine(sibling, hash);
+        position >>= 1;
+    }
+
+    return hash;
+}
+
+// Partial merkle trees (BIP37).
+//-----------------------------------------------------------------------------
+
+// Traversal is depth first. A flag is emitted for each node visited, set if
+// any leaf below the node matches. The hash of a node is emitted if it is a
+// leaf or has no matches below it, otherwise its children are visited.
+struct partial_reader
+{
+    const hash_list& hashes;
+    const data_chunk& flags;
+    const size_t total;
+    hash_list& matches;
+    merkle_tree::indexes& positions;
+    size_t bits;
+    size_t used;
+};
+
+static void push_flag(data_chunk& flags, size_t& bits, bool flag)
+{
+    if (bits % byte_bits == 0)
+        flags.push_back(0);
+
+    if (flag)
+        flags.back() |= (1u << (bits % byte_bits));
+
+    ++bits;
+}
+
+bool merkle_tree::partial(const matches& matched, hash_list& out_hashes,
+    data_chunk& out_flags) const
+{
+    out_hashes.clear();
+    out_flags.clear();
+
+    if (matched.size() != leaves_ || leaves_ == 0)
+        return false;
+
+    // Matches before each leaf position, so any subtree is tested in O(1).
+    indexes before(leaves_ + 1u, 0);
+
+    for (size_t leaf = 0; leaf < leaves_; ++leaf)
+        before[leaf + 1u] = before[leaf] + (matched[leaf] ? 1u : 0u);
+
+    size_t bits = 0;
+
+    // An explicit stack of (level, position), visiting left before right.
+    std::vector<std::pair<size_t, size_t>> pending;
+    pending.emplace_back(offsets_.size() - 1u, 0);
+
+    while (!pending.empty())
+    {
+        const auto level = pending.back().first;
+        const auto position = pending.back().second;
+        pending.pop_back();
+
+        const auto first = std::min(position << level, leaves_);
+        const auto last = std::min((position + 1u) << level, leaves_);
+        const auto parent_of_match = before[last] != before[first];
+        push_flag(out_flags, bits, parent_of_match);
+
+        if (level == 0 || !parent_of_match)
+        {
+            out_hashes.push_back(node(level, position));
+            continue;
+        }
+
+        const auto left = position * 2u;
+
+        if (left + 1u < width(level - 1u))
+            pending.emplace_back(level - 1u, left + 1u);
+
+        pending.emplace_back(level - 1u, left);
+    }
+
+    return true;
+}
+
+static bool extract_node(partial_reader& reader, size_t level,
+    size_t position, hash_digest& out)
+{
+    if (reader.bits >= reader.flags.size() * byte_bits)
+        return false;
+
+    const auto bit = reader.bits++;
+    const auto parent_of_match =
+        ((reader.flags[bit / byte_bits] >> (bit % byte_bits)) & 1u) != 0;
+
+    if (level == 0 || !parent_of_match)
+    {
+        if (reader.used >= reader.hashes.size())
+            return false;
+
+        out = reader.hashes[reader.used++];
+
+        if (level == 0 && parent_of_match)
+        {
+            reader.matches.push_back(out);
+            reader.positions.push_back(position);
+        }
+
+        return true;
+    }
+
+    hash_digest left;
+    hash_digest right;
+    const auto child = position * 2u;
+
+    if (!extract_node(reader, level - 1u, child, left))
+        return false;
+
+    if (child + 1u < level_width(reader.total, level - 1u))
+    {
+        if (!extract_node(reader, level - 1u, child + 1u, right))
+            return false;
+
+        // Identical siblings would allow a mutated tree (CVE-2012-2459).
+        if (right == left)
+            return false;
+    }
+    else
+    {
+        right = left;
+    }
+
+    out = combine(left, right);
+    return true;
+}
+
+bool merkle_tree::extract(size_t total, const hash_list& hashes,
+    const data_chunk& flags, hash_digest& out_root, hash_list& out_matches,
+    indexes& out_positions)
+{
+    out_matches.clear();
+    out_positions.clear();
+
+    // There can be no more hashes than leaves and one flag per hash.
+    if (total == 0 || hashes.size() > total ||
+        flags.size() * byte_bits < hashes.size())
+        return false;
+
+    partial_reader reader{ hashes, flags, total, out_matches, out_positions,
+        0, 0 };
+
+    if (!extract_node(reader, tree_height(total), 0, out_root))
+        return false;
+
+    // All hashes and all but the padding bits of the flags must be consumed.
+    return reader.used == hashes.size() &&
+        (reader.bits + byte_bits - 1u) / byte_bits == flags.size();
+}
+
+} // namespace chain
+} // namespace libbitcoin
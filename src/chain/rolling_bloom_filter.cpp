@@ -0,0 +1,156 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/rolling_bloom_filter.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/math/sip_hash.hpp>
+#include <bitcoin/bitcoin/utility/pseudo_random.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+const uint8_t rolling_bloom_filter::max_hash_functions = 50;
+
+// Three generations are retained, the fourth replaces the oldest.
+static const size_t generations = 3;
+
+// Constructors.
+//-----------------------------------------------------------------------------
+
+// Sized for three generations of half the elements (as the satoshi client).
+rolling_bloom_filter::rolling_bloom_filter(size_t elements,
+    double false_positive_rate)
+  : generation_entries_((elements + 1u) / 2u), entries_(0), generation_(1),
+    key0_(0), key1_(0)
+{
+    const auto log_rate = std::log(false_positive_rate);
+    const auto functions = std::round(log_rate / std::log(0.5));
+    hash_functions_ = static_cast<uint8_t>(std::max(std::min(functions,
+        double(max_hash_functions)), 1.0));
+
+    const double maximum = generation_entries_ * generations;
+    const auto bits = std::ceil(-1.0 * hash_functions_ * maximum /
+        std::log(1.0 - std::exp(log_rate / hash_functions_)));
+
+    // Each word of bits is a pair of words, one per bit of the generation.
+    const auto pairs = (static_cast<size_t>(bits) + 63u) / 64u;
+    data_.resize(std::max(pairs, size_t(1)) * 2u);
+    reset();
+}
+
+// Properties.
+//-----------------------------------------------------------------------------
+
+size_t rolling_bloom_filter::words() const
+{
+    return data_.size();
+}
+
+uint8_t rolling_bloom_filter::hash_functions() const
+{
+    return hash_functions_;
+}
+
+// Filter.
+//-----------------------------------------------------------------------------
+
+// One siphash per hash, split by double hashing. The low half of each value
+// selects the word pair and the high six bits select the bit.
+template <typename Action>
+bool rolling_bloom_filter::for_each_bit(const hash_digest& hash,
+    Action action) const
+{
+    const auto value = sip_hash_uint256(key0_, key1_, hash);
+    const auto step = (value >> 32) | (value << 32);
+    const uint64_t pairs = data_.size() / 2u;
+
+    for (uint64_t function = 0; function < hash_functions_; ++function)
+    {
+        const auto bits = value + function * step;
+        const auto pair = ((bits & 0xffffffff) * pairs) >> 32;
+        const auto bit = static_cast<uint32_t>(bits >> 58);
+
+        if (!action(static_cast<size_t>(pair * 2u), bit))
+            return false;
+    }
+
+    return true;
+}
+
+// A bit of a pair of zeros is unset, otherwise it holds its generation (1-3).
+// Clearing a generation unsets each bit that matches it.
+void rolling_bloom_filter::start_generation()
+{
+    entries_ = 0;
+    generation_ = generation_ == generations ? 1 : generation_ + 1;
+
+    const auto mask1 = uint64_t(0) - (generation_ & 1u);
+    const auto mask2 = uint64_t(0) - (generation_ >> 1);
+
+    for (size_t word = 0; word < data_.size(); word += 2)
+    {
+        const auto low = data_[word];
+        const auto high = data_[word + 1];
+        const auto keep = (low ^ mask1) | (high ^ mask2);
+        data_[word] = low & keep;
+        data_[word + 1] = high & keep;
+    }
+}
+
+void rolling_bloom_filter::insert(const hash_digest& hash)
+{
+    if (entries_ == generation_entries_)
+        start_generation();
+
+    ++entries_;
+    const uint64_t low = generation_ & 1u;
+    const uint64_t high = generation_ >> 1;
+
+    for_each_bit(hash, [this, low, high](size_t word, uint32_t bit)
+    {
+        const auto mask = ~(uint64_t(1) << bit);
+        data_[word] = (data_[word] & mask) | (low << bit);
+        data_[word + 1] = (data_[word + 1] & mask) | (high << bit);
+        return true;
+    });
+}
+
+bool rolling_bloom_filter::contains(const hash_digest& hash) const
+{
+    return for_each_bit(hash, [this](size_t word, uint32_t bit)
+    {
+        return (((data_[word] | data_[word + 1]) >> bit) & 1u) != 0;
+    });
+}
+
+void rolling_bloom_filter::reset()
+{
+    key0_ = pseudo_random::next();
+    key1_ = pseudo_random::next();
+    entries_ = 0;
+    generation_ = 1;
+    std::fill(data_.begin(), data_.end(), 0);
+}
+
+} // namespace chain
+} // namespace libbitcoin
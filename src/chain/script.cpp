@@ -25,8 +25,9 @@
 #include <memory>
 #include <numeric>
 #include <sstream>
+#include <unordered_set>
 #include <utility>
-#include <boost/range/adaptor/reversed.hpp>
+#include <boost/functional/hash.hpp>
 #include <bitcoin/bitcoin/constants.hpp>
 #include <bitcoin/bitcoin/chain/transaction.hpp>
 #include <bitcoin/bitcoin/chain/witness.hpp>
@@ -48,6 +49,7 @@
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 #include <bitcoin/bitcoin/utility/string.hpp>
@@ -57,7 +59,6 @@ namespace libbitcoin {
 namespace chain {
 
 using namespace bc::machine;
-using namespace boost::adaptors;
 
 // bit.ly/2cPazSa
 static const auto one_hash = hash_literal(
@@ -412,6 +413,11 @@ size_t script::serialized_size(bool prefix) const
     return size;
 }
 
+const data_chunk& script::bytes() const
+{
+    return bytes_;
+}
+
 // protected
 const operation::list& script::operations() const
 {
@@ -1290,47 +1296,122 @@ size_t script::sigops(bool accurate) const
 // The comparison and erase are not limited to a single operation and so can
 // erase arbitrary upstream data from the script.
 //*****************************************************************************
-void script::find_and_delete_(const data_chunk& endorsement)
+// Hash and compare raw byte ranges, so that ops may be probed in place.
+struct slice_hasher
 {
-    // If this is empty it would produce an empty script but not operation.
-    // So we test it for empty prior to operation reserialization.
-    if (endorsement.empty())
-        return;
+    size_t operator()(const data_slice& value) const
+    {
+        return boost::hash_range(value.begin(), value.end());
+    }
+};
 
-    // The value must be serialized to script using non-minimal encoding.
-    // Non-minimally-encoded target values will therefore not match.
-    const auto value = operation(endorsement, false).to_data();
+struct slice_equal
+{
+    bool operator()(const data_slice& left, const data_slice& right) const
+    {
+        return left.size() == right.size() &&
+            std::equal(left.begin(), left.end(), right.begin());
+    }
+};
 
-    operation op;
-    data_source stream(bytes_);
-    istream_reader source(stream);
-    std::vector<data_chunk::iterator> found;
+// Determine the serialized size of the op at position without parsing it.
+// Returns zero if the op is truncated (the op deserialization failure case).
+static size_t op_size(data_chunk::const_iterator it,
+    data_chunk::const_iterator end)
+{
+    BC_CONSTEXPR auto op_75 = static_cast<uint8_t>(opcode::push_size_75);
+    const auto remaining = static_cast<size_t>(std::distance(it, end));
+    const auto code = static_cast<opcode>(*it);
+    size_t prefix = 1;
+    size_t size = 0;
 
-    // The exhaustion test handles stream end and op deserialization failure.
-    for (auto it = bytes_.begin(); !source.is_exhausted();
-        it += source ? op.serialized_size() : 0)
+    switch (code)
     {
-        // Track all found values for later deletion.
-        for (; starts_with(it, bytes_.end(), value); it += value.size())
-        {
-            source.skip(value.size());
-            found.push_back(it);
-        }
-
-        // Read the next op code following last found value.
-        op.from_data(source);
+        case opcode::push_one_size:
+            prefix += sizeof(uint8_t);
+            if (remaining >= prefix)
+                size = it[1];
+            break;
+        case opcode::push_two_size:
+            prefix += sizeof(uint16_t);
+            if (remaining >= prefix)
+                size = from_little_endian_unsafe<uint16_t>(it + 1);
+            break;
+        case opcode::push_four_size:
+            prefix += sizeof(uint32_t);
+            if (remaining >= prefix)
+                size = from_little_endian_unsafe<uint32_t>(it + 1);
+            break;
+        default:
+            const auto byte = static_cast<uint8_t>(code);
+            size = byte <= op_75 ? byte : 0;
+            break;
     }
 
-    // Delete any found values, reversed to prevent iterator invalidation.
-    for (const auto it: reverse(found))
-        bytes_.erase(it, it + value.size());
+    return remaining < prefix || remaining - prefix < size ? 0 :
+        prefix + size;
 }
 
 // Concurrent read/write is not supported, so no critical section.
 void script::find_and_delete(const data_stack& endorsements)
 {
+    // The values must be serialized to script using non-minimal encoding.
+    // Non-minimally-encoded target values will therefore not match.
+    data_stack values;
+    values.reserve(endorsements.size());
+
+    // If empty it would produce an empty script but not operation, so skip.
     for (const auto& endorsement: endorsements)
-        find_and_delete_(endorsement);
+        if (!endorsement.empty())
+            values.push_back(operation(endorsement, false).to_data());
+
+    if (values.empty())
+        return;
+
+    size_t min_size = max_size_t;
+    size_t max_size = 0;
+    std::unordered_set<data_slice, slice_hasher, slice_equal> targets;
+    targets.reserve(values.size());
+
+    for (const auto& value: values)
+    {
+        min_size = std::min(min_size, value.size());
+        max_size = std::max(max_size, value.size());
+        targets.emplace(value);
+    }
+
+    // Values are whole push ops and match only at op boundaries, so deleting
+    // them all in one pass is equivalent to deleting them one after another.
+    const auto begin = bytes_.cbegin();
+    const auto end = bytes_.cend();
+    auto it = begin;
+    auto found = end;
+
+    for (size_t size; it != end && (size = op_size(it, end)) != 0; it += size)
+    {
+        if (size >= min_size && size <= max_size &&
+            targets.find({ &(*it), &(*it) + size }) != targets.end())
+        {
+            found = it;
+            break;
+        }
+    }
+
+    // Nothing found (by far the common case), retain bytes and ops cache.
+    if (found == end)
+        return;
+
+    // Compact the remaining ops in place, never moving a byte more than once.
+    auto to = bytes_.begin() + std::distance(begin, found);
+
+    for (size_t size; it != end && (size = op_size(it, end)) != 0; it += size)
+        if (size < min_size || size > max_size ||
+            targets.find({ &(*it), &(*it) + size }) == targets.end())
+            to = std::copy(it, it + size, to);
+
+    // A trailing truncated op is retained as is.
+    to = std::copy(it, end, to);
+    bytes_.erase(to, bytes_.end());
 
     // Invalidate the cache so that the operations may be regenerated.
     operations_.clear();
@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/stealth_filter.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/utility/binary.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+// The bits of a stealth prefix.
+static const size_t prefix_bits = 32;
+
+// Binary bits are ordered from the high bit of the first block, and a
+// prefix field is compared as its little endian bytes. So the bits of the
+// field are those of its byte reversal, read from the high bit.
+static uint32_t to_bits(uint32_t prefix)
+{
+    return from_big_endian_unsafe<uint32_t>(to_little_endian(prefix).begin());
+}
+
+static uint32_t shift(uint32_t bits, size_t length)
+{
+    return length == 0 ? 0 : bits >> (prefix_bits - length);
+}
+
+// A filter longer than the prefix compares the prefix padded with zeros, so
+// it matches only if its excess bits are zero.
+stealth_filter::stealth_filter(const list& filters)
+{
+    std::vector<values> by_length(prefix_bits + 1);
+
+    const auto nonzero = [](uint8_t block)
+    {
+        return block != 0;
+    };
+
+    for (const auto& filter: filters)
+    {
+        const auto& blocks = filter.blocks();
+        const auto length = std::min(filter.size(), prefix_bits);
+        const auto excess = blocks.begin() + std::min(blocks.size(),
+            sizeof(uint32_t));
+
+        if (std::any_of(excess, blocks.end(), nonzero))
+            continue;
+
+        byte_array<sizeof(uint32_t)> bytes{ { 0, 0, 0, 0 } };
+        std::copy(blocks.begin(), excess, bytes.begin());
+        const auto bits = from_big_endian_unsafe<uint32_t>(bytes.begin());
+        by_length[length].push_back(shift(bits, length));
+    }
+
+    for (size_t length = 0; length < by_length.size(); ++length)
+    {
+        auto& group = by_length[length];
+
+        if (group.empty())
+            continue;
+
+        std::sort(group.begin(), group.end());
+        group.erase(std::unique(group.begin(), group.end()), group.end());
+        lengths_.push_back(static_cast<uint8_t>(length));
+        values_.push_back(std::move(group));
+    }
+}
+
+bool stealth_filter::empty() const
+{
+    return lengths_.empty();
+}
+
+bool stealth_filter::matches(uint32_t prefix) const
+{
+    const auto bits = to_bits(prefix);
+
+    for (size_t group = 0; group < lengths_.size(); ++group)
+    {
+        const auto& values = values_[group];
+
+        if (std::binary_search(values.begin(), values.end(),
+            shift(bits, lengths_[group])))
+            return true;
+    }
+
+    return false;
+}
+
+} // namespace chain
+} // namespace libbitcoin
@@ -0,0 +1,220 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/stealth_rows.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/machine/opcode.hpp>
+#include <bitcoin/bitcoin/math/elliptic_curve.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+#include <bitcoin/bitcoin/wallet/payment_address.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+using namespace bc::machine;
+using namespace bc::wallet;
+
+// The data of a null data script of at least hash size (is_stealth_script).
+// The push must be minimal, so pushes over 75 bytes use push_one_size.
+static bool to_stealth_data(const data_chunk& script, const uint8_t*& out)
+{
+    static const auto op_return = static_cast<uint8_t>(opcode::return_);
+    static const auto op_76 = static_cast<uint8_t>(opcode::push_one_size);
+    static const auto op_75 = static_cast<uint8_t>(opcode::push_size_75);
+
+    if (script.size() < 2 || script[0] != op_return)
+        return false;
+
+    size_t start;
+    size_t size;
+
+    if (script[1] == op_76 && script.size() > 2 && script[2] > op_75)
+    {
+        start = 3;
+        size = script[2];
+    }
+    else if (script[1] <= op_75)
+    {
+        start = 2;
+        size = script[1];
+    }
+    else
+    {
+        return false;
+    }
+
+    if (size < hash_size || size > max_null_data_size ||
+        start + size != script.size())
+        return false;
+
+    out = script.data() + start;
+    return true;
+}
+
+// Rows.
+//-----------------------------------------------------------------------------
+
+void stealth_rows::reserve(size_t rows)
+{
+    transactions_.reserve(rows);
+    indexes_.reserve(rows);
+    prefixes_.reserve(rows);
+    ephemeral_keys_.reserve(rows);
+    public_key_hashes_.reserve(rows);
+    transaction_hashes_.reserve(rows);
+}
+
+void stealth_rows::clear()
+{
+    transactions_.clear();
+    indexes_.clear();
+    prefixes_.clear();
+    ephemeral_keys_.clear();
+    public_key_hashes_.clear();
+    transaction_hashes_.clear();
+}
+
+size_t stealth_rows::size() const
+{
+    return transactions_.size();
+}
+
+// Extraction.
+//-----------------------------------------------------------------------------
+
+void stealth_rows::extract(const block& block)
+{
+    clear();
+    const auto& txs = block.transactions();
+
+    for (uint32_t position = 0; position < txs.size(); ++position)
+        extract(txs[position], position);
+}
+
+// The payment output follows the stealth output, so the last is not tested.
+void stealth_rows::extract(const transaction& tx, uint32_t position)
+{
+    const auto& outputs = tx.outputs();
+
+    for (uint32_t index = 0; index + 1u < outputs.size(); ++index)
+    {
+        const auto& script = outputs[index].script().bytes();
+        const uint8_t* data;
+
+        if (!to_stealth_data(script, data))
+            continue;
+
+        const auto addresses = payment_address::extract_output(
+            outputs[index + 1u].script());
+
+        if (addresses.empty())
+            continue;
+
+        hash_digest key;
+        std::copy_n(data, hash_size, key.begin());
+        const auto hash = bitcoin_hash(script);
+
+        transactions_.push_back(position);
+        indexes_.push_back(index);
+        prefixes_.push_back(from_little_endian_unsafe<uint32_t>(hash.begin()));
+        ephemeral_keys_.push_back(key);
+        public_key_hashes_.push_back(addresses.front().hash());
+        transaction_hashes_.push_back(tx.hash());
+    }
+}
+
+// Matching.
+//-----------------------------------------------------------------------------
+
+stealth_rows::row_list stealth_rows::match(const stealth_filter& filter) const
+{
+    row_list out;
+
+    if (filter.empty())
+        return out;
+
+    for (size_t row = 0; row < prefixes_.size(); ++row)
+        if (filter.matches(prefixes_[row]))
+            out.push_back(row);
+
+    return out;
+}
+
+stealth_compact stealth_rows::to_compact(size_t row) const
+{
+    return
+    {
+        ephemeral_keys_[row],
+        public_key_hashes_[row],
+        transaction_hashes_[row]
+    };
+}
+
+// The sign of the ephemeral public key is even by convention.
+stealth stealth_rows::to_stealth(size_t row) const
+{
+    stealth out;
+    out.ephemeral_public_key[0] = ec_even_sign;
+    const auto& key = ephemeral_keys_[row];
+    std::copy_n(key.begin(), hash_size, out.ephemeral_public_key.begin() + 1);
+    out.public_key_hash = public_key_hashes_[row];
+    out.transaction_hash = transaction_hashes_[row];
+    return out;
+}
+
+// Columns.
+//-----------------------------------------------------------------------------
+
+const stealth_rows::position_column& stealth_rows::transactions() const
+{
+    return transactions_;
+}
+
+const stealth_rows::position_column& stealth_rows::indexes() const
+{
+    return indexes_;
+}
+
+const stealth_rows::prefix_column& stealth_rows::prefixes() const
+{
+    return prefixes_;
+}
+
+const stealth_rows::hash_column& stealth_rows::ephemeral_keys() const
+{
+    return ephemeral_keys_;
+}
+
+const stealth_rows::short_hash_column& stealth_rows::public_key_hashes() const
+{
+    return public_key_hashes_;
+}
+
+const stealth_rows::hash_column& stealth_rows::transaction_hashes() const
+{
+    return transaction_hashes_;
+}
+
+} // namespace chain
+} // namespace libbitcoin
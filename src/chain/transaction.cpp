@@ -122,6 +122,100 @@ inline void write_witnesses(writer& sink, const input::list& inputs)
     std::for_each(inputs.begin(), inputs.end(), serialize);
 }
 
+// Light parse.
+//-----------------------------------------------------------------------------
+
+// Read a length or count, adding its encoded size to the offset.
+static size_t read_size(reader& source, size_t& offset)
+{
+    offset += message::variable_prefix_size(source.peek_byte());
+    const auto size = source.read_size_little_endian();
+
+    // Guard against potential for arbitary memory allocation.
+    if (size <= get_max_block_size())
+        return size;
+
+    source.invalidate();
+    return 0;
+}
+
+static void read_inputs(reader& source, input::list& inputs,
+    transaction::parse fields, size_t& offset)
+{
+    inputs.resize(read_size(source, offset));
+    const auto points = (fields & transaction::parse_input_points) != 0;
+    const auto scripts = (fields & transaction::parse_input_scripts) != 0;
+
+    for (auto& input: inputs)
+    {
+        if (points)
+            input.previous_output().from_data(source, true);
+        else
+            source.skip(point::satoshi_fixed_size());
+
+        offset += point::satoshi_fixed_size();
+        const auto size = read_size(source, offset);
+
+        if (scripts)
+        {
+            input.set_script(script(source.read_bytes(size), false));
+            input.set_sequence(source.read_4_bytes_little_endian());
+        }
+        else
+        {
+            source.skip(size + sizeof(uint32_t));
+        }
+
+        offset += size + sizeof(uint32_t);
+
+        if (!source)
+            return;
+    }
+}
+
+static void read_outputs(reader& source, output::list& outputs,
+    transaction::parse fields, size_t& offset)
+{
+    outputs.resize(read_size(source, offset));
+    const auto values = (fields & transaction::parse_outputs) != 0;
+
+    for (auto& output: outputs)
+    {
+        if (values)
+            output.set_value(source.read_8_bytes_little_endian());
+        else
+            source.skip(sizeof(uint64_t));
+
+        offset += sizeof(uint64_t);
+        const auto size = read_size(source, offset);
+
+        if (values)
+            output.set_script(script(source.read_bytes(size), false));
+        else
+            source.skip(size);
+
+        offset += size;
+
+        if (!source)
+            return;
+    }
+}
+
+static void skip_witnesses(reader& source, size_t inputs, size_t& offset)
+{
+    for (size_t input = 0; input < inputs && source; ++input)
+    {
+        const auto items = read_size(source, offset);
+
+        for (size_t item = 0; item < items && source; ++item)
+        {
+            const auto size = read_size(source, offset);
+            source.skip(size);
+            offset += size;
+        }
+    }
+}
+
 // Constructors.
 //-----------------------------------------------------------------------------
 
@@ -132,17 +226,31 @@ transaction::transaction()
 
 transaction::transaction(transaction&& other)
   : transaction(other.version_, other.locktime_, std::move(other.inputs_),
-      std::move(other.outputs_))
+      std::move(other.outputs_), other.cached_sigops_, other.cached_fees_,
+      other.cached_is_standard_)
 {
     // TODO: implement safe private accessor for conditional cache transfer.
     validation = std::move(other.validation);
+    hash_ = std::move(other.hash_);
+    data_ = std::move(other.data_);
+    witness_data_ = std::move(other.witness_data_);
 }
 
+// The immutable wire serialization is shared with the copy.
 transaction::transaction(const transaction& other)
-  : transaction(other.version_, other.locktime_, other.inputs_, other.outputs_)
+  : transaction(other.version_, other.locktime_, other.inputs_, other.outputs_,
+      other.cached_sigops_, other.cached_fees_, other.cached_is_standard_)
 {
     // TODO: implement safe private accessor for conditional cache transfer.
     validation = other.validation;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    other.hash_mutex_.lock_shared();
+    data_ = other.data_;
+    witness_data_ = other.witness_data_;
+    other.hash_mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 transaction::transaction(transaction&& other, hash_digest&& hash)
@@ -196,7 +304,19 @@ transaction& transaction::operator=(transaction&& other)
     locktime_ = other.locktime_;
     inputs_ = std::move(other.inputs_);
     outputs_ = std::move(other.outputs_);
+    cached_fees_ = other.cached_fees_;
+    cached_sigops_ = other.cached_sigops_;
+    cached_is_standard_ = other.cached_is_standard_;
     validation = std::move(other.validation);
+
+    // The caches of the previous value no longer apply.
+    invalidate_cache();
+    outputs_hash_.reset();
+    inpoints_hash_.reset();
+    sequences_hash_.reset();
+    segregated_ = boost::none;
+    total_input_value_ = boost::none;
+    total_output_value_ = boost::none;
     return *this;
 }
 
@@ -207,7 +327,19 @@ transaction& transaction::operator=(const transaction& other)
     locktime_ = other.locktime_;
     inputs_ = other.inputs_;
     outputs_ = other.outputs_;
+    cached_fees_ = other.cached_fees_;
+    cached_sigops_ = other.cached_sigops_;
+    cached_is_standard_ = other.cached_is_standard_;
     validation = other.validation;
+
+    // The caches of the previous value no longer apply.
+    invalidate_cache();
+    outputs_hash_.reset();
+    inpoints_hash_.reset();
+    sequences_hash_.reset();
+    segregated_ = boost::none;
+    total_input_value_ = boost::none;
+    total_output_value_ = boost::none;
     return *this;
 }
 
@@ -271,7 +403,27 @@ bool transaction::from_data(const data_chunk& data, bool wire, bool witness, boo
     witness = false;
 #endif
     data_source istream(data);
-    return from_data(istream, wire, witness, unconfirmed);
+
+    if (!from_data(istream, wire, witness, unconfirmed))
+        return false;
+
+    // Witness handling must be disabled for non-segregated txs.
+    witness &= is_segregated();
+
+    // The data is captured unless it has trailing bytes or stripped witness.
+    if (wire && data.size() == serialized_size(true, witness))
+    {
+        const auto captured = std::make_shared<const data_chunk>(data);
+
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        hash_mutex_.lock();
+        (witness ? witness_data_ : data_) = captured;
+        hash_mutex_.unlock();
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    return true;
 }
 
 bool transaction::from_data(std::istream& stream, bool wire, bool witness, bool unconfirmed)
@@ -355,6 +507,87 @@ bool transaction::from_data(reader& source, bool wire, bool witness, bool unconf
     return source;
 }
 
+bool transaction::from_data(const data_chunk& data, parse fields,
+    offsets& out)
+{
+    data_source istream(data);
+    istream_reader source(istream);
+
+    if (!from_data(source, fields, out))
+        return false;
+
+    const auto hash = to_hash(data, out);
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    hash_mutex_.lock();
+    hash_ = std::make_shared<hash_digest>(hash);
+    hash_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return true;
+}
+
+// The serialization without witness is contiguous unless segregated.
+hash_digest transaction::to_hash(const data_chunk& data, const offsets& at)
+{
+    const auto begin = data.data();
+    const auto version = at.transaction + sizeof(uint32_t);
+    const auto end = at.locktime + sizeof(uint32_t);
+
+    if (at.inputs == version && at.witnesses == at.locktime)
+        return bitcoin_hash({ begin + at.transaction, begin + end });
+
+    data_chunk stripped;
+    stripped.reserve(end - at.transaction);
+    stripped.insert(stripped.end(), begin + at.transaction, begin + version);
+    stripped.insert(stripped.end(), begin + at.inputs, begin + at.witnesses);
+    stripped.insert(stripped.end(), begin + at.locktime, begin + end);
+    return bitcoin_hash(stripped);
+}
+
+// Offsets are counted as read, as the reader does not expose its position.
+bool transaction::from_data(reader& source, parse fields, offsets& out)
+{
+    reset();
+    size_t offset = 0;
+    out.transaction = offset;
+    version_ = source.read_4_bytes_little_endian();
+    offset += sizeof(uint32_t);
+    out.inputs = offset;
+    read_inputs(source, inputs_, fields, offset);
+
+#ifdef BITPRIM_CURRENCY_BCH
+    const auto marker = false;
+#else
+    const auto marker = inputs_.size() == witness_marker && source &&
+        source.peek_byte() == witness_flag;
+#endif
+
+    if (marker)
+    {
+        source.skip(1);
+        offset += 1;
+        out.inputs = offset;
+        read_inputs(source, inputs_, fields, offset);
+    }
+
+    out.outputs = offset;
+    read_outputs(source, outputs_, fields, offset);
+    out.witnesses = offset;
+
+    if (marker)
+        skip_witnesses(source, inputs_.size(), offset);
+
+    out.locktime = offset;
+    locktime_ = source.read_4_bytes_little_endian();
+
+    if (!source)
+        reset();
+
+    return source;
+}
+
 // protected
 void transaction::reset()
 {
@@ -418,7 +651,7 @@ void transaction::to_data(std::ostream& stream, bool wire, bool witness, bool un
     to_data(sink, wire, witness, unconfirmed);
 }
 
-// Witness is not used by outputs, just for template normalization.
+// The cached wire serialization is written if present.
 void transaction::to_data(writer& sink, bool wire, bool witness, bool unconfirmed) const
 {
 #ifdef BITPRIM_CURRENCY_BCH
@@ -429,6 +662,35 @@ void transaction::to_data(writer& sink, bool wire, bool witness, bool unconfirme
         // Witness handling must be disabled for non-segregated txs.
         witness &= is_segregated();
 
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        hash_mutex_.lock_shared();
+        const auto cached = witness ? witness_data_ : data_;
+        hash_mutex_.unlock_shared();
+        ///////////////////////////////////////////////////////////////////////
+
+        if (cached)
+        {
+            sink.write_bytes(*cached);
+            return;
+        }
+    }
+
+    write_data(sink, wire, witness, unconfirmed);
+}
+
+// Witness is not used by outputs, just for template normalization.
+void transaction::write_data(writer& sink, bool wire, bool witness,
+    bool unconfirmed) const
+{
+#ifdef BITPRIM_CURRENCY_BCH
+    witness = false;
+#endif
+    if (wire)
+    {
+        // Witness handling must be disabled for non-segregated txs.
+        witness &= is_segregated();
+
         // Wire (satoshi protocol) serialization.
         sink.write_4_bytes_little_endian(version_);
 
@@ -463,9 +725,47 @@ void transaction::to_data(writer& sink, bool wire, bool witness, bool unconfirme
             sink.write_byte(is_standard());
         }
     }
+}
 
+// Serialize without reference to the cache, which may be locked by caller.
+data_chunk transaction::to_uncached_data(bool witness) const
+{
+    data_chunk data;
+    data.reserve(serialized_size(true, witness));
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    write_data(sink, true, witness, false);
+    ostream.flush();
+    return data;
+}
+
+transaction::data_const_ptr transaction::wire_data(bool witness) const
+{
+#ifdef BITPRIM_CURRENCY_BCH
+    witness = false;
+#endif
+    // Witness handling must be disabled for non-segregated txs.
+    witness &= is_segregated();
 
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    hash_mutex_.lock_upgrade();
+    auto& data = witness ? witness_data_ : data_;
 
+    if (!data)
+    {
+        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        hash_mutex_.unlock_upgrade_and_lock();
+        data = std::make_shared<const data_chunk>(to_uncached_data(witness));
+        hash_mutex_.unlock_and_lock_upgrade();
+        //---------------------------------------------------------------------
+    }
+
+    const auto out = data;
+    hash_mutex_.unlock_upgrade();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return out;
 }
 
 // Size.
@@ -528,8 +828,10 @@ void transaction::set_locktime(uint32_t value)
     invalidate_cache();
 }
 
+// The wire serialization may be shared, so mutable access detaches it.
 input::list& transaction::inputs()
 {
+    invalidate_data();
     return inputs_;
 }
 
@@ -558,6 +860,7 @@ void transaction::set_inputs(input::list&& value)
 
 output::list& transaction::outputs()
 {
+    invalidate_data();
     return outputs_;
 }
 
@@ -606,12 +909,35 @@ void transaction::invalidate_cache() const
     // Critical Section
     hash_mutex_.lock_upgrade();
 
-    if (hash_ || witness_hash_)
+    if (hash_ || witness_hash_ || data_ || witness_data_)
     {
         hash_mutex_.unlock_upgrade_and_lock();
         //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
         hash_.reset();
         witness_hash_.reset();
+        data_.reset();
+        witness_data_.reset();
+        //---------------------------------------------------------------------
+        hash_mutex_.unlock_and_lock_upgrade();
+    }
+
+    hash_mutex_.unlock_upgrade();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+void transaction::invalidate_data() const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    hash_mutex_.lock_upgrade();
+
+    if (data_ || witness_data_)
+    {
+        hash_mutex_.unlock_upgrade_and_lock();
+        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        data_.reset();
+        witness_data_.reset();
         //---------------------------------------------------------------------
         hash_mutex_.unlock_and_lock_upgrade();
     }
@@ -641,7 +967,8 @@ hash_digest transaction::hash(bool witness) const
 
             // Witness coinbase tx hash is assumed to be null_hash (bip141).
             witness_hash_ = std::make_shared<hash_digest>(
-                is_coinbase() ? null_hash : bitcoin_hash(to_data(true, true)));
+                is_coinbase() ? null_hash : bitcoin_hash(witness_data_ ?
+                    *witness_data_ : to_uncached_data(true)));
 
             hash_mutex_.unlock_and_lock_upgrade();
             //-----------------------------------------------------------------
@@ -653,7 +980,8 @@ hash_digest transaction::hash(bool witness) const
         {
             //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
             hash_mutex_.unlock_upgrade_and_lock();
-            hash_ = std::make_shared<hash_digest>(bitcoin_hash(to_data(true)));
+            hash_ = std::make_shared<hash_digest>(bitcoin_hash(data_ ?
+                *data_ : to_uncached_data(false)));
             hash_mutex_.unlock_and_lock_upgrade();
             //-----------------------------------------------------------------
         }
@@ -0,0 +1,305 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/utxo_commitment.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/container_sink.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+#include <bitcoin/bitcoin/utility/ostream_writer.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+// The modulus is 2^3072 - prime_difference, held as 96 little endian limbs.
+static BC_CONSTEXPR size_t limbs = 96;
+static BC_CONSTEXPR size_t number_size = limbs * sizeof(uint32_t);
+static BC_CONSTEXPR uint32_t prime_difference = 1103717;
+
+typedef std::array<uint32_t, limbs> num3072;
+typedef std::array<uint32_t, 2 * limbs> num6144;
+
+// ChaCha20 (keystream only, zero nonce).
+//-----------------------------------------------------------------------------
+
+static BC_CONSTEXPR size_t chacha_block_size = 64;
+
+static inline uint32_t rotate(uint32_t value, size_t bits)
+{
+    return (value << bits) | (value >> (32 - bits));
+}
+
+static inline void quarter_round(uint32_t* x, size_t a, size_t b, size_t c,
+    size_t d)
+{
+    x[a] += x[b]; x[d] = rotate(x[d] ^ x[a], 16);
+    x[c] += x[d]; x[b] = rotate(x[b] ^ x[c], 12);
+    x[a] += x[b]; x[d] = rotate(x[d] ^ x[a], 8);
+    x[c] += x[d]; x[b] = rotate(x[b] ^ x[c], 7);
+}
+
+static void chacha20_keystream(uint8_t* out, size_t blocks,
+    const hash_digest& key)
+{
+    uint32_t input[16] =
+    {
+        0x61707865, 0x3320646e, 0x79622d32, 0x6b206574
+    };
+
+    for (size_t word = 0; word < 8; ++word)
+        input[4 + word] = from_little_endian_unsafe<uint32_t>(
+            key.begin() + word * sizeof(uint32_t));
+
+    for (size_t block = 0; block < blocks; ++block)
+    {
+        // Block counter in words 12-13, zero nonce in words 14-15.
+        input[12] = static_cast<uint32_t>(block);
+
+        uint32_t x[16];
+        std::copy_n(input, 16, x);
+
+        for (size_t round = 0; round < 10; ++round)
+        {
+            quarter_round(x, 0, 4, 8, 12);
+            quarter_round(x, 1, 5, 9, 13);
+            quarter_round(x, 2, 6, 10, 14);
+            quarter_round(x, 3, 7, 11, 15);
+            quarter_round(x, 0, 5, 10, 15);
+            quarter_round(x, 1, 6, 11, 12);
+            quarter_round(x, 2, 7, 8, 13);
+            quarter_round(x, 3, 4, 9, 14);
+        }
+
+        for (size_t word = 0; word < 16; ++word)
+        {
+            const auto bytes = to_little_endian(x[word] + input[word]);
+            std::copy(bytes.begin(), bytes.end(),
+                out + block * chacha_block_size + word * sizeof(uint32_t));
+        }
+    }
+}
+
+// Arithmetic modulo 2^3072 - prime_difference.
+//-----------------------------------------------------------------------------
+
+static num3072 one()
+{
+    num3072 out{};
+    out[0] = 1;
+    return out;
+}
+
+static num3072 from_bytes(const uint8_t* data)
+{
+    num3072 out;
+    for (size_t limb = 0; limb < limbs; ++limb)
+        out[limb] = from_little_endian_unsafe<uint32_t>(
+            data + limb * sizeof(uint32_t));
+
+    return out;
+}
+
+static void to_bytes(uint8_t* out, const num3072& value)
+{
+    for (size_t limb = 0; limb < limbs; ++limb)
+    {
+        const auto bytes = to_little_endian(value[limb]);
+        std::copy(bytes.begin(), bytes.end(), out + limb * sizeof(uint32_t));
+    }
+}
+
+// Add value * 2^(32 * limb) into the number, returning the carry out.
+static uint64_t add_at(num3072& number, size_t limb, uint64_t value)
+{
+    for (; value != 0 && limb < limbs; ++limb)
+    {
+        value += number[limb];
+        number[limb] = static_cast<uint32_t>(value);
+        value >>= 32;
+    }
+
+    return value;
+}
+
+// Reduce the double width product, using 2^3072 = prime_difference (mod p).
+static num3072 reduce(const num6144& product)
+{
+    num3072 out;
+    uint64_t carry = 0;
+
+    for (size_t limb = 0; limb < limbs; ++limb)
+    {
+        carry += product[limb] +
+            static_cast<uint64_t>(product[limb + limbs]) * prime_difference;
+        out[limb] = static_cast<uint32_t>(carry);
+        carry >>= 32;
+    }
+
+    // Fold the overflow until there is none.
+    while (carry != 0)
+        carry = add_at(out, 0, carry * prime_difference);
+
+    // Subtract the modulus if the value is at least the modulus, which is
+    // the case exactly when adding prime_difference overflows 2^3072.
+    auto reduced = out;
+    if (add_at(reduced, 0, prime_difference) != 0)
+        out = reduced;
+
+    return out;
+}
+
+static num3072 multiply(const num3072& left, const num3072& right)
+{
+    num6144 product{};
+
+    for (size_t i = 0; i < limbs; ++i)
+    {
+        uint64_t carry = 0;
+
+        for (size_t j = 0; j < limbs; ++j)
+        {
+            carry += product[i + j] +
+                static_cast<uint64_t>(left[i]) * right[j];
+            product[i + j] = static_cast<uint32_t>(carry);
+            carry >>= 32;
+        }
+
+        product[i + limbs] = static_cast<uint32_t>(carry);
+    }
+
+    return reduce(product);
+}
+
+// Fermat inversion, value^(p - 2). The exponent is all ones except for the
+// low limb, which is max_uint32 - (prime_difference + 1).
+static num3072 inverse(const num3072& value)
+{
+    auto out = one();
+    const uint32_t low = max_uint32 - (prime_difference + 1);
+
+    for (size_t bit = limbs * 32; bit-- > 0;)
+    {
+        out = multiply(out, out);
+
+        const auto limb = bit / 32;
+        const auto word = limb == 0 ? low : max_uint32;
+
+        if (((word >> (bit % 32)) & 1) != 0)
+            out = multiply(out, value);
+    }
+
+    return out;
+}
+
+// The element is hashed and expanded to 384 bytes with ChaCha20.
+static num3072 to_number(data_slice element)
+{
+    uint8_t stream[number_size];
+    chacha20_keystream(stream, number_size / chacha_block_size,
+        sha256_hash(element));
+    return from_bytes(stream);
+}
+
+// utxo_commitment
+//-----------------------------------------------------------------------------
+
+// static
+data_chunk utxo_commitment::to_element(const output_point& point,
+    const output& output, size_t height, bool coinbase)
+{
+    BITCOIN_ASSERT(height <= (max_uint32 >> 1));
+    const auto code = (static_cast<uint32_t>(height) << 1) |
+        (coinbase ? 1u : 0u);
+
+    data_chunk data;
+    data.reserve(point.serialized_size(true) + sizeof(uint32_t) +
+        output.serialized_size(true));
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    point.to_data(sink, true);
+    sink.write_4_bytes_little_endian(code);
+    output.to_data(sink, true);
+    ostream.flush();
+    return data;
+}
+
+utxo_commitment::utxo_commitment()
+  : numerator_(one()), denominator_(one())
+{
+}
+
+void utxo_commitment::add(const output_point& point, const output& output,
+    size_t height, bool coinbase)
+{
+    add(to_element(point, output, height, coinbase));
+}
+
+void utxo_commitment::remove(const output_point& point, const output& output,
+    size_t height, bool coinbase)
+{
+    remove(to_element(point, output, height, coinbase));
+}
+
+void utxo_commitment::add(data_slice element)
+{
+    numerator_ = multiply(numerator_, to_number(element));
+}
+
+void utxo_commitment::remove(data_slice element)
+{
+    denominator_ = multiply(denominator_, to_number(element));
+}
+
+void utxo_commitment::combine(const utxo_commitment& other)
+{
+    numerator_ = multiply(numerator_, other.numerator_);
+    denominator_ = multiply(denominator_, other.denominator_);
+}
+
+hash_digest utxo_commitment::hash() const
+{
+    uint8_t data[number_size];
+    to_bytes(data, multiply(numerator_, inverse(denominator_)));
+    return sha256_hash({ data, data + number_size });
+}
+
+data_chunk utxo_commitment::to_data() const
+{
+    data_chunk out(2 * number_size);
+    to_bytes(out.data(), numerator_);
+    to_bytes(out.data() + number_size, denominator_);
+    return out;
+}
+
+bool utxo_commitment::from_data(const data_chunk& data)
+{
+    if (data.size() != 2 * number_size)
+        return false;
+
+    numerator_ = from_bytes(data.data());
+    denominator_ = from_bytes(data.data() + number_size);
+    return true;
+}
+
+} // namespace chain
+} // namespace libbitcoin
@@ -0,0 +1,303 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/utxo_snapshot.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <bitcoin/bitcoin/chain/compression.hpp>
+#include <bitcoin/bitcoin/chain/utxo_commitment.hpp>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/container_sink.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
+#include <bitcoin/bitcoin/utility/istream_reader.hpp>
+#include <bitcoin/bitcoin/utility/ostream_writer.hpp>
+#include <bitcoin/bitcoin/utility/thread.hpp>
+#include <bitcoin/bitcoin/utility/threadpool.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+// "utxo" as a little endian integer.
+static BC_CONSTEXPR uint32_t snapshot_magic = 0x6f787475;
+static BC_CONSTEXPR uint32_t snapshot_version = 1;
+
+// The writer closes a chunk once its payload reaches the target size, so a
+// payload exceeds it by at most one entry (bounded by the block size), but
+// an entry that would exceed the maximum is deferred to the next chunk.
+static BC_CONSTEXPR size_t default_chunk_size = 1024 * 1024;
+static BC_CONSTEXPR size_t max_chunk_size = 64 * 1024 * 1024;
+
+// Point, height/coinbase, amount and script type, each at their smallest.
+static BC_CONSTEXPR size_t min_entry_size = 36 + 1 + 1 + 1;
+
+// Chunks in flight per load thread.
+static BC_CONSTEXPR size_t load_depth = 2;
+
+static bool parse_chunk(const data_chunk& payload, uint32_t count,
+    unspent_output::list& out)
+{
+    // Bound the allocation by the payload before trusting the count.
+    if (count > payload.size() / min_entry_size)
+        return false;
+
+    auto source = make_safe_deserializer(payload.begin(), payload.end());
+    out.resize(count);
+
+    for (auto& entry: out)
+    {
+        entry.point.from_data(source, true);
+        const auto code = source.read_variable_little_endian();
+
+        if (!source || !from_compressed_data(source, entry.output) ||
+            (code >> 1) > max_uint32)
+            return false;
+
+        entry.height = static_cast<size_t>(code >> 1);
+        entry.coinbase = (code & 1) != 0;
+    }
+
+    // Trailing bytes indicate a count mismatch.
+    return source && source.is_exhausted();
+}
+
+// utxo_snapshot_writer
+//-----------------------------------------------------------------------------
+
+utxo_snapshot_writer::utxo_snapshot_writer(std::ostream& stream,
+    const utxo_snapshot_header& header, size_t chunk_size)
+  : stream_(stream),
+    chunk_size_(chunk_size == 0 ? default_chunk_size :
+        std::min(chunk_size, max_chunk_size)),
+    count_(0)
+{
+    BITCOIN_ASSERT(header.height <= max_uint32);
+    ostream_writer sink(stream_);
+    sink.write_4_bytes_little_endian(snapshot_magic);
+    sink.write_4_bytes_little_endian(snapshot_version);
+    sink.write_hash(header.block_hash);
+    sink.write_4_bytes_little_endian(static_cast<uint32_t>(header.height));
+    sink.write_hash(header.commitment);
+}
+
+bool utxo_snapshot_writer::write(const unspent_output& entry)
+{
+    BITCOIN_ASSERT(entry.height <= max_uint32);
+    const auto code = (static_cast<uint64_t>(entry.height) << 1) |
+        (entry.coinbase ? 1u : 0u);
+
+    const auto start = payload_.size();
+    data_sink ostream(payload_);
+    ostream_writer sink(ostream);
+    entry.point.to_data(sink, true);
+    sink.write_variable_little_endian(code);
+    to_compressed_data(sink, entry.output);
+    ostream.flush();
+
+    // An entry that would take the payload over the limit starts a chunk.
+    if (count_ != 0 && payload_.size() > max_chunk_size)
+    {
+        data_chunk next(payload_.begin() + start, payload_.end());
+        payload_.resize(start);
+        write_chunk();
+        payload_ = std::move(next);
+    }
+
+    ++count_;
+
+    if (payload_.size() >= chunk_size_ || count_ == max_uint32)
+        write_chunk();
+
+    return stream_.good();
+}
+
+bool utxo_snapshot_writer::flush()
+{
+    if (count_ != 0)
+        write_chunk();
+
+    // The terminating chunk.
+    write_chunk();
+    stream_.flush();
+    return stream_.good();
+}
+
+void utxo_snapshot_writer::write_chunk()
+{
+    ostream_writer sink(stream_);
+    sink.write_4_bytes_little_endian(count_);
+    sink.write_4_bytes_little_endian(static_cast<uint32_t>(payload_.size()));
+    sink.write_hash(sha256_hash(payload_));
+    sink.write_bytes(payload_);
+    payload_.clear();
+    count_ = 0;
+}
+
+// utxo_snapshot_reader
+//-----------------------------------------------------------------------------
+
+utxo_snapshot_reader::utxo_snapshot_reader(std::istream& stream)
+  : stream_(stream), header_{ null_hash, 0, null_hash }, header_read_(false)
+{
+}
+
+bool utxo_snapshot_reader::read_header()
+{
+    istream_reader source(stream_);
+    const auto magic = source.read_4_bytes_little_endian();
+    const auto version = source.read_4_bytes_little_endian();
+    header_.block_hash = source.read_hash();
+    header_.height = source.read_4_bytes_little_endian();
+    header_.commitment = source.read_hash();
+
+    header_read_ = source && magic == snapshot_magic &&
+        version == snapshot_version;
+    return header_read_;
+}
+
+const utxo_snapshot_header& utxo_snapshot_reader::header() const
+{
+    return header_;
+}
+
+// Chunks are read serially, since the stream is sequential, and the reader
+// waits while the number of unprocessed chunks is at capacity.
+code utxo_snapshot_reader::load(chunk_handler handler, size_t threads)
+{
+    if (!header_read_ && !read_header())
+        return error::bad_stream;
+
+    typedef std::shared_ptr<data_chunk> payload_ptr;
+    const auto count_threads = thread_default(threads);
+    const auto capacity = load_depth * count_threads;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t in_flight = 0;
+    code result = error::success;
+    utxo_commitment total;
+
+    const auto process = [&](size_t index, uint32_t count,
+        const hash_digest& checksum, payload_ptr payload)
+    {
+        code ec = error::success;
+        unspent_output::list entries;
+        utxo_commitment partial;
+
+        if (sha256_hash(*payload) != checksum)
+            ec = error::store_snapshot_corrupt;
+        else if (!parse_chunk(*payload, count, entries))
+            ec = error::bad_stream;
+
+        payload.reset();
+
+        if (!ec)
+            for (const auto& entry: entries)
+                partial.add(entry.point, entry.output, entry.height,
+                    entry.coinbase);
+
+        if (!ec && !handler(index, std::move(entries)))
+            ec = error::service_stopped;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (!ec)
+            total.combine(partial);
+        else if (!result)
+            result = ec;
+
+        --in_flight;
+        changed.notify_all();
+    };
+
+    threadpool pool(count_threads);
+    istream_reader source(stream_);
+    auto terminated = false;
+
+    for (size_t index = 0; !terminated; ++index)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&]()
+            {
+                return result || in_flight < capacity;
+            });
+
+            if (result)
+                break;
+        }
+
+        const auto count = source.read_4_bytes_little_endian();
+        const auto size = source.read_4_bytes_little_endian();
+        const auto checksum = source.read_hash();
+        terminated = source && count == 0 && size == 0;
+
+        if (terminated)
+            break;
+
+        payload_ptr payload;
+
+        if (source && count != 0 && size <= max_chunk_size)
+            payload = std::make_shared<data_chunk>(source.read_bytes(size));
+
+        if (!source || !payload)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            result = error::bad_stream;
+            break;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++in_flight;
+        }
+
+        pool.service().post(std::bind(process, index, count, checksum,
+            payload));
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&]()
+        {
+            return in_flight == 0;
+        });
+    }
+
+    pool.shutdown();
+    pool.join();
+
+    if (result)
+        return result;
+
+    if (!terminated)
+        return error::bad_stream;
+
+    return total.hash() == header_.commitment ? error::success :
+        error::store_snapshot_mismatch;
+}
+
+} // namespace chain
+} // namespace libbitcoin
@@ -77,6 +77,8 @@ std::string error_category_impl::message(int ev) const BC_NOEXCEPT
         { error::store_block_invalid_height, "block out of order" },
         { error::store_block_missing_parent, "block missing parent" },
         { error::store_block_duplicate, "block duplicate" },
+        { error::store_snapshot_corrupt, "snapshot chunk hash mismatch" },
+        { error::store_snapshot_mismatch, "snapshot set commitment mismatch" },
 
         // blockchain
         { error::duplicate_block, "duplicate block" },
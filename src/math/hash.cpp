@@ -172,4 +172,80 @@ data_chunk scrypt(data_slice data, data_slice salt, uint64_t N, uint32_t p,
     return output;
 }
 
+static inline uint32_t rotate_left(uint32_t value, uint8_t shift)
+{
+    return (value << shift) | (value >> (32 - shift));
+}
+
+static inline uint32_t murmur3_block(uint32_t hash, uint32_t block)
+{
+    static const uint32_t c1 = 0xcc9e2d51;
+    static const uint32_t c2 = 0x1b873593;
+
+    block *= c1;
+    block = rotate_left(block, 15);
+    block *= c2;
+    return hash ^ block;
+}
+
+static inline uint32_t murmur3_final(uint32_t hash, size_t size)
+{
+    hash ^= static_cast<uint32_t>(size);
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+uint32_t murmur3(data_slice data, uint32_t seed)
+{
+    uint32_t hash;
+    murmur3(data, &seed, &hash, 1);
+    return hash;
+}
+
+// Each four byte block is read once and mixed into every seed's state.
+void murmur3(data_slice data, const uint32_t* seeds, uint32_t* out,
+    size_t count)
+{
+    const auto size = data.size();
+    const auto blocks = size / 4;
+    const auto bytes = data.data();
+
+    std::copy(seeds, seeds + count, out);
+
+    for (size_t index = 0; index < blocks; ++index)
+    {
+        const auto byte = bytes + index * 4;
+        const uint32_t block = byte[0] | (byte[1] << 8) | (byte[2] << 16) |
+            (static_cast<uint32_t>(byte[3]) << 24);
+
+        for (size_t seed = 0; seed < count; ++seed)
+            out[seed] = rotate_left(murmur3_block(out[seed], block), 13) * 5 +
+                0xe6546b64;
+    }
+
+    const auto tail = bytes + blocks * 4;
+    uint32_t block = 0;
+
+    switch (size % 4)
+    {
+        case 3:
+            block ^= tail[2] << 16;
+            // fall through
+        case 2:
+            block ^= tail[1] << 8;
+            // fall through
+        case 1:
+            block ^= tail[0];
+            for (size_t seed = 0; seed < count; ++seed)
+                out[seed] = murmur3_block(out[seed], block);
+    }
+
+    for (size_t seed = 0; seed < count; ++seed)
+        out[seed] = murmur3_final(out[seed], size);
+}
+
 } // namespace libbitcoin
@@ -0,0 +1,319 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/math/uint256.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace libbitcoin {
+
+// 64 x 64 -> 128 bit multiply and 128 / 64 bit divide.
+// ----------------------------------------------------------------------------
+
+#ifdef __SIZEOF_INT128__
+
+__extension__ typedef unsigned __int128 uint128;
+
+// Returns the low half of left * right + addend + carry, high half in carry.
+static inline uint64_t multiply_add(uint64_t left, uint64_t right,
+    uint64_t addend, uint64_t& carry)
+{
+    const auto product = static_cast<uint128>(left) * right + addend + carry;
+    carry = static_cast<uint64_t>(product >> 64);
+    return static_cast<uint64_t>(product);
+}
+
+// Divides (high:low) by divisor, where high < divisor.
+static inline uint64_t divide_wide(uint64_t high, uint64_t low,
+    uint64_t divisor, uint64_t& remainder)
+{
+    const auto dividend = (static_cast<uint128>(high) << 64) | low;
+    remainder = static_cast<uint64_t>(dividend % divisor);
+    return static_cast<uint64_t>(dividend / divisor);
+}
+
+#else
+
+static inline uint64_t multiply_add(uint64_t left, uint64_t right,
+    uint64_t addend, uint64_t& carry)
+{
+    const uint64_t mask = 0xffffffff;
+    const auto left_low = left & mask;
+    const auto left_high = left >> 32;
+    const auto right_low = right & mask;
+    const auto right_high = right >> 32;
+
+    const auto low_low = left_low * right_low;
+    const auto high_low = left_high * right_low;
+    const auto low_high = left_low * right_high;
+    const auto high_high = left_high * right_high;
+
+    const auto middle = (low_low >> 32) + (high_low & mask) + low_high;
+    auto high = high_high + (high_low >> 32) + (middle >> 32);
+    auto low = (middle << 32) | (low_low & mask);
+
+    low += addend;
+    high += low < addend ? 1 : 0;
+    low += carry;
+    high += low < carry ? 1 : 0;
+    carry = high;
+    return low;
+}
+
+// Restoring division by bit, where high < divisor.
+static inline uint64_t divide_wide(uint64_t high, uint64_t low,
+    uint64_t divisor, uint64_t& remainder)
+{
+    uint64_t quotient = 0;
+
+    for (size_t bit = 0; bit < 64; ++bit)
+    {
+        const auto overflow = (high >> 63) != 0;
+        high = (high << 1) | (low >> 63);
+        low <<= 1;
+        quotient <<= 1;
+
+        if (overflow || high >= divisor)
+        {
+            high -= divisor;
+            quotient |= 1;
+        }
+    }
+
+    remainder = high;
+    return quotient;
+}
+
+#endif
+
+// Constructors.
+// ----------------------------------------------------------------------------
+
+uint256_t::uint256_t(const std::array<uint8_t, 32>& little_endian)
+  : uint256_t()
+{
+    for (size_t index = 0; index < 32; ++index)
+        limbs_[index / 8] |= static_cast<uint64_t>(little_endian[index]) <<
+            (8 * (index % 8));
+}
+
+uint256_t::uint256_t(const std::string& text)
+  : uint256_t()
+{
+    const auto hex = text.size() > 2 && text[0] == '0' &&
+        (text[1] == 'x' || text[1] == 'X');
+    const auto base = hex ? 16u : 10u;
+    const auto digits = text.substr(hex ? 2 : 0);
+
+    if (digits.empty())
+        throw std::invalid_argument("uint256_t text is empty");
+
+    for (const auto character: digits)
+    {
+        uint64_t digit;
+
+        if (character >= '0' && character <= '9')
+            digit = character - '0';
+        else if (hex && character >= 'a' && character <= 'f')
+            digit = character - 'a' + 10;
+        else if (hex && character >= 'A' && character <= 'F')
+            digit = character - 'A' + 10;
+        else
+            throw std::invalid_argument("uint256_t text is not a number");
+
+        multiply(base);
+        *this += digit;
+    }
+}
+
+uint256_t::uint256_t(const char* text)
+  : uint256_t(std::string(text))
+{
+}
+
+// Properties.
+// ----------------------------------------------------------------------------
+
+size_t uint256_t::bit_length() const
+{
+    for (size_t index = 4; index-- > 0;)
+    {
+        auto limb = limbs_[index];
+
+        if (limb == 0)
+            continue;
+
+        size_t bits = 0;
+
+        for (; limb != 0; limb >>= 1)
+            ++bits;
+
+        return index * 64 + bits;
+    }
+
+    return 0;
+}
+
+std::array<uint8_t, 32> uint256_t::to_little_endian() const
+{
+    std::array<uint8_t, 32> out;
+
+    for (size_t index = 0; index < 32; ++index)
+        out[index] = static_cast<uint8_t>(limbs_[index / 8] >>
+            (8 * (index % 8)));
+
+    return out;
+}
+
+// Multiplication and division.
+// ----------------------------------------------------------------------------
+
+uint64_t uint256_t::multiply(uint64_t factor)
+{
+    uint64_t carry = 0;
+
+    for (size_t index = 0; index < 4; ++index)
+        limbs_[index] = multiply_add(limbs_[index], factor, 0, carry);
+
+    return carry;
+}
+
+uint64_t uint256_t::divide(uint64_t divisor)
+{
+    if (divisor == 0)
+        throw std::overflow_error("uint256_t division by zero");
+
+    uint64_t remainder = 0;
+
+    for (size_t index = 4; index-- > 0;)
+        limbs_[index] = divide_wide(remainder, limbs_[index], divisor,
+            remainder);
+
+    return remainder;
+}
+
+// Truncated schoolbook product, limbs above the 256th bit are discarded.
+uint256_t& uint256_t::operator*=(const uint256_t& other)
+{
+    if (other.is_zero(1))
+    {
+        multiply(other.limbs_[0]);
+        return *this;
+    }
+
+    uint256_t product;
+
+    for (size_t row = 0; row < 4; ++row)
+    {
+        uint64_t carry = 0;
+
+        for (size_t column = 0; row + column < 4; ++column)
+        {
+            auto& limb = product.limbs_[row + column];
+            limb = multiply_add(limbs_[row], other.limbs_[column], limb,
+                carry);
+        }
+    }
+
+    return *this = product;
+}
+
+uint256_t& uint256_t::operator/=(const uint256_t& other)
+{
+    uint256_t remainder;
+    divide(*this, other, *this, remainder);
+    return *this;
+}
+
+uint256_t& uint256_t::operator%=(const uint256_t& other)
+{
+    uint256_t quotient;
+    divide(*this, other, quotient, *this);
+    return *this;
+}
+
+// Divisors of one limb use hardware division per limb. Wider divisors leave
+// a quotient of at most 192 bits, produced by shift and subtract.
+void uint256_t::divide(const uint256_t& dividend, const uint256_t& divisor,
+    uint256_t& quotient, uint256_t& remainder)
+{
+    if (divisor.is_zero())
+        throw std::overflow_error("uint256_t division by zero");
+
+    if (divisor.is_zero(1))
+    {
+        quotient = dividend;
+        remainder = quotient.divide(divisor.limbs_[0]);
+        return;
+    }
+
+    if (dividend < divisor)
+    {
+        remainder = dividend;
+        quotient = uint256_t();
+        return;
+    }
+
+    const auto shift = dividend.bit_length() - divisor.bit_length();
+    auto shifted = divisor << shift;
+    uint256_t result;
+    remainder = dividend;
+
+    for (auto bit = shift + 1; bit-- > 0;)
+    {
+        if (remainder >= shifted)
+        {
+            remainder -= shifted;
+            result.limbs_[bit / 64] |= uint64_t(1) << (bit % 64);
+        }
+
+        shifted >>= 1;
+    }
+
+    quotient = result;
+}
+
+// Text.
+// ----------------------------------------------------------------------------
+
+std::ostream& operator<<(std::ostream& output, const uint256_t& value)
+{
+    static const char digits[] = "0123456789abcdef";
+    const auto hex = (output.flags() & std::ios::basefield) == std::ios::hex;
+    const auto base = hex ? 16u : 10u;
+
+    std::string text;
+    auto remaining = value;
+
+    do
+    {
+        text.push_back(digits[remaining.divide(base)]);
+    } while (!remaining.is_zero());
+
+    std::reverse(text.begin(), text.end());
+    output << text;
+    return output;
+}
+
+} // namespace libbitcoin
@@ -115,19 +115,21 @@ bool block::from_data(uint32_t, reader& source)
 // Witness is always serialized if present.
 // NOTE: Witness on bch is dissabled on the chain::block class
 
+// The wire serialization is built once and shared by each peer's message.
 data_chunk block::to_data(uint32_t) const
 {
-    return chain::block::to_data(true);
+    return *wire_data(true);
 }
 
-void block::to_data(uint32_t, std::ostream& stream) const
+void block::to_data(uint32_t version, std::ostream& stream) const
 {
-    chain::block::to_data(stream, true);
+    ostream_writer sink(stream);
+    to_data(version, sink);
 }
 
 void block::to_data(uint32_t, writer& sink) const
 {
-    chain::block::to_data(sink, true);
+    sink.write_bytes(*wire_data(true));
 }
 
 // Witness size is always counted if present.
@@ -159,11 +159,16 @@ void compact_block::reset()
     auto k0 = from_little_endian_unsafe<uint64_t>(header_hash.begin());
     auto k1 = from_little_endian_unsafe<uint64_t>(header_hash.begin() + sizeof(uint64_t));
 
-    compact_block::short_id_list short_ids_list;
-    short_ids_list.reserve(block.transactions().size() - 1);
+    hash_list hashes;
+    hashes.reserve(block.transactions().size() - 1);
     for (size_t i = 1; i < block.transactions().size(); ++i) {
-        uint64_t shortid = sip_hash_uint256(k0, k1, block.transactions()[i].hash(witness)) & uint64_t(0xffffffffffff);
-        short_ids_list.push_back(shortid);
+        hashes.push_back(block.transactions()[i].hash(witness));
+    }
+
+    compact_block::short_id_list short_ids_list;
+    sip_hash_uint256(k0, k1, hashes, short_ids_list);
+    for (auto& shortid : short_ids_list) {
+        shortid &= uint64_t(0xffffffffffff);
     }
             
     short_ids_ = std::move(short_ids_list);
@@ -0,0 +1,237 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/message/compact_block_reconstructor.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <bitcoin/bitcoin/math/sip_hash.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+// Short ids are the low 48 bits of the siphash.
+static const uint64_t short_id_mask = 0xffffffffffff;
+
+compact_block_reconstructor::compact_block_reconstructor(
+    const compact_block& block)
+  : header_(block.header()), hash_(header_.hash()), valid_(true),
+    remaining_(block.short_ids().size())
+{
+    const auto key = hash(block);
+    key0_ = from_little_endian_unsafe<uint64_t>(key.begin());
+    key1_ = from_little_endian_unsafe<uint64_t>(key.begin() +
+        sizeof(uint64_t));
+
+    const auto& prefilled = block.transactions();
+    const auto& short_ids = block.short_ids();
+    const auto total = prefilled.size() + short_ids.size();
+    transactions_.resize(total);
+    slots_.assign(total, slot::empty);
+
+    // Prefilled indexes are relative to the position after the previous.
+    uint64_t next = 0;
+
+    for (const auto& tx: prefilled)
+    {
+        if (tx.index() >= total - next)
+        {
+            valid_ = false;
+            return;
+        }
+
+        const auto position = static_cast<size_t>(next + tx.index());
+        transactions_[position] = tx.transaction();
+        slots_[position] = slot::filled;
+        next = position + 1u;
+    }
+
+    // Short ids fill the remaining slots in order.
+    positions_.reserve(short_ids.size());
+    auto id = short_ids.begin();
+
+    for (size_t position = 0; position < total; ++position)
+    {
+        if (slots_[position] == slot::filled)
+            continue;
+
+        if (!positions_.emplace(*id++ & short_id_mask, position).second)
+        {
+            valid_ = false;
+            return;
+        }
+    }
+}
+
+// Properties.
+//-----------------------------------------------------------------------------
+
+bool compact_block_reconstructor::is_valid() const
+{
+    return valid_;
+}
+
+bool compact_block_reconstructor::is_complete() const
+{
+    return valid_ && remaining_ == 0;
+}
+
+hash_digest compact_block_reconstructor::short_id_hash(
+    const chain::transaction& tx)
+{
+#ifdef BITPRIM_CURRENCY_BCH
+    static const auto witness = false;
+#else
+    static const auto witness = true;
+#endif
+
+    return tx.hash(witness);
+}
+
+uint64_t compact_block_reconstructor::short_id(
+    const chain::transaction& tx) const
+{
+    return sip_hash_uint256(key0_, key1_, short_id_hash(tx)) & short_id_mask;
+}
+
+void compact_block_reconstructor::short_ids(const hash_list& hashes,
+    std::vector<uint64_t>& out) const
+{
+    sip_hash_uint256(key0_, key1_, hashes, out);
+
+    for (auto& id: out)
+        id &= short_id_mask;
+}
+
+// Filling.
+//-----------------------------------------------------------------------------
+
+bool compact_block_reconstructor::fill(const chain::transaction& tx)
+{
+    return fill(tx, short_id(tx));
+}
+
+bool compact_block_reconstructor::fill(const chain::transaction& tx,
+    uint64_t short_id)
+{
+    if (!valid_)
+        return false;
+
+    const auto it = positions_.find(short_id);
+
+    if (it == positions_.end())
+        return false;
+
+    const auto position = it->second;
+
+    switch (slots_[position])
+    {
+        case slot::empty:
+            transactions_[position] = tx;
+            slots_[position] = slot::filled;
+            --remaining_;
+            return true;
+
+        // A distinct transaction with the same short id, neither is trusted.
+        case slot::filled:
+            if (transactions_[position].hash() != tx.hash())
+            {
+                transactions_[position] = chain::transaction{};
+                slots_[position] = slot::collided;
+                ++remaining_;
+            }
+
+            return false;
+
+        case slot::collided:
+        default:
+            return false;
+    }
+}
+
+bool compact_block_reconstructor::fill(const block_transactions& reply)
+{
+    const auto& txs = reply.transactions();
+
+    if (!valid_ || reply.block_hash() != hash_ || txs.size() != remaining_)
+        return false;
+
+    auto tx = txs.begin();
+
+    for (size_t position = 0; position < slots_.size(); ++position)
+    {
+        if (slots_[position] == slot::filled)
+            continue;
+
+        transactions_[position] = *tx++;
+        slots_[position] = slot::filled;
+    }
+
+    remaining_ = 0;
+    return true;
+}
+
+// Results.
+//-----------------------------------------------------------------------------
+
+compact_block_reconstructor::indexes
+compact_block_reconstructor::missing() const
+{
+    indexes out;
+    out.reserve(remaining_);
+
+    for (size_t position = 0; position < slots_.size(); ++position)
+        if (slots_[position] != slot::filled)
+            out.push_back(position);
+
+    return out;
+}
+
+get_block_transactions compact_block_reconstructor::to_request() const
+{
+    auto out = missing();
+    uint64_t next = 0;
+
+    for (auto& index: out)
+    {
+        const auto position = index;
+        index -= next;
+        next = position + 1u;
+    }
+
+    return { hash_, std::move(out) };
+}
+
+bool compact_block_reconstructor::to_block(chain::block& out) const
+{
+    if (!is_complete())
+        return false;
+
+    chain::block block(header_, transactions_);
+
+    if (block.generate_merkle_root() != header_.merkle())
+        return false;
+
+    out = std::move(block);
+    return true;
+}
+
+} // namespace message
+} // namespace libbitcoin
@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/message/framer.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/math/checksum.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+framer::framer(uint32_t magic, uint32_t version, bool witness)
+  : magic_(magic),
+    maximum_payload_size_(heading::maximum_payload_size(version, witness))
+{
+}
+
+uint32_t framer::magic() const
+{
+    return magic_;
+}
+
+size_t framer::maximum_payload_size() const
+{
+    return maximum_payload_size_;
+}
+
+// The heading is validated before its payload is awaited, so a bad peer is
+// detected without buffering a payload it claims.
+framer::result framer::read(data_slice buffer, heading& out_heading,
+    data_slice& out_payload, size_t& out_size) const
+{
+    const auto heading_size = heading::satoshi_fixed_size();
+
+    if (buffer.size() < heading_size)
+        return result::incomplete;
+
+    const auto begin = buffer.begin();
+    auto source = make_safe_deserializer(begin, begin + heading_size);
+
+    if (!out_heading.from_data(source) || out_heading.magic() != magic_ ||
+        out_heading.payload_size() > maximum_payload_size_)
+        return result::invalid;
+
+    const auto frame_size = heading_size + out_heading.payload_size();
+
+    if (buffer.size() < frame_size)
+        return result::incomplete;
+
+    const data_slice payload(begin + heading_size, begin + frame_size);
+
+    if (bitcoin_checksum(payload) != out_heading.checksum())
+        return result::invalid;
+
+    out_payload = payload;
+    out_size = frame_size;
+    return result::complete;
+}
+
+} // namespace message
+} // namespace libbitcoin
@@ -0,0 +1,486 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/message/graphene_block.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/math/sip_hash.hpp>
+#include <bitcoin/bitcoin/message/messages.hpp>
+#include <bitcoin/bitcoin/utility/container_sink.hpp>
+#include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+#include <bitcoin/bitcoin/utility/istream_reader.hpp>
+#include <bitcoin/bitcoin/utility/ostream_writer.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+#ifdef BITPRIM_CURRENCY_BCH
+static const auto witness = false;
+#else
+static const auto witness = true;
+#endif
+
+// The serialized size of a table cell and the table cells per key decoded.
+static const double cell_bytes = 16.0;
+static const double cells_per_key = 1.5;
+
+// The filter is only worth sending when it removes most of the pool.
+static const double maximum_false_positive_rate = 0.25;
+
+// A filter of fewer elements rounds down to no hash functions.
+static const size_t minimum_filter_elements = 8;
+
+// Canonical order compares hashes as numbers, so from the last byte, as with
+// block::is_canonical_ordered.
+static bool canonical_less(const hash_digest& left, const hash_digest& right)
+{
+    return std::lexicographical_compare(left.rbegin(), left.rend(),
+        right.rbegin(), right.rend());
+}
+
+// One input and one output, with empty scripts, bounds block transactions.
+static const size_t smallest_transaction = 4 + 1 + 41 + 1 + 9 + 4;
+
+graphene_block graphene_block::factory_from_data(uint32_t version,
+    const data_chunk& data)
+{
+    graphene_block instance;
+    instance.from_data(version, data);
+    return instance;
+}
+
+graphene_block graphene_block::factory_from_data(uint32_t version,
+    std::istream& stream)
+{
+    graphene_block instance;
+    instance.from_data(version, stream);
+    return instance;
+}
+
+graphene_block graphene_block::factory_from_data(uint32_t version,
+    reader& source)
+{
+    graphene_block instance;
+    instance.from_data(version, source);
+    return instance;
+}
+
+graphene_block::graphene_block()
+  : nonce_(0), transaction_count_(0), key0_(0), key1_(0)
+{
+}
+
+// The filter and table sizes minimize their total size. Of the pool excess
+// over the block, a fraction f passes a filter of -n*ln(f)/(8*ln(2)^2) bytes
+// and each passing transaction costs the table cells_per_key cells. The sum
+// is least for a = n/(8*ln(2)^2*cells_per_key*cell_bytes) expected passes.
+// False positives are counted in the table with three deviations of margin.
+graphene_block::graphene_block(const chain::block& block, uint64_t nonce,
+    size_t pool_size)
+  : header_(block.header()), nonce_(nonce), transaction_count_(0)
+{
+    const auto& txs = block.transactions();
+
+    if (txs.empty())
+        return;
+
+    set_keys();
+    coinbase_ = txs.front();
+    transaction_count_ = static_cast<uint32_t>(txs.size());
+
+    const auto count = txs.size() - 1u;
+    hash_list hashes;
+    hashes.reserve(count);
+
+    for (auto tx = std::next(txs.begin()); tx != txs.end(); ++tx)
+        hashes.push_back(tx->hash());
+
+    const auto ln2 = std::log(2.0);
+    const auto excess = static_cast<double>(pool_size > count ?
+        pool_size - count : 0);
+    const auto passes = std::max(1.0, count /
+        (8.0 * ln2 * ln2 * cells_per_key * cell_bytes));
+    const auto rate = excess == 0 ? 1.0 : passes / excess;
+
+    double capacity;
+
+    if (rate <= maximum_false_positive_rate)
+    {
+        filter_ = chain::bloom_filter(std::max(count, minimum_filter_elements),
+            rate, static_cast<uint32_t>(nonce_),
+            chain::bloom_filter::update::none);
+
+        for (const auto& hash: hashes)
+            filter_.insert(hash);
+
+        capacity = passes + 3.0 * std::sqrt(passes);
+    }
+    else
+    {
+        capacity = excess;
+    }
+
+    table_ = chain::iblt(static_cast<size_t>(std::ceil(capacity)),
+        static_cast<uint32_t>(nonce_ >> 32));
+
+    std::vector<uint64_t> ids;
+    sip_hash_uint256(key0_, key1_, hashes, ids);
+
+    for (const auto id: ids)
+        table_.insert(id);
+
+    // Canonical order is ascending by transaction hash after the coinbase.
+    if (std::is_sorted(hashes.begin(), hashes.end(), canonical_less))
+        return;
+
+    order_.resize(count);
+
+    for (uint32_t position = 0; position < count; ++position)
+        order_[position] = position;
+
+    std::sort(order_.begin(), order_.end(),
+        [&ids](uint32_t left, uint32_t right)
+        {
+            return ids[left] < ids[right];
+        });
+}
+
+// The siphash key is taken from the header and nonce, as for compact blocks.
+void graphene_block::set_keys()
+{
+    data_chunk data;
+    data.reserve(chain::header::satoshi_fixed_size() + sizeof(nonce_));
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    header_.to_data(sink);
+    sink.write_8_bytes_little_endian(nonce_);
+    ostream.flush();
+
+    const auto key = sha256_hash(data);
+    key0_ = from_little_endian_unsafe<uint64_t>(key.begin());
+    key1_ = from_little_endian_unsafe<uint64_t>(key.begin() +
+        sizeof(uint64_t));
+}
+
+// Properties.
+//-----------------------------------------------------------------------------
+
+const chain::header& graphene_block::header() const
+{
+    return header_;
+}
+
+uint64_t graphene_block::nonce() const
+{
+    return nonce_;
+}
+
+const chain::transaction& graphene_block::coinbase() const
+{
+    return coinbase_;
+}
+
+uint32_t graphene_block::transaction_count() const
+{
+    return transaction_count_;
+}
+
+const chain::bloom_filter& graphene_block::filter() const
+{
+    return filter_;
+}
+
+const chain::iblt& graphene_block::table() const
+{
+    return table_;
+}
+
+const graphene_block::order_list& graphene_block::order() const
+{
+    return order_;
+}
+
+uint64_t graphene_block::short_id(const chain::transaction& tx) const
+{
+    return sip_hash_uint256(key0_, key1_, tx.hash());
+}
+
+bool graphene_block::is_valid() const
+{
+    return transaction_count_ != 0 && filter_.is_valid() &&
+        table_.is_valid() && (order_.empty() ||
+            order_.size() == transaction_count_ - 1u);
+}
+
+void graphene_block::reset()
+{
+    header_ = chain::header{};
+    nonce_ = 0;
+    coinbase_ = chain::transaction{};
+    transaction_count_ = 0;
+    filter_ = chain::bloom_filter{};
+    table_ = chain::iblt{};
+    order_.clear();
+    order_.shrink_to_fit();
+    key0_ = 0;
+    key1_ = 0;
+}
+
+// Reconstruction.
+//-----------------------------------------------------------------------------
+
+// The table less the candidates decodes to the short ids of the block that
+// are not candidates and of the candidates that are not in the block.
+graphene_block::result graphene_block::reconstruct(const candidates& pool,
+    chain::block& out, short_id_list& out_missing) const
+{
+    out_missing.clear();
+
+    if (!is_valid())
+        return result::failed;
+
+    hash_list hashes;
+    hashes.reserve(pool.size());
+
+    for (const auto tx: pool)
+        hashes.push_back(tx->hash());
+
+    std::vector<uint64_t> ids;
+    sip_hash_uint256(key0_, key1_, hashes, ids);
+
+    std::unordered_map<uint64_t, size_t> found;
+    found.reserve(pool.size());
+    auto difference = table_;
+
+    for (size_t index = 0; index < ids.size(); ++index)
+    {
+        const auto entry = found.emplace(ids[index], index);
+
+        // A repeated transaction is ignored, a short id collision is not.
+        if (!entry.second)
+        {
+            if (hashes[entry.first->second] != hashes[index])
+                return result::failed;
+
+            continue;
+        }
+
+        difference.erase(ids[index]);
+    }
+
+    chain::iblt::keys missing;
+    chain::iblt::keys excluded;
+
+    if (!difference.decode(missing, excluded))
+        return result::failed;
+
+    for (const auto id: excluded)
+        if (found.erase(id) == 0)
+            return result::failed;
+
+    const size_t count = transaction_count_ - 1u;
+
+    if (found.size() + missing.size() != count)
+        return result::failed;
+
+    if (!missing.empty())
+    {
+        out_missing = std::move(missing);
+        return result::incomplete;
+    }
+
+    std::vector<std::pair<uint64_t, size_t>> matched(found.begin(),
+        found.end());
+    chain::transaction::list transactions(count + 1u);
+    transactions.front() = coinbase_;
+
+    if (order_.empty())
+    {
+        std::sort(matched.begin(), matched.end(),
+            [&hashes](const std::pair<uint64_t, size_t>& left,
+                const std::pair<uint64_t, size_t>& right)
+            {
+                return canonical_less(hashes[left.second],
+                    hashes[right.second]);
+            });
+
+        for (size_t position = 0; position < count; ++position)
+            transactions[position + 1u] = *pool[matched[position].second];
+    }
+    else
+    {
+        std::sort(matched.begin(), matched.end());
+        std::vector<bool> placed(count, false);
+
+        for (size_t rank = 0; rank < count; ++rank)
+        {
+            const auto position = order_[rank];
+
+            if (position >= count || placed[position])
+                return result::failed;
+
+            placed[position] = true;
+            transactions[position + 1u] = *pool[matched[rank].second];
+        }
+    }
+
+    chain::block block(header_, std::move(transactions));
+
+    // An undetected short id collision or a corrupt order ends here.
+    if (block.generate_merkle_root() != header_.merkle())
+        return result::failed;
+
+    out = std::move(block);
+    return result::complete;
+}
+
+// Serialization.
+//-----------------------------------------------------------------------------
+
+bool graphene_block::from_data(uint32_t version, const data_chunk& data)
+{
+    data_source istream(data);
+    return from_data(version, istream);
+}
+
+bool graphene_block::from_data(uint32_t version, std::istream& stream)
+{
+    istream_reader source(stream);
+    return from_data(version, source);
+}
+
+bool graphene_block::from_data(uint32_t, reader& source)
+{
+    reset();
+
+    if (!header_.from_data(source))
+        return false;
+
+    nonce_ = source.read_8_bytes_little_endian();
+    coinbase_.from_data(source, true, witness);
+    transaction_count_ = source.read_4_bytes_little_endian();
+
+    // Guard against potential for arbitary memory allocation.
+    if (transaction_count_ > get_max_block_size() / smallest_transaction)
+        source.invalidate();
+
+    const auto size = source.read_size_little_endian();
+    data_chunk filter;
+
+    // Guard against potential for arbitary memory allocation.
+    if (size > max_filter_load)
+        source.invalidate();
+    else
+        filter = source.read_bytes(size);
+
+    const auto hash_functions = source.read_4_bytes_little_endian();
+    const auto tweak = source.read_4_bytes_little_endian();
+    const auto flags = source.read_byte();
+    filter_ = chain::bloom_filter(std::move(filter), hash_functions, tweak,
+        flags);
+
+    if (!table_.from_data(source))
+        source.invalidate();
+
+    const auto count = source.read_size_little_endian();
+
+    // An order is of every transaction except the coinbase.
+    if (count != 0 && count != transaction_count_ - 1u)
+        source.invalidate();
+    else
+        order_.reserve(count);
+
+    for (size_t rank = 0; rank < count && source; ++rank)
+        order_.push_back(source.read_4_bytes_little_endian());
+
+    if (!source || !is_valid())
+    {
+        source.invalidate();
+        reset();
+        return false;
+    }
+
+    set_keys();
+    return true;
+}
+
+data_chunk graphene_block::to_data(uint32_t version) const
+{
+    data_chunk data;
+    const auto size = serialized_size(version);
+    data.reserve(size);
+    data_sink ostream(data);
+    to_data(version, ostream);
+    ostream.flush();
+    BITCOIN_ASSERT(data.size() == size);
+    return data;
+}
+
+void graphene_block::to_data(uint32_t version, std::ostream& stream) const
+{
+    ostream_writer sink(stream);
+    to_data(version, sink);
+}
+
+void graphene_block::to_data(uint32_t, writer& sink) const
+{
+    header_.to_data(sink);
+    sink.write_8_bytes_little_endian(nonce_);
+    coinbase_.to_data(sink, true, witness);
+    sink.write_4_bytes_little_endian(transaction_count_);
+
+    const auto& filter = filter_.filter();
+    sink.write_variable_little_endian(filter.size());
+    sink.write_bytes(filter);
+    sink.write_4_bytes_little_endian(filter_.hash_functions());
+    sink.write_4_bytes_little_endian(filter_.tweak());
+    sink.write_byte(filter_.flags());
+
+    table_.to_data(sink);
+
+    sink.write_variable_little_endian(order_.size());
+
+    for (const auto position: order_)
+        sink.write_4_bytes_little_endian(position);
+}
+
+size_t graphene_block::serialized_size(uint32_t) const
+{
+    const auto filter_size = filter_.filter().size();
+
+    return chain::header::satoshi_fixed_size() + sizeof(nonce_) +
+        coinbase_.serialized_size(true, witness) + sizeof(uint32_t) +
+        message::variable_uint_size(filter_size) + filter_size +
+        sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint8_t) +
+        table_.serialized_size() +
+        message::variable_uint_size(order_.size()) +
+        order_.size() * sizeof(uint32_t);
+}
+
+} // namespace message
+} // namespace libbitcoin
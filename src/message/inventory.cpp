@@ -20,6 +20,8 @@
 
 #include <algorithm>
 #include <initializer_list>
+#include <iterator>
+#include <bitcoin/bitcoin/chain/rolling_bloom_filter.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/math/limits.hpp>
 #include <bitcoin/bitcoin/message/inventory.hpp>
@@ -214,6 +216,26 @@ size_t inventory::count(type_id type) const
     return count_if(inventories_.begin(), inventories_.end(), is_type);
 }
 
+size_t inventory::remove_known(const chain::rolling_bloom_filter& known)
+{
+    const auto is_known = [&known](const inventory_vector& element)
+    {
+        return known.contains(element.hash());
+    };
+
+    const auto end = inventories_.end();
+    const auto first = std::remove_if(inventories_.begin(), end, is_known);
+    const auto removed = static_cast<size_t>(std::distance(first, end));
+    inventories_.erase(first, end);
+    return removed;
+}
+
+void inventory::add_known(chain::rolling_bloom_filter& known) const
+{
+    for (const auto& element: inventories_)
+        known.insert(element.hash());
+}
+
 inventory_vector::list& inventory::inventories()
 {
     return inventories_;
@@ -91,6 +91,20 @@ merkle_block::merkle_block(const chain::block& block)
 {
 }
 
+merkle_block::merkle_block(const chain::block& block,
+    const chain::merkle_tree::matches& matched)
+  : merkle_block(block.header(), *block.to_merkle_tree(), matched)
+{
+}
+
+// An invalid match set leaves no hashes or flags, which fails extraction.
+merkle_block::merkle_block(const chain::header& header,
+    const chain::merkle_tree& tree, const chain::merkle_tree::matches& matched)
+  : header_(header), total_transactions_(tree.size()), hashes_(), flags_()
+{
+    tree.partial(matched, hashes_, flags_);
+}
+
 merkle_block::merkle_block(const merkle_block& other)
   : merkle_block(other.header_, other.total_transactions_, other.hashes_,
       other.flags_)
@@ -118,6 +132,14 @@ void merkle_block::reset()
     flags_.shrink_to_fit();
 }
 
+bool merkle_block::extract(hash_list& out_hashes,
+    chain::merkle_tree::indexes& out_positions) const
+{
+    hash_digest root;
+    return chain::merkle_tree::extract(total_transactions_, hashes_, flags_,
+        root, out_hashes, out_positions) && root == header_.merkle();
+}
+
 bool merkle_block::from_data(uint32_t version, const data_chunk& data)
 {
     data_source istream(data);
@@ -20,6 +20,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <bitcoin/bitcoin/constants.hpp>
 
 namespace libbitcoin {
 namespace message {
@@ -36,5 +37,20 @@ size_t variable_uint_size(uint64_t value)
         return 9;
 }
 
+size_t variable_prefix_size(uint8_t prefix)
+{
+    switch (prefix)
+    {
+        case varint_eight_bytes:
+            return 9;
+        case varint_four_bytes:
+            return 5;
+        case varint_two_bytes:
+            return 3;
+        default:
+            return 1;
+    }
+}
+
 } // namespace message
 } // namespace libbitcoin
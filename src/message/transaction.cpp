@@ -24,6 +24,7 @@
 #include <bitcoin/bitcoin/chain/output.hpp>
 #include <bitcoin/bitcoin/message/version.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 
 namespace libbitcoin {
@@ -116,19 +117,22 @@ bool transaction::from_data(uint32_t, reader& source)
 // Witness is always serialized if present.
 // NOTE: Witness on bch is dissabled on the chain::block class
 
+// The wire serialization is built once and shared by each peer's message.
 data_chunk transaction::to_data(uint32_t, bool witness) const
 {
-    return chain::transaction::to_data(true, witness);
+    return *wire_data(witness);
 }
 
-void transaction::to_data(uint32_t, std::ostream& stream, bool witness) const
+void transaction::to_data(uint32_t version, std::ostream& stream,
+    bool witness) const
 {
-    chain::transaction::to_data(stream, true, witness);
+    ostream_writer sink(stream);
+    to_data(version, sink, witness);
 }
 
 void transaction::to_data(uint32_t, writer& sink, bool witness) const
 {
-    chain::transaction::to_data(sink, true, witness);
+    sink.write_bytes(*wire_data(witness));
 }
 
 // Witness size is always counted if present.
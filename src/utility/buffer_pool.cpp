@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/utility/buffer_pool.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <bitcoin/bitcoin/utility/thread.hpp>
+
+namespace libbitcoin {
+
+buffer_pool::buffer_pool(size_t capacity)
+  : store_(std::make_shared<store>())
+{
+    store_->capacity = capacity;
+    store_->buffers.reserve(capacity);
+}
+
+// The most recently released buffer is reused first, as it is the most
+// likely to be in cache.
+buffer_pool::buffer_ptr buffer_pool::acquire(size_t size)
+{
+    // Owned here until handed to the pointer, as resize may throw.
+    std::unique_ptr<data_chunk> buffer(new data_chunk);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    {
+        unique_lock lock(store_->mutex);
+
+        if (!store_->buffers.empty())
+        {
+            buffer->swap(store_->buffers.back());
+            store_->buffers.pop_back();
+        }
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    buffer->resize(size);
+    const std::weak_ptr<store> weak = store_;
+
+    return buffer_ptr(buffer.release(), [weak](data_chunk* released)
+    {
+        release(weak, released);
+    });
+}
+
+size_t buffer_pool::idle() const
+{
+    shared_lock lock(store_->mutex);
+    return store_->buffers.size();
+}
+
+void buffer_pool::release(const std::weak_ptr<store>& weak,
+    data_chunk* buffer)
+{
+    const std::unique_ptr<data_chunk> owner(buffer);
+    const auto pool = weak.lock();
+
+    if (!pool)
+        return;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(pool->mutex);
+
+    if (pool->buffers.size() < pool->capacity)
+        pool->buffers.push_back(std::move(*buffer));
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace libbitcoin
@@ -247,7 +247,11 @@ void istream_reader::skip(size_t size)
     // TODO: investigate failure using seekg.
     // Seek the relative size offset from the current position.
     ////stream_.seekg(size, std::ios_base::cur);
-    read_bytes(size);
+
+    // Discard without allocation, a short stream invalidates as a read would.
+    if (size > 0 && stream_.ignore(size).gcount() !=
+        static_cast<std::streamsize>(size))
+        invalidate();
 }
 
 // private
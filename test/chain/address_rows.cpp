@@ -0,0 +1,168 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+using namespace bc::machine;
+using namespace bc::wallet;
+
+BOOST_AUTO_TEST_SUITE(address_rows_tests)
+
+static const ec_compressed key = base16_literal(
+    "0279be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798");
+
+static const short_hash hash1 = base16_literal(
+    "1111111111111111111111111111111111111111");
+
+static const short_hash hash2 = base16_literal(
+    "2222222222222222222222222222222222222222");
+
+static transaction make_transaction(uint32_t index)
+{
+    const output_point point{ null_hash, index };
+    const data_chunk endorsement(71, 0x30);
+    const data_chunk redeem{ 0x51, 0x51, 0x87 };
+
+    const input::list inputs
+    {
+        { point, operation::list{ { endorsement }, { to_chunk(key) } }, 0 },
+        { point, operation::list{ { redeem } }, 0 },
+        { point, operation::list{ { opcode::checksig } }, 0 },
+        { point, script{}, 0 }
+    };
+
+    const output::list outputs
+    {
+        { 1, script::to_pay_key_hash_pattern(hash1) },
+        { 2, script::to_pay_script_hash_pattern(hash2) },
+        { 3, script::to_pay_public_key_pattern(key) },
+        { 4, script::to_null_data_pattern(to_chunk(hash1)) },
+        { 5, script::to_pay_multisig_pattern(1, { to_chunk(key) }) },
+        { 6, script{ build_chunk({ data_chunk{ 0x4c, 0x21 }, key,
+            data_chunk{ 0xac } }), false } }
+    };
+
+    return { 1, 0, inputs, outputs };
+}
+
+BOOST_AUTO_TEST_CASE(address_rows__extract__transaction__matches_payment_address)
+{
+    const auto tx = make_transaction(0);
+    address_rows rows;
+    rows.extract(tx, 7);
+
+    size_t row = 0;
+
+    for (uint32_t index = 0; index < tx.inputs().size(); ++index)
+    {
+        for (const auto& address:
+            payment_address::extract_input(tx.inputs()[index].script()))
+        {
+            const auto p2kh = address.version() ==
+                payment_address::mainnet_p2kh;
+            const auto kind = p2kh ? address_rows::kind::input_key_hash :
+                address_rows::kind::input_script_hash;
+
+            BOOST_REQUIRE_LT(row, rows.size());
+            BOOST_REQUIRE_EQUAL(rows.transactions()[row], 7u);
+            BOOST_REQUIRE_EQUAL(rows.indexes()[row], index);
+            BOOST_REQUIRE(rows.kinds()[row] == kind);
+            BOOST_REQUIRE(rows.hashes()[row] == address.hash());
+            BOOST_REQUIRE_EQUAL(rows.values()[row], output::not_found);
+            ++row;
+        }
+    }
+
+    for (uint32_t index = 0; index < tx.outputs().size(); ++index)
+    {
+        const auto& output = tx.outputs()[index];
+
+        for (const auto& address:
+            payment_address::extract_output(output.script()))
+        {
+            const auto p2kh = address.version() ==
+                payment_address::mainnet_p2kh;
+            const auto kind = p2kh ? address_rows::kind::output_key_hash :
+                address_rows::kind::output_script_hash;
+
+            BOOST_REQUIRE_LT(row, rows.size());
+            BOOST_REQUIRE_EQUAL(rows.transactions()[row], 7u);
+            BOOST_REQUIRE_EQUAL(rows.indexes()[row], index);
+            BOOST_REQUIRE(rows.kinds()[row] == kind);
+            BOOST_REQUIRE(rows.hashes()[row] == address.hash());
+            BOOST_REQUIRE_EQUAL(rows.values()[row], output.value());
+            ++row;
+        }
+    }
+
+    // Sign key hash (2), sign script hash (1) and four pay outputs, one of
+    // which pushes its public key with a non-minimal push.
+    BOOST_REQUIRE_EQUAL(row, 7u);
+    BOOST_REQUIRE_EQUAL(rows.size(), row);
+}
+
+BOOST_AUTO_TEST_CASE(address_rows__extract__block_threads__same_rows)
+{
+    const auto genesis = block::genesis_mainnet();
+    transaction::list txs{ genesis.transactions().front() };
+
+    for (uint32_t index = 0; index < 9; ++index)
+        txs.push_back(make_transaction(index));
+
+    const block instance(genesis.header(), std::move(txs));
+
+    address_rows serial;
+    serial.extract(instance);
+
+    // The coinbase input is skipped, its pay public key output is not.
+    BOOST_REQUIRE_EQUAL(serial.size(), 1u + 9u * 7u);
+    BOOST_REQUIRE_EQUAL(serial.transactions().front(), 0u);
+    BOOST_REQUIRE(serial.kinds().front() ==
+        address_rows::kind::output_key_hash);
+    BOOST_REQUIRE_EQUAL(serial.transactions().back(), 9u);
+
+    address_rows parallel;
+    parallel.extract(instance, 4);
+    BOOST_REQUIRE(parallel.transactions() == serial.transactions());
+    BOOST_REQUIRE(parallel.indexes() == serial.indexes());
+    BOOST_REQUIRE(parallel.kinds() == serial.kinds());
+    BOOST_REQUIRE(parallel.hashes() == serial.hashes());
+    BOOST_REQUIRE(parallel.values() == serial.values());
+
+    // Extraction replaces the rows.
+    parallel.extract(instance, 4);
+    BOOST_REQUIRE_EQUAL(parallel.size(), serial.size());
+}
+
+BOOST_AUTO_TEST_CASE(address_rows__extract__truncated_push__no_rows)
+{
+    const output::list outputs
+    {
+        { 1, script{ data_chunk{ 0x76, 0xa9, 0x14, 0x11 }, false } }
+    };
+
+    address_rows rows;
+    rows.extract(transaction{ 1, 0, {}, outputs }, 0);
+    BOOST_REQUIRE_EQUAL(rows.size(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -333,6 +333,96 @@ BOOST_AUTO_TEST_CASE(block__factory_from_data_2__genesis_mainnet__success)
     BOOST_REQUIRE(genesis.header().merkle() == block.generate_merkle_root());
 }
 
+BOOST_AUTO_TEST_CASE(block__wire_data__from_data__captured_and_shared)
+{
+    const auto raw_block = chain::block::genesis_mainnet().to_data();
+    chain::block block;
+    BOOST_REQUIRE(block.from_data(raw_block));
+
+    const auto data = block.wire_data();
+    BOOST_REQUIRE(*data == raw_block);
+    BOOST_REQUIRE(block.wire_data() == data);
+    BOOST_REQUIRE(chain::block(block).wire_data() == data);
+    BOOST_REQUIRE(block.to_data() == raw_block);
+}
+
+BOOST_AUTO_TEST_CASE(block__wire_data__setter__invalidated)
+{
+    const auto raw_block = chain::block::genesis_mainnet().to_data();
+    chain::block block;
+    BOOST_REQUIRE(block.from_data(raw_block));
+    const auto data = block.wire_data();
+
+    auto header = block.header();
+    header.set_nonce(header.nonce() + 1);
+    block.set_header(header);
+    BOOST_REQUIRE(block.wire_data() != data);
+    BOOST_REQUIRE(*block.wire_data() != raw_block);
+    BOOST_REQUIRE(block.to_data() == *block.wire_data());
+
+    block = chain::block::genesis_testnet();
+    BOOST_REQUIRE(*block.wire_data() ==
+        chain::block::genesis_testnet().to_data());
+}
+
+BOOST_AUTO_TEST_CASE(block__wire_data__copy_mutated_through_accessor__invalidated)
+{
+    const auto raw_block = chain::block::genesis_mainnet().to_data();
+    chain::block block;
+    BOOST_REQUIRE(block.from_data(raw_block));
+
+    chain::block copy(block);
+    copy.header().set_merkle(null_hash);
+    BOOST_REQUIRE(copy.to_data() != raw_block);
+    BOOST_REQUIRE(block.to_data() == raw_block);
+
+    chain::block reloaded;
+    BOOST_REQUIRE(reloaded.from_data(copy.to_data()));
+    BOOST_REQUIRE(reloaded.header().merkle() == null_hash);
+
+    const auto data = copy.wire_data();
+    copy.transactions().front().set_locktime(42);
+    BOOST_REQUIRE(copy.wire_data() != data);
+    BOOST_REQUIRE(reloaded.from_data(copy.to_data()));
+    BOOST_REQUIRE_EQUAL(reloaded.transactions().front().locktime(), 42u);
+}
+
+BOOST_AUTO_TEST_CASE(block__from_data__parse_outputs__outputs_hashes_and_offsets)
+{
+    const auto genesis = chain::block::genesis_mainnet();
+    auto second = genesis.transactions().front();
+    second.set_locktime(42);
+    const chain::block expected(genesis.header(),
+        { genesis.transactions().front(), second });
+    const auto raw_block = expected.to_data();
+
+    chain::block block;
+    chain::transaction::offsets::list offsets;
+    BOOST_REQUIRE(block.from_data(raw_block,
+        chain::transaction::parse_outputs, offsets));
+    BOOST_REQUIRE(block.header() == expected.header());
+    BOOST_REQUIRE_EQUAL(block.transactions().size(), 2u);
+    BOOST_REQUIRE_EQUAL(offsets.size(), 2u);
+
+    for (size_t index = 0; index < offsets.size(); ++index)
+    {
+        const auto& tx = block.transactions()[index];
+        const auto& original = expected.transactions()[index];
+        BOOST_REQUIRE(tx.outputs() == original.outputs());
+        BOOST_REQUIRE(tx.inputs().front().script().empty());
+        BOOST_REQUIRE(tx.hash() == original.hash());
+
+        // Each transaction is recovered from its offset.
+        const auto begin = raw_block.begin() + offsets[index].transaction;
+        const auto end = raw_block.begin() + offsets[index].locktime + 4;
+        BOOST_REQUIRE(chain::transaction::factory_from_data(
+            data_chunk(begin, end)) == original);
+    }
+
+    BOOST_REQUIRE_EQUAL(offsets.front().transaction, 81u);
+    BOOST_REQUIRE_EQUAL(offsets.back().locktime + 4u, raw_block.size());
+}
+
 BOOST_AUTO_TEST_CASE(block__factory_from_data_3__genesis_mainnet__success)
 {
     const auto genesis = bc::chain::block::genesis_mainnet();
@@ -672,6 +762,193 @@ BOOST_AUTO_TEST_CASE(validate_block__is_cash_pow_valid__true){
 #endif //BITPRIM_CURRENCY_BCH
 
 
+// assume valid
+
+static chain::chain_state::ptr make_assume_valid_state(size_t height,
+    const hash_digest& populated, const config::checkpoint& assume_valid)
+{
+    static const config::checkpoint::list checkpoints;
+    chain::chain_state::data data;
+    data.height = height;
+    data.hash = null_hash;
+    data.allow_collisions_hash = null_hash;
+    data.bip9_bit0_hash = null_hash;
+    data.bip9_bit1_hash = null_hash;
+    data.assume_valid_hash = populated;
+    data.bits.self = 0x1d00ffff;
+    data.bits.ordered = { 0x1d00ffff };
+    data.version.self = 1;
+    data.version.ordered = { 1 };
+    data.timestamp.self = 1;
+    data.timestamp.retarget = 0;
+    data.timestamp.ordered = { 0 };
+
+    return std::make_shared<chain::chain_state>(std::move(data), checkpoints,
+        0
+#ifdef BITPRIM_CURRENCY_BCH
+        , bch_magnetic_anomaly_activation_time
+        , bch_great_wall_activation_time
+#endif
+        , assume_valid);
+}
+
+// A spend of an unpopulated previous output, which fails script connection.
+static chain::block make_unpopulated_spend_block()
+{
+    chain::input input;
+    input.set_previous_output({ hash_literal(
+        "0000000000000000000000000000000000000000000000000000000000000001"),
+        0 });
+
+    chain::transaction tx;
+    tx.set_inputs({ input });
+
+    chain::block block;
+    block.set_transactions({ tx });
+    return block;
+}
+
+BOOST_AUTO_TEST_CASE(block__get_map__assume_valid__requested_at_and_below)
+{
+    const config::checkpoint assume_valid(hash_literal(
+        "00000000000000000000000000000000000000000000000000000000000000aa"),
+        100);
+    const size_t unrequested = chain::chain_state::map::unrequested;
+
+    const auto below = chain::chain_state::get_map(42, {}, 0, assume_valid);
+    BOOST_REQUIRE_EQUAL(below.assume_valid_height, 100u);
+
+    const auto at = chain::chain_state::get_map(100, {}, 0, assume_valid);
+    BOOST_REQUIRE_EQUAL(at.assume_valid_height, 100u);
+
+    const auto above = chain::chain_state::get_map(101, {}, 0, assume_valid);
+    BOOST_REQUIRE_EQUAL(above.assume_valid_height, unrequested);
+
+    const auto disabled = chain::chain_state::get_map(42, {}, 0);
+    BOOST_REQUIRE_EQUAL(disabled.assume_valid_height, unrequested);
+}
+
+BOOST_AUTO_TEST_CASE(block__connect__under_assume_valid__skips_scripts)
+{
+    const auto hash = hash_literal(
+        "00000000000000000000000000000000000000000000000000000000000000aa");
+    const auto state = make_assume_valid_state(42, hash, { hash, 100 });
+    BOOST_REQUIRE(state->is_under_assume_valid());
+
+    const auto block = make_unpopulated_spend_block();
+    BOOST_REQUIRE_EQUAL(block.connect(*state), error::success);
+}
+
+BOOST_AUTO_TEST_CASE(block__connect__other_chain__verifies_scripts)
+{
+    const auto hash = hash_literal(
+        "00000000000000000000000000000000000000000000000000000000000000aa");
+    const auto state = make_assume_valid_state(42, null_hash, { hash, 100 });
+    BOOST_REQUIRE(!state->is_under_assume_valid());
+
+    const auto block = make_unpopulated_spend_block();
+    BOOST_REQUIRE_EQUAL(block.connect(*state), error::missing_previous_output);
+}
+
+BOOST_AUTO_TEST_CASE(block__connect__above_assume_valid__verifies_scripts)
+{
+    const auto hash = hash_literal(
+        "00000000000000000000000000000000000000000000000000000000000000aa");
+    const auto state = make_assume_valid_state(101, hash, { hash, 100 });
+    BOOST_REQUIRE(!state->is_under_assume_valid());
+
+    const auto block = make_unpopulated_spend_block();
+    BOOST_REQUIRE_EQUAL(block.connect(*state), error::missing_previous_output);
+}
+
+BOOST_AUTO_TEST_CASE(block__is_under_assume_valid__header_at_assume_valid_height__true)
+{
+    chain::header header;
+    header.set_timestamp(2);
+    const config::checkpoint assume_valid(header.hash(), 100);
+    const auto parent = make_assume_valid_state(99, null_hash, assume_valid);
+    BOOST_REQUIRE(!parent->is_under_assume_valid());
+
+    // The header at the assume valid height caches its own hash.
+    const chain::chain_state child(*parent, header);
+    BOOST_REQUIRE_EQUAL(child.height(), 100u);
+    BOOST_REQUIRE(child.is_under_assume_valid());
+}
+
+// dependency levels and components
+
+static chain::transaction make_spend(uint32_t locktime,
+    const std::vector<hash_digest>& spent)
+{
+    chain::input::list inputs;
+    for (const auto& hash: spent)
+        inputs.push_back({ { hash, 0 }, {}, 0 });
+
+    return { 1, locktime, inputs, { { 1, {} } } };
+}
+
+// [coinbase, c(b, external), a(external), d(external), b(a)]
+static chain::block make_dependent_block()
+{
+    const auto external = hash_literal(
+        "00000000000000000000000000000000000000000000000000000000000000ee");
+
+    const auto coinbase = make_spend(0, { null_hash });
+    const auto a = make_spend(1, { external });
+    const auto d = make_spend(2, { external });
+    const auto b = make_spend(3, { a.hash() });
+    const auto c = make_spend(4, { b.hash(), external });
+
+    chain::block block;
+    block.set_transactions({ coinbase, c, a, d, b });
+    return block;
+}
+
+BOOST_AUTO_TEST_CASE(block__dependency_levels__empty__empty)
+{
+    const chain::block block;
+    BOOST_REQUIRE(block.dependency_levels().empty());
+    BOOST_REQUIRE(block.dependency_components().empty());
+}
+
+BOOST_AUTO_TEST_CASE(block__dependency_levels__out_of_order_spends__expected)
+{
+    const auto levels = make_dependent_block().dependency_levels();
+    BOOST_REQUIRE_EQUAL(levels.size(), 3u);
+    BOOST_REQUIRE(levels[0] == chain::block::indexes({ 0, 2, 3 }));
+    BOOST_REQUIRE(levels[1] == chain::block::indexes({ 4 }));
+    BOOST_REQUIRE(levels[2] == chain::block::indexes({ 1 }));
+}
+
+BOOST_AUTO_TEST_CASE(block__dependency_levels__diamond__max_parent_depth)
+{
+    const auto external = hash_literal(
+        "00000000000000000000000000000000000000000000000000000000000000ee");
+
+    const auto a = make_spend(1, { external });
+    const auto b = make_spend(2, { a.hash() });
+    const auto c = make_spend(3, { b.hash(), a.hash() });
+
+    // The spend of a by c is visited before that of b.
+    chain::block block;
+    block.set_transactions({ make_spend(0, { null_hash }), c, a, b });
+
+    const auto levels = block.dependency_levels();
+    BOOST_REQUIRE_EQUAL(levels.size(), 3u);
+    BOOST_REQUIRE(levels[0] == chain::block::indexes({ 0, 2 }));
+    BOOST_REQUIRE(levels[1] == chain::block::indexes({ 3 }));
+    BOOST_REQUIRE(levels[2] == chain::block::indexes({ 1 }));
+}
+
+BOOST_AUTO_TEST_CASE(block__dependency_components__out_of_order_spends__expected)
+{
+    const auto components = make_dependent_block().dependency_components();
+    BOOST_REQUIRE_EQUAL(components.size(), 3u);
+    BOOST_REQUIRE(components[0] == chain::block::indexes({ 0 }));
+    BOOST_REQUIRE(components[1] == chain::block::indexes({ 1, 2, 4 }));
+    BOOST_REQUIRE(components[2] == chain::block::indexes({ 3 }));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE(block_is_forward_reference_tests)
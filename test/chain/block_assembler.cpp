@@ -0,0 +1,195 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+static const auto external = hash_literal(
+    "00000000000000000000000000000000000000000000000000000000000000ee");
+
+// Each spend has one input and one output and is 60 bytes.
+static const size_t spend_size = 60;
+
+static chain_state make_state(uint32_t median_time_past,
+    uint64_t magnetic_anomaly_time)
+{
+    static const config::checkpoint::list checkpoints;
+    chain_state::data data;
+    data.height = 1000;
+    data.hash = null_hash;
+    data.allow_collisions_hash = null_hash;
+    data.bip9_bit0_hash = null_hash;
+    data.bip9_bit1_hash = null_hash;
+    data.assume_valid_hash = null_hash;
+    data.bits.self = 0x1d00ffff;
+    data.bits.ordered = { 0x1d00ffff };
+    data.version.self = 1;
+    data.version.ordered = { 1 };
+    data.timestamp.self = median_time_past;
+    data.timestamp.retarget = 0;
+    data.timestamp.ordered = { median_time_past };
+
+    return { std::move(data), checkpoints, 0
+#ifdef BITPRIM_CURRENCY_BCH
+        , magnetic_anomaly_time
+        , bch_great_wall_activation_time
+#endif
+        };
+}
+
+static transaction make_spend(uint32_t locktime, const hash_digest& spent,
+    uint64_t fees, uint32_t sigops=1)
+{
+    return { 1, locktime, { { { spent, 0 }, {}, 0 } }, { { 1, {} } }, sigops,
+        fees };
+}
+
+static transaction make_coinbase()
+{
+    return { 1, 0, { { output_point{ null_hash, point::null_index },
+        script{}, 0 } }, { { 0, {} }, { 7, {} } } };
+}
+
+BOOST_AUTO_TEST_SUITE(block_assembler_tests)
+
+BOOST_AUTO_TEST_CASE(block_assembler__select__independent__by_fee_rate)
+{
+    const block_assembler assembler(make_state(1000, max_uint32));
+    const transaction::list candidates
+    {
+        make_spend(1, external, 100),
+        make_spend(2, external, 300),
+        make_spend(3, external, 200)
+    };
+
+    const auto selected = assembler.select(candidates);
+    BOOST_REQUIRE(selected == block::indexes({ 1, 2, 0 }));
+}
+
+BOOST_AUTO_TEST_CASE(block_assembler__select__child_pays_for_parent__parent_first)
+{
+    const block_assembler assembler(make_state(1000, max_uint32));
+    const auto parent = make_spend(1, external, 0);
+    const auto child = make_spend(2, parent.hash(), 1000);
+    const auto other = make_spend(3, external, 300);
+
+    const auto selected = assembler.select({ child, other, parent });
+    BOOST_REQUIRE(selected == block::indexes({ 2, 0, 1 }));
+}
+
+BOOST_AUTO_TEST_CASE(block_assembler__select__selected_ancestor__descendant_reprioritized)
+{
+    const block_assembler assembler(make_state(1000, max_uint32));
+    const auto parent = make_spend(1, external, 1000);
+    const auto child = make_spend(2, parent.hash(), 600);
+    const auto grandchild = make_spend(3, child.hash(), 1300);
+    const auto other = make_spend(4, external, 960);
+
+    // The grandchild package outranks the other until the parent is selected.
+    const auto selected = assembler.select({ other, grandchild, child,
+        parent });
+    BOOST_REQUIRE(selected == block::indexes({ 3, 0, 2, 1 }));
+}
+
+BOOST_AUTO_TEST_CASE(block_assembler__select__size_limit__skips_packages_that_do_not_fit)
+{
+    // Room for two spends, the child package needs two and pays less.
+    const block_assembler assembler(make_state(1000, max_uint32),
+        2 * spend_size);
+    const auto parent = make_spend(1, external, 0);
+    const auto child = make_spend(2, parent.hash(), 250);
+    const auto high = make_spend(3, external, 300);
+    const auto low = make_spend(4, external, 10);
+
+    const auto selected = assembler.select({ parent, child, high, low });
+    BOOST_REQUIRE(selected == block::indexes({ 2, 3 }));
+}
+
+BOOST_AUTO_TEST_CASE(block_assembler__select__sigop_limit__excludes_excess)
+{
+    const block_assembler assembler(make_state(1000, max_uint32), 0, 5);
+    const transaction::list candidates
+    {
+        make_spend(1, external, 300, 4),
+        make_spend(2, external, 200, 2),
+        make_spend(3, external, 100, 1)
+    };
+
+    const auto selected = assembler.select(candidates);
+    BOOST_REQUIRE(selected == block::indexes({ 0, 2 }));
+}
+
+BOOST_AUTO_TEST_CASE(block_assembler__select__coinbase_and_duplicate__skipped)
+{
+    const block_assembler assembler(make_state(1000, max_uint32));
+    const auto tx = make_spend(1, external, 100);
+
+    const auto selected = assembler.select({ make_coinbase(), tx, tx });
+    BOOST_REQUIRE(selected == block::indexes({ 1 }));
+}
+
+BOOST_AUTO_TEST_CASE(block_assembler__assemble__legacy_order__expected_template)
+{
+    const block_assembler assembler(make_state(1000, max_uint32));
+    const auto parent = make_spend(1, external, 50);
+    const auto child = make_spend(2, parent.hash(), 1000);
+    const auto previous = hash_literal(
+        "000000000019d6689c085ae165831e934ff763ae46a2a6c172b3f1b60a8ce26f");
+
+    const auto block = assembler.assemble(previous, make_coinbase(),
+        { child, parent }, 500);
+
+    const auto& txs = block.transactions();
+    BOOST_REQUIRE_EQUAL(txs.size(), 3u);
+    BOOST_REQUIRE(txs[0].is_coinbase());
+    BOOST_REQUIRE(txs[1].hash() == parent.hash());
+    BOOST_REQUIRE(txs[2].hash() == child.hash());
+    BOOST_REQUIRE_EQUAL(txs[0].outputs()[0].value(),
+        block::subsidy(1000) + 1050 - 7);
+    BOOST_REQUIRE_EQUAL(txs[0].outputs()[1].value(), 7u);
+    BOOST_REQUIRE(block.header().previous_block_hash() == previous);
+    BOOST_REQUIRE(block.header().merkle() == block.generate_merkle_root());
+    BOOST_REQUIRE_EQUAL(block.header().timestamp(), 1001u);
+    BOOST_REQUIRE_EQUAL(block.header().bits(), 0x1d00ffffu);
+    BOOST_REQUIRE(!block.is_forward_reference());
+}
+
+#ifdef BITPRIM_CURRENCY_BCH
+BOOST_AUTO_TEST_CASE(block_assembler__assemble__magnetic_anomaly__canonical_order)
+{
+    const block_assembler assembler(make_state(1000, 0));
+    transaction::list candidates;
+
+    for (uint32_t index = 0; index < 10; ++index)
+        candidates.push_back(make_spend(index, external, index));
+
+    const auto block = assembler.assemble(null_hash, make_coinbase(),
+        candidates, 2000);
+
+    BOOST_REQUIRE_EQUAL(block.transactions().size(), 11u);
+    BOOST_REQUIRE(block.is_canonical_ordered());
+    BOOST_REQUIRE(block.header().merkle() == block.generate_merkle_root());
+    BOOST_REQUIRE_EQUAL(block.header().timestamp(), 2000u);
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,184 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+static const uint32_t test_magic = 0xd9b4bef9;
+
+// Test helpers.
+static chain::block make_child(const chain::block& parent, uint32_t nonce)
+{
+    const auto& tx = parent.transactions();
+    chain::header header(1, parent.hash(), parent.header().merkle(),
+        parent.header().timestamp() + 1, parent.header().bits(), nonce);
+    return { std::move(header), chain::transaction::list(tx) };
+}
+
+static void write_record(std::ofstream& file, const chain::block& block)
+{
+    const auto data = block.to_data();
+    const auto magic = to_little_endian(test_magic);
+    const auto size = to_little_endian(static_cast<uint32_t>(data.size()));
+    file.write(reinterpret_cast<const char*>(magic.data()), magic.size());
+    file.write(reinterpret_cast<const char*>(size.data()), size.size());
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+static void write_bytes(std::ofstream& file, const data_chunk& data)
+{
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+struct block_file_fixture
+{
+    block_file_fixture()
+      : directory(boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path())
+    {
+        boost::filesystem::create_directories(directory);
+    }
+
+    ~block_file_fixture()
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(directory, ec);
+    }
+
+    boost::filesystem::path directory;
+};
+
+BOOST_FIXTURE_TEST_SUITE(block_file_reader_tests, block_file_fixture)
+
+BOOST_AUTO_TEST_CASE(block_file_reader__file_path__number__zero_padded)
+{
+    const auto path = block_file_reader::file_path("blocks", 42);
+    BOOST_REQUIRE_EQUAL(path.filename().string(), "blk00042.dat");
+}
+
+BOOST_AUTO_TEST_CASE(block_file_reader__open__missing__false)
+{
+    block_file_reader reader(test_magic);
+    BOOST_REQUIRE(!reader.open(directory / "missing.dat"));
+    BOOST_REQUIRE_EQUAL(reader.files(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(block_file_reader__open__empty__no_entries)
+{
+    const auto path = block_file_reader::file_path(directory, 0);
+    std::ofstream(path.string(), std::ios::binary).close();
+
+    block_file_reader reader(test_magic);
+    BOOST_REQUIRE(reader.open(path));
+    BOOST_REQUIRE_EQUAL(reader.files(), 1u);
+    BOOST_REQUIRE(reader.entries().empty());
+}
+
+BOOST_AUTO_TEST_CASE(block_file_reader__open__garbage_padding_truncation__expected_entries)
+{
+    const auto genesis = chain::block::genesis_mainnet();
+    const auto child = make_child(genesis, 42);
+    const auto path = block_file_reader::file_path(directory, 0);
+
+    {
+        std::ofstream file(path.string(), std::ios::binary);
+        write_bytes(file, { 0x01, 0x02, 0x03 });
+        write_record(file, genesis);
+        write_bytes(file, data_chunk(64, 0x00));
+        write_record(file, child);
+
+        // Truncated record following valid records.
+        const auto magic = to_little_endian(test_magic);
+        write_bytes(file, { magic.begin(), magic.end() });
+        write_bytes(file, { 0xff, 0xff, 0x00, 0x00, 0x01, 0x02 });
+    }
+
+    block_file_reader reader(test_magic);
+    BOOST_REQUIRE(reader.open(path));
+    const auto& entries = reader.entries();
+    BOOST_REQUIRE_EQUAL(entries.size(), 2u);
+    BOOST_REQUIRE_EQUAL(entries[0].file, 0u);
+    BOOST_REQUIRE_EQUAL(entries[0].offset, 3u + 8u);
+    BOOST_REQUIRE(entries[0].hash() == genesis.hash());
+    BOOST_REQUIRE(entries[1].hash() == child.hash());
+    BOOST_REQUIRE(entries[1].previous_block_hash() == genesis.hash());
+
+    chain::block parsed;
+    BOOST_REQUIRE(entries[1].to_block(parsed));
+    BOOST_REQUIRE(parsed == child);
+    reader.prefetch(entries[1]);
+}
+
+BOOST_AUTO_TEST_CASE(block_file_reader__chain_order__out_of_order_files__longest_branch)
+{
+    const auto genesis = chain::block::genesis_mainnet();
+    const auto block1 = make_child(genesis, 1);
+    const auto block2 = make_child(block1, 2);
+    const auto stale1 = make_child(genesis, 3);
+    const auto orphan = make_child(stale1, 4);
+    const auto orphan_child = make_child(orphan, 5);
+
+    {
+        std::ofstream file(block_file_reader::file_path(directory, 0).string(),
+            std::ios::binary);
+        write_record(file, block2);
+        write_record(file, stale1);
+        write_record(file, genesis);
+    }
+
+    {
+        std::ofstream file(block_file_reader::file_path(directory, 1).string(),
+            std::ios::binary);
+        write_record(file, block1);
+        write_record(file, orphan_child);
+    }
+
+    block_file_reader reader(test_magic);
+    BOOST_REQUIRE_EQUAL(reader.open_directory(directory), 2u);
+    BOOST_REQUIRE_EQUAL(reader.entries().size(), 5u);
+
+    const auto ordered = reader.chain_order(genesis.hash());
+    BOOST_REQUIRE_EQUAL(ordered.size(), 3u);
+    BOOST_REQUIRE(ordered[0].hash() == genesis.hash());
+    BOOST_REQUIRE(ordered[1].hash() == block1.hash());
+    BOOST_REQUIRE_EQUAL(ordered[1].file, 1u);
+    BOOST_REQUIRE(ordered[2].hash() == block2.hash());
+}
+
+BOOST_AUTO_TEST_CASE(block_file_reader__chain_order__missing_start__empty)
+{
+    const auto genesis = chain::block::genesis_mainnet();
+
+    {
+        std::ofstream file(block_file_reader::file_path(directory, 0).string(),
+            std::ios::binary);
+        write_record(file, genesis);
+    }
+
+    block_file_reader reader(test_magic);
+    BOOST_REQUIRE_EQUAL(reader.open_directory(directory), 1u);
+    BOOST_REQUIRE(reader.chain_order(null_hash).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+// Test helper.
+static block_pipeline::read_handler make_reader(const data_stack& blocks)
+{
+    auto position = std::make_shared<size_t>(0);
+    return [=](data_chunk& out)
+    {
+        if (*position == blocks.size())
+            return false;
+
+        out = blocks[(*position)++];
+        return true;
+    };
+}
+
+BOOST_AUTO_TEST_SUITE(block_pipeline_tests)
+
+BOOST_AUTO_TEST_CASE(block_pipeline__run__empty__success)
+{
+    size_t calls = 0;
+    block_pipeline pipeline(2, 2);
+    const auto ec = pipeline.run(make_reader({}),
+        [&](const code&, size_t, block_pipeline::block_ptr)
+        {
+            ++calls;
+            return true;
+        });
+
+    BOOST_REQUIRE_EQUAL(ec, error::success);
+    BOOST_REQUIRE_EQUAL(calls, 0u);
+    BOOST_REQUIRE_EQUAL(pipeline.statistics()[block_pipeline::read].items, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(block_pipeline__run__valid_blocks__in_order_checked)
+{
+    const auto genesis = block::genesis_mainnet();
+    const data_stack blocks(25, genesis.to_data());
+
+    size_t next = 0;
+    block_pipeline pipeline(3, 4);
+    const auto ec = pipeline.run(make_reader(blocks),
+        [&](const code& ec, size_t sequence, block_pipeline::block_ptr block)
+        {
+            BOOST_REQUIRE_EQUAL(ec, error::success);
+            BOOST_REQUIRE_EQUAL(sequence, next++);
+            BOOST_REQUIRE(block);
+            BOOST_REQUIRE(block->hash() == genesis.hash());
+            return true;
+        });
+
+    BOOST_REQUIRE_EQUAL(ec, error::success);
+    BOOST_REQUIRE_EQUAL(next, blocks.size());
+
+    const auto& statistics = pipeline.statistics();
+    for (size_t stage = 0; stage < block_pipeline::stages; ++stage)
+    {
+        BOOST_REQUIRE_EQUAL(statistics[stage].items, blocks.size());
+        BOOST_REQUIRE_EQUAL(statistics[stage].bytes,
+            blocks.size() * blocks.front().size());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(block_pipeline__run__malformed_and_invalid__errors_in_order)
+{
+    const auto genesis = block::genesis_mainnet();
+    auto invalid = genesis;
+    invalid.set_transactions({});
+    const data_stack blocks
+    {
+        genesis.to_data(),
+        { 0x01, 0x02, 0x03 },
+        invalid.to_data(),
+        genesis.to_data()
+    };
+
+    std::vector<code> results;
+    block_pipeline pipeline(2, 2);
+    const auto ec = pipeline.run(make_reader(blocks),
+        [&](const code& ec, size_t, block_pipeline::block_ptr)
+        {
+            results.push_back(ec);
+            return true;
+        });
+
+    BOOST_REQUIRE_EQUAL(ec, error::success);
+    BOOST_REQUIRE_EQUAL(results.size(), 4u);
+    BOOST_REQUIRE_EQUAL(results[0], error::success);
+    BOOST_REQUIRE_EQUAL(results[1], error::bad_stream);
+    BOOST_REQUIRE_EQUAL(results[2], error::empty_block);
+    BOOST_REQUIRE_EQUAL(results[3], error::success);
+}
+
+BOOST_AUTO_TEST_CASE(block_pipeline__run__handler_stops__service_stopped)
+{
+    const auto genesis = block::genesis_mainnet();
+    const data_stack blocks(100, genesis.to_data());
+
+    size_t calls = 0;
+    block_pipeline pipeline(2, 3);
+    const auto ec = pipeline.run(make_reader(blocks),
+        [&](const code&, size_t, block_pipeline::block_ptr)
+        {
+            return ++calls < 2;
+        });
+
+    BOOST_REQUIRE_EQUAL(ec, error::service_stopped);
+    BOOST_REQUIRE_EQUAL(calls, 2u);
+    BOOST_REQUIRE(pipeline.statistics()[block_pipeline::read].items < 10u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,179 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+BOOST_AUTO_TEST_SUITE(bloom_filter_tests)
+
+static const short_hash key_hash = base16_literal(
+    "99108ad8ed9bb6274d3980bab5a85c048f0950c8");
+
+static transaction pay_key_hash(const short_hash& hash, uint32_t locktime)
+{
+    const output::list outputs
+    {
+        { 1000, script(script::to_pay_key_hash_pattern(hash)) }
+    };
+
+    return transaction{ 1, locktime, {}, outputs };
+}
+
+static transaction spend(const transaction& previous, uint32_t index)
+{
+    const input::list inputs
+    {
+        { output_point{ previous.hash(), index }, script{}, max_input_sequence }
+    };
+
+    return transaction{ 1, 0, inputs, {} };
+}
+
+// Test vectors from the satoshi client (bloom_tests.cpp).
+BOOST_AUTO_TEST_CASE(bloom_filter__insert__satoshi_vector__expected_filter)
+{
+    bloom_filter instance(3, 0.01, 0, bloom_filter::update::all);
+    BOOST_REQUIRE(instance.is_valid());
+    BOOST_REQUIRE_EQUAL(instance.hash_functions(), 5u);
+
+    instance.insert(key_hash);
+    BOOST_REQUIRE(instance.contains(key_hash));
+    BOOST_REQUIRE(!instance.contains(base16_literal(
+        "19108ad8ed9bb6274d3980bab5a85c048f0950c8")));
+
+    instance.insert(base16_literal("b5a2c786d9ef4658287ced5914b37a1b4aa32eee"));
+    instance.insert(base16_literal("b9300670b4c5366e95b2699e8b18bc75e5f729c5"));
+    BOOST_REQUIRE_EQUAL(encode_base16(instance.filter()), "614e9b");
+}
+
+BOOST_AUTO_TEST_CASE(bloom_filter__insert__satoshi_vector_with_tweak__expected_filter)
+{
+    bloom_filter instance(3, 0.01, 2147483649u, bloom_filter::update::all);
+    instance.insert(key_hash);
+    instance.insert(base16_literal("b5a2c786d9ef4658287ced5914b37a1b4aa32eee"));
+    instance.insert(base16_literal("b9300670b4c5366e95b2699e8b18bc75e5f729c5"));
+    BOOST_REQUIRE_EQUAL(encode_base16(instance.filter()), "ce4299");
+}
+
+BOOST_AUTO_TEST_CASE(bloom_filter__constructor__filter_load__equals_params)
+{
+    const message::filter_load load({ 0x61, 0x4e, 0x9b }, 5, 0,
+        bloom_filter::update::all);
+    const bloom_filter instance(load);
+    BOOST_REQUIRE(instance.filter() == load.filter());
+    BOOST_REQUIRE_EQUAL(instance.hash_functions(), 5u);
+    BOOST_REQUIRE(instance.contains(key_hash));
+}
+
+BOOST_AUTO_TEST_CASE(bloom_filter__is_valid__excess_functions__false)
+{
+    const bloom_filter instance(data_chunk(10, 0), 51, 0, 0);
+    BOOST_REQUIRE(!instance.is_valid());
+}
+
+BOOST_AUTO_TEST_CASE(bloom_filter__match__empty_and_full__nothing_and_everything)
+{
+    const auto tx = pay_key_hash(key_hash, 0);
+
+    bloom_filter empty;
+    BOOST_REQUIRE(!empty.match(tx));
+
+    bloom_filter full(data_chunk(4, 0xff), 3, 0, 0);
+    BOOST_REQUIRE(full.match(tx));
+}
+
+BOOST_AUTO_TEST_CASE(bloom_filter__match__transaction_hash__true)
+{
+    const auto tx = pay_key_hash(null_short_hash, 0);
+    bloom_filter instance(10, 0.000001, 0, bloom_filter::update::none);
+    BOOST_REQUIRE(!instance.match(tx));
+
+    instance.insert(tx.hash());
+    BOOST_REQUIRE(instance.match(tx));
+}
+
+BOOST_AUTO_TEST_CASE(bloom_filter__match__output_push_update_all__spend_matches)
+{
+    const auto tx = pay_key_hash(key_hash, 0);
+    bloom_filter instance(10, 0.000001, 0, bloom_filter::update::all);
+    instance.insert(key_hash);
+
+    BOOST_REQUIRE(instance.match(tx));
+    BOOST_REQUIRE(instance.contains(output_point{ tx.hash(), 0 }));
+    BOOST_REQUIRE(instance.match(spend(tx, 0)));
+}
+
+BOOST_AUTO_TEST_CASE(bloom_filter__match__output_push_update_none__spend_not_matched)
+{
+    const auto tx = pay_key_hash(key_hash, 0);
+    bloom_filter instance(10, 0.000001, 0, bloom_filter::update::none);
+    instance.insert(key_hash);
+
+    BOOST_REQUIRE(instance.match(tx));
+    BOOST_REQUIRE(!instance.match(spend(tx, 0)));
+}
+
+BOOST_AUTO_TEST_CASE(bloom_filter__match__pay_public_key_only_key_hash__not_updated)
+{
+    const auto tx = pay_key_hash(key_hash, 0);
+    bloom_filter instance(10, 0.000001, 0,
+        bloom_filter::update::pay_public_key_only);
+    instance.insert(key_hash);
+
+    BOOST_REQUIRE(instance.match(tx));
+    BOOST_REQUIRE(!instance.contains(output_point{ tx.hash(), 0 }));
+}
+
+BOOST_AUTO_TEST_CASE(bloom_filter__to_merkle_block__matched__extracts_matched_hashes)
+{
+    block instance;
+    instance.set_transactions(
+    {
+        pay_key_hash(null_short_hash, 0),
+        pay_key_hash(key_hash, 1),
+        pay_key_hash(null_short_hash, 2),
+        pay_key_hash(null_short_hash, 3)
+    });
+
+    // The spend of the matched output is matched by the update.
+    auto txs = instance.transactions();
+    txs[3] = spend(txs[1], 0);
+    instance.set_transactions(txs);
+    instance.header().set_merkle(instance.generate_merkle_root());
+
+    bloom_filter filter(10, 0.000001, 0, bloom_filter::update::all);
+    filter.insert(key_hash);
+
+    transaction::list matched;
+    const auto merkle = filter.to_merkle_block(instance, matched);
+    BOOST_REQUIRE_EQUAL(matched.size(), 2u);
+    BOOST_REQUIRE(matched[0] == txs[1]);
+    BOOST_REQUIRE(matched[1] == txs[3]);
+
+    hash_list hashes;
+    merkle_tree::indexes positions;
+    BOOST_REQUIRE(merkle.extract(hashes, positions));
+    BOOST_REQUIRE(hashes == hash_list({ txs[1].hash(), txs[3].hash() }));
+    BOOST_REQUIRE(positions == merkle_tree::indexes({ 1, 3 }));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
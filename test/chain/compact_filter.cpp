@@ -0,0 +1,129 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+BOOST_AUTO_TEST_SUITE(compact_filter_tests)
+
+static data_stack make_elements(uint32_t first, uint32_t count)
+{
+    data_stack elements;
+
+    for (auto element = first; element < first + count; ++element)
+        elements.push_back(to_chunk(to_little_endian(element)));
+
+    return elements;
+}
+
+// Test vector from BIP158 (testnet block 0).
+BOOST_AUTO_TEST_CASE(compact_filter__block__testnet_genesis__bip158_vector)
+{
+    const auto genesis = block::genesis_testnet();
+    const compact_filter instance(genesis);
+    BOOST_REQUIRE(instance.is_valid());
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+    BOOST_REQUIRE_EQUAL(encode_base16(instance.encoded()), "019dfca8");
+    BOOST_REQUIRE_EQUAL(encode_hash(instance.header(null_hash)),
+        "21584579b7eb08997773e5aeff3a7f932700042d0ed2a6129012b7d7ae81b750");
+
+    const auto& script = genesis.transactions().front().outputs().front()
+        .script();
+    BOOST_REQUIRE(instance.match(script.to_data(false)));
+}
+
+BOOST_AUTO_TEST_CASE(compact_filter__constructor__duplicate_elements__distinct_count)
+{
+    auto elements = make_elements(0, 10);
+    elements.push_back(elements.front());
+    const compact_filter instance(null_hash, elements);
+    BOOST_REQUIRE_EQUAL(instance.size(), 10u);
+}
+
+BOOST_AUTO_TEST_CASE(compact_filter__constructor_encoded__round_trip__matches)
+{
+    const auto hash = bitcoin_hash(to_chunk(std::string("block")));
+    const auto elements = make_elements(0, 100);
+    const compact_filter built(hash, elements);
+    const compact_filter instance(hash, built.encoded());
+
+    BOOST_REQUIRE(instance.is_valid());
+    BOOST_REQUIRE_EQUAL(instance.size(), 100u);
+    BOOST_REQUIRE(instance.hash() == built.hash());
+
+    for (const auto& element: elements)
+        BOOST_REQUIRE(instance.match(element));
+}
+
+BOOST_AUTO_TEST_CASE(compact_filter__match_any__members_and_non_members__expected)
+{
+    const compact_filter instance(null_hash, make_elements(0, 100));
+    BOOST_REQUIRE(!instance.match_any(make_elements(1000, 50)));
+
+    auto queries = make_elements(1000, 50);
+    queries.push_back(make_elements(42, 1).front());
+    BOOST_REQUIRE(instance.match_any(queries));
+}
+
+BOOST_AUTO_TEST_CASE(compact_filter__constructor_encoded__truncated__invalid)
+{
+    const compact_filter built(null_hash, make_elements(0, 100));
+    auto encoded = built.encoded();
+    encoded.resize(encoded.size() / 2);
+
+    const compact_filter instance(null_hash, std::move(encoded));
+    BOOST_REQUIRE(!instance.is_valid());
+    BOOST_REQUIRE(!instance.match(make_elements(0, 1).front()));
+}
+
+BOOST_AUTO_TEST_CASE(compact_filter__header__chained__depends_on_previous)
+{
+    const compact_filter instance(null_hash, make_elements(0, 10));
+    const auto first = instance.header(null_hash);
+    BOOST_REQUIRE(instance.header(first) != first);
+    BOOST_REQUIRE(instance.header(first) ==
+        bitcoin_hash(build_chunk({ instance.hash(), first })));
+}
+
+BOOST_AUTO_TEST_CASE(compact_filter__block__spent_prevout_script__matched)
+{
+    const script spent(script::to_pay_key_hash_pattern(null_short_hash));
+    output_point prevout{ null_hash, 0 };
+    prevout.validation.cache = output{ 1000, spent };
+
+    const input::list inputs
+    {
+        { std::move(prevout), script{}, max_input_sequence }
+    };
+
+    const transaction coinbase{ 1, 0, { input{ output_point{ null_hash,
+        point::null_index }, script{}, max_input_sequence } }, {} };
+
+    block instance;
+    instance.set_transactions({ coinbase, transaction{ 1, 0, inputs, {} } });
+
+    const compact_filter filter(instance);
+    BOOST_REQUIRE_EQUAL(filter.size(), 1u);
+    BOOST_REQUIRE(filter.match(spent.to_data(false)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
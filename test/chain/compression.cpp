@@ -0,0 +1,204 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+static const auto tx_hash = hash_literal(
+    "4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b");
+
+static const auto other_hash = hash_literal(
+    "0e3e2357e806b6cdb1f70b54c3a3a17b6714ee1f0e68bebb44a74b1efd512098");
+
+static script make_script(const std::string& hex)
+{
+    data_chunk bytes;
+    BOOST_REQUIRE(decode_base16(bytes, hex));
+    return script(bytes, false);
+}
+
+static void require_round_trip(const script& value, size_t expected_size)
+{
+    data_chunk data;
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    to_compressed_data(sink, value);
+    ostream.flush();
+    BOOST_REQUIRE_EQUAL(data.size(), expected_size);
+
+    script restored;
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    BOOST_REQUIRE(from_compressed_data(source, restored));
+    BOOST_REQUIRE(restored == value);
+}
+
+BOOST_AUTO_TEST_SUITE(compression_tests)
+
+BOOST_AUTO_TEST_CASE(compression__compress_amount__reference_values__expected)
+{
+    BOOST_REQUIRE_EQUAL(compress_amount(0), 0u);
+    BOOST_REQUIRE_EQUAL(compress_amount(1), 1u);
+    BOOST_REQUIRE_EQUAL(compress_amount(1000000), 7u);
+    BOOST_REQUIRE_EQUAL(compress_amount(100000000), 9u);
+    BOOST_REQUIRE_EQUAL(compress_amount(5000000000), 50u);
+    BOOST_REQUIRE_EQUAL(compress_amount(2100000000000000), 21000000u);
+}
+
+BOOST_AUTO_TEST_CASE(compression__decompress_amount__round_trip__expected)
+{
+    const std::vector<uint64_t> values
+    {
+        0, 1, 9, 10, 123456789, 100000000, 2100000000000000, max_money(),
+        max_uint64 / 9 - 1
+    };
+
+    for (const auto value: values)
+    {
+        uint64_t restored;
+        BOOST_REQUIRE(decompress_amount(restored, compress_amount(value)));
+        BOOST_REQUIRE_EQUAL(restored, value);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(compression__decompress_amount__overflow__false)
+{
+    uint64_t out;
+    BOOST_REQUIRE(!decompress_amount(out, max_uint64));
+}
+
+BOOST_AUTO_TEST_CASE(compression__script__pay_key_hash__21_bytes)
+{
+    require_round_trip(make_script(
+        "76a914a2fb7a20d6b0c0f6bdf38d3b8ab3b2c0e9a2b6d488ac"), 21);
+}
+
+BOOST_AUTO_TEST_CASE(compression__script__pay_script_hash__21_bytes)
+{
+    require_round_trip(make_script(
+        "a914a2fb7a20d6b0c0f6bdf38d3b8ab3b2c0e9a2b6d487"), 21);
+}
+
+BOOST_AUTO_TEST_CASE(compression__script__pay_compressed_key__33_bytes)
+{
+    require_round_trip(make_script(
+        "2102a2fb7a20d6b0c0f6bdf38d3b8ab3b2c0e9a2b6d4a2fb7a20d6b0c0f6bdf38d3bac"),
+        33);
+}
+
+BOOST_AUTO_TEST_CASE(compression__script__nonstandard__raw_with_prefix)
+{
+    const auto value = make_script("6a0401020304");
+    require_round_trip(value, 1 + value.serialized_size(false));
+}
+
+BOOST_AUTO_TEST_CASE(compression__script__empty__one_byte)
+{
+    require_round_trip({}, 1);
+}
+
+BOOST_AUTO_TEST_CASE(compression__output__round_trip__expected)
+{
+    const output value(5000000000, make_script(
+        "76a914a2fb7a20d6b0c0f6bdf38d3b8ab3b2c0e9a2b6d488ac"));
+    const auto data = to_compressed_data(value);
+    BOOST_REQUIRE_EQUAL(data.size(), 1u + 21u);
+
+    output restored;
+    BOOST_REQUIRE(from_compressed_data(data, restored));
+    BOOST_REQUIRE(restored == value);
+}
+
+BOOST_AUTO_TEST_CASE(compression__output__oversized_script__false)
+{
+    data_chunk data;
+    BOOST_REQUIRE(decode_base16(data, "00ff7f7f7f7f7f7f7f7f"));
+
+    output restored;
+    BOOST_REQUIRE(!from_compressed_data(data, restored));
+}
+
+BOOST_AUTO_TEST_CASE(compression__transaction__round_trip__expected)
+{
+    const auto pay = make_script(
+        "76a914a2fb7a20d6b0c0f6bdf38d3b8ab3b2c0e9a2b6d488ac");
+    const auto sign = make_script("0401020304");
+
+    const transaction value(1, 0,
+        input::list
+        {
+            { { tx_hash, 0 }, sign, max_input_sequence },
+            { { other_hash, 3 }, sign, 42 },
+            { { tx_hash, 1 }, sign, max_input_sequence }
+        },
+        output::list
+        {
+            { 100000, pay },
+            { 12345, make_script("6a0401020304") }
+        });
+
+    const auto data = to_compressed_data(value);
+    BOOST_REQUIRE_LT(data.size(), value.serialized_size(true));
+    BOOST_REQUIRE_LT(data.size(), value.serialized_size(false));
+
+    transaction restored;
+    BOOST_REQUIRE(from_compressed_data(data, restored));
+    BOOST_REQUIRE(restored == value);
+    BOOST_REQUIRE(restored.to_data() == value.to_data());
+}
+
+BOOST_AUTO_TEST_CASE(compression__transaction__repeated_point_hash__written_once)
+{
+    const transaction single(1, 0,
+        input::list{ { { tx_hash, 0 }, {}, 0 } }, output::list{});
+    const transaction repeated(1, 0,
+        input::list{ { { tx_hash, 0 }, {}, 0 }, { { tx_hash, 1 }, {}, 0 } },
+        output::list{});
+
+    const auto single_size = to_compressed_data(single).size();
+    const auto repeated_size = to_compressed_data(repeated).size();
+
+    // The second input is a tag, an index, an empty script and a sequence.
+    BOOST_REQUIRE_EQUAL(repeated_size - single_size, 1u + 1u + 1u + 5u);
+}
+
+BOOST_AUTO_TEST_CASE(compression__transaction__truncated__false)
+{
+    const transaction value(1, 0,
+        input::list{ { { tx_hash, 0 }, {}, max_input_sequence } },
+        output::list{ { 1, {} } });
+
+    auto data = to_compressed_data(value);
+    data.pop_back();
+
+    transaction restored;
+    BOOST_REQUIRE(!from_compressed_data(data, restored));
+}
+
+BOOST_AUTO_TEST_CASE(compression__transaction__invalid_point_reference__false)
+{
+    // version, locktime, no outputs, one input referencing hash ordinal one.
+    const data_chunk data{ 0x01, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00 };
+
+    transaction restored;
+    BOOST_REQUIRE(!from_compressed_data(data, restored));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
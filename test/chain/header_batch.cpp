@@ -0,0 +1,191 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+// Regtest proof of work, without retargeting.
+static const uint32_t easy_bits = 0x207fffff;
+static const uint32_t start_time = 1500000000;
+
+static const auto parent_hash = hash_literal(
+    "0f9188f13cb7b2c71f2a335e3a4fc328bf5beb436012afca590b1a11466e2206");
+
+static chain_state make_parent()
+{
+    static const config::checkpoint::list checkpoints;
+    chain_state::data data;
+    data.height = 100;
+    data.hash = parent_hash;
+    data.allow_collisions_hash = null_hash;
+    data.bip9_bit0_hash = null_hash;
+    data.bip9_bit1_hash = null_hash;
+    data.assume_valid_hash = null_hash;
+    data.bits.self = easy_bits;
+    data.bits.ordered = { easy_bits };
+    data.version.self = 1;
+    data.version.ordered = { 1 };
+    data.timestamp.self = start_time;
+    data.timestamp.retarget = 0;
+    data.timestamp.ordered = { start_time };
+
+    return { std::move(data), checkpoints, 0
+#ifdef BITPRIM_CURRENCY_BCH
+        , bch_magnetic_anomaly_activation_time
+        , bch_great_wall_activation_time
+#endif
+        };
+}
+
+// Search nonces until the header satisfies its claimed work.
+static header mine(const hash_digest& previous, uint32_t timestamp,
+    uint32_t bits=easy_bits)
+{
+    header out(1, previous, null_hash, timestamp, bits, 0);
+
+    while (!out.is_valid_proof_of_work(false))
+        out.set_nonce(out.nonce() + 1);
+
+    return out;
+}
+
+static header::list make_chain(size_t count)
+{
+    header::list headers;
+    auto previous = parent_hash;
+
+    for (size_t index = 0; index < count; ++index)
+    {
+        headers.push_back(mine(previous, start_time + index + 1));
+        previous = headers.back().hash();
+    }
+
+    return headers;
+}
+
+BOOST_AUTO_TEST_SUITE(header_batch_tests)
+
+BOOST_AUTO_TEST_CASE(header_batch__validate__empty__success_no_top)
+{
+    header_batch batch(2);
+    BOOST_REQUIRE_EQUAL(batch.validate(make_parent(), header::list{}),
+        error::success);
+    BOOST_REQUIRE_EQUAL(batch.valid(), 0u);
+    BOOST_REQUIRE(batch.hashes().empty());
+    BOOST_REQUIRE(!batch.top());
+}
+
+BOOST_AUTO_TEST_CASE(header_batch__validate__linked_chain__expected_top)
+{
+    const auto parent = make_parent();
+    const auto headers = make_chain(200);
+    header_batch batch(4);
+
+    BOOST_REQUIRE_EQUAL(batch.validate(parent, headers), error::success);
+    BOOST_REQUIRE_EQUAL(batch.valid(), 200u);
+    BOOST_REQUIRE_EQUAL(batch.hashes().size(), 200u);
+
+    for (size_t index = 0; index < headers.size(); ++index)
+        BOOST_REQUIRE(batch.hashes()[index] == headers[index].hash());
+
+    // The batch state matches the state promoted one header at a time.
+    auto expected = std::make_shared<chain_state>(parent, headers.front());
+
+    for (auto it = std::next(headers.begin()); it != headers.end(); ++it)
+        expected = std::make_shared<chain_state>(*expected, *it);
+
+    const auto top = batch.top();
+    BOOST_REQUIRE(top);
+    BOOST_REQUIRE_EQUAL(top->height(), 300u);
+    BOOST_REQUIRE_EQUAL(top->median_time_past(), expected->median_time_past());
+    BOOST_REQUIRE_EQUAL(top->work_required(), expected->work_required());
+    BOOST_REQUIRE_EQUAL(top->minimum_version(), expected->minimum_version());
+    BOOST_REQUIRE_EQUAL(top->enabled_forks(), expected->enabled_forks());
+}
+
+BOOST_AUTO_TEST_CASE(header_batch__validate__broken_link__orphan_block)
+{
+    auto headers = make_chain(10);
+    headers[6] = mine(null_hash, start_time + 7);
+    header_batch batch;
+
+    BOOST_REQUIRE_EQUAL(batch.validate(make_parent(), headers),
+        error::orphan_block);
+    BOOST_REQUIRE_EQUAL(batch.valid(), 6u);
+    BOOST_REQUIRE_EQUAL(batch.top()->height(), 106u);
+}
+
+BOOST_AUTO_TEST_CASE(header_batch__validate__insufficient_work__invalid_proof_of_work)
+{
+    auto headers = make_chain(3);
+    auto bad = mine(headers[1].hash(), start_time + 3);
+
+    // Claim more work than was performed.
+    while (bad.is_valid_proof_of_work(false))
+        bad.set_nonce(bad.nonce() + 1);
+
+    headers[2] = bad;
+    header_batch batch;
+
+    BOOST_REQUIRE_EQUAL(batch.validate(make_parent(), headers),
+        error::invalid_proof_of_work);
+    BOOST_REQUIRE_EQUAL(batch.valid(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(header_batch__validate__unexpected_bits__incorrect_proof_of_work)
+{
+    auto headers = make_chain(1);
+    headers.push_back(mine(headers[0].hash(), start_time + 2, 0x207ffffe));
+    header_batch batch;
+
+    BOOST_REQUIRE_EQUAL(batch.validate(make_parent(), headers),
+        error::incorrect_proof_of_work);
+    BOOST_REQUIRE_EQUAL(batch.valid(), 1u);
+    BOOST_REQUIRE_EQUAL(batch.top()->height(), 101u);
+}
+
+BOOST_AUTO_TEST_CASE(header_batch__validate__timestamp_at_median__timestamp_too_early)
+{
+    const header::list headers{ mine(parent_hash, start_time) };
+    header_batch batch;
+
+    BOOST_REQUIRE_EQUAL(batch.validate(make_parent(), headers),
+        error::timestamp_too_early);
+    BOOST_REQUIRE_EQUAL(batch.valid(), 0u);
+    BOOST_REQUIRE(!batch.top());
+}
+
+BOOST_AUTO_TEST_CASE(header_batch__validate__headers_message__success)
+{
+    std::vector<message::header> headers;
+
+    for (const auto& header: make_chain(5))
+        headers.emplace_back(header);
+
+    header_batch batch;
+    BOOST_REQUIRE_EQUAL(batch.validate(make_parent(), headers),
+        error::success);
+    BOOST_REQUIRE_EQUAL(batch.valid(), 5u);
+    BOOST_REQUIRE(batch.hashes().back() == headers.back().hash());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,137 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+BOOST_AUTO_TEST_SUITE(iblt_tests)
+
+static const uint32_t seed = 0x2a;
+
+BOOST_AUTO_TEST_CASE(iblt__constructor__default__invalid)
+{
+    const iblt instance;
+    BOOST_REQUIRE(!instance.is_valid());
+    BOOST_REQUIRE_EQUAL(instance.cells(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(iblt__constructor__capacity__cells_partitioned)
+{
+    const iblt instance(100, seed);
+    BOOST_REQUIRE(instance.is_valid());
+    BOOST_REQUIRE_EQUAL(instance.hash_functions(), iblt::default_hash_functions);
+    BOOST_REQUIRE_GE(instance.cells(), 150u);
+    BOOST_REQUIRE_EQUAL(instance.cells() % instance.hash_functions(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(iblt__decode__inserted_and_erased__both_recovered)
+{
+    iblt instance(50, seed);
+
+    for (uint64_t key = 1; key <= 30; ++key)
+        instance.insert(key * 0x9e3779b97f4a7c15);
+
+    for (uint64_t key = 31; key <= 50; ++key)
+        instance.erase(key * 0x9e3779b97f4a7c15);
+
+    iblt::keys inserted;
+    iblt::keys erased;
+    BOOST_REQUIRE(instance.decode(inserted, erased));
+    BOOST_REQUIRE_EQUAL(inserted.size(), 30u);
+    BOOST_REQUIRE_EQUAL(erased.size(), 20u);
+
+    BOOST_REQUIRE(std::find(inserted.begin(), inserted.end(),
+        0x9e3779b97f4a7c15) != inserted.end());
+}
+
+BOOST_AUTO_TEST_CASE(iblt__subtract__large_sets_small_difference__difference_decoded)
+{
+    iblt sender(10, seed);
+    iblt receiver(10, seed);
+
+    for (uint64_t key = 0; key < 10000; ++key)
+    {
+        if (key != 17)
+            receiver.insert(key);
+
+        if (key != 4242)
+            sender.insert(key);
+    }
+
+    BOOST_REQUIRE(sender.subtract(receiver));
+
+    iblt::keys inserted;
+    iblt::keys erased;
+    BOOST_REQUIRE(sender.decode(inserted, erased));
+    BOOST_REQUIRE(inserted == iblt::keys{ 17 });
+    BOOST_REQUIRE(erased == iblt::keys{ 4242 });
+}
+
+BOOST_AUTO_TEST_CASE(iblt__subtract__incompatible__false)
+{
+    iblt instance(10, seed);
+    BOOST_REQUIRE(!instance.subtract(iblt(10, seed + 1)));
+    BOOST_REQUIRE(!instance.subtract(iblt(20, seed)));
+}
+
+BOOST_AUTO_TEST_CASE(iblt__decode__over_capacity__false)
+{
+    iblt instance(4, seed);
+
+    for (uint64_t key = 0; key < 1000; ++key)
+        instance.insert(key);
+
+    iblt::keys inserted;
+    iblt::keys erased;
+    BOOST_REQUIRE(!instance.decode(inserted, erased));
+}
+
+BOOST_AUTO_TEST_CASE(iblt__from_data__to_data__round_trip)
+{
+    iblt expected(20, seed);
+
+    for (uint64_t key = 0; key < 15; ++key)
+        expected.insert(key);
+
+    data_chunk data;
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    expected.to_data(sink);
+    ostream.flush();
+    BOOST_REQUIRE_EQUAL(data.size(), expected.serialized_size());
+
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    iblt instance;
+    BOOST_REQUIRE(instance.from_data(source));
+    BOOST_REQUIRE(instance == expected);
+}
+
+BOOST_AUTO_TEST_CASE(iblt__from_data__insufficient_bytes__invalid)
+{
+    const data_chunk data{ 0x03, 0x03, 0x2a, 0x00, 0x00, 0x00, 0x01 };
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    iblt instance;
+    BOOST_REQUIRE(!instance.from_data(source));
+    BOOST_REQUIRE(!instance.is_valid());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
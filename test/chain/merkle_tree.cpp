@@ -0,0 +1,263 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+BOOST_AUTO_TEST_SUITE(merkle_tree_tests)
+
+static hash_list make_leaves(size_t count)
+{
+    hash_list leaves;
+
+    for (uint32_t leaf = 0; leaf < count; ++leaf)
+        leaves.push_back(bitcoin_hash(to_chunk(to_little_endian(leaf))));
+
+    return leaves;
+}
+
+// The level by level computation of block::generate_merkle_root.
+static hash_digest expected_root(hash_list merkle)
+{
+    if (merkle.empty())
+        return null_hash;
+
+    while (merkle.size() > 1)
+    {
+        if (merkle.size() % 2 != 0)
+            merkle.push_back(merkle.back());
+
+        hash_list update;
+
+        for (auto it = merkle.begin(); it != merkle.end(); it += 2)
+            update.push_back(bitcoin_hash(build_chunk({ it[0], it[1] })));
+
+        merkle.swap(update);
+    }
+
+    return merkle.front();
+}
+
+static block make_block(size_t count)
+{
+    transaction::list transactions;
+
+    for (uint32_t tx = 0; tx < count; ++tx)
+        transactions.push_back(transaction{ 1, tx, {}, {} });
+
+    block instance;
+    instance.set_transactions(std::move(transactions));
+    return instance;
+}
+
+BOOST_AUTO_TEST_CASE(merkle_tree__root__empty__null_hash)
+{
+    const merkle_tree instance(hash_list{});
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(instance.root() == null_hash);
+    BOOST_REQUIRE(instance.branch(0).empty());
+}
+
+BOOST_AUTO_TEST_CASE(merkle_tree__root__sizes__matches_level_by_level_root)
+{
+    for (size_t count = 1; count <= 33; ++count)
+    {
+        const auto leaves = make_leaves(count);
+        const merkle_tree instance(leaves);
+        BOOST_REQUIRE_EQUAL(instance.size(), count);
+        BOOST_REQUIRE(instance.root() == expected_root(leaves));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(merkle_tree__branch__every_leaf__branch_root_is_root)
+{
+    const auto leaves = make_leaves(11);
+    const merkle_tree instance(leaves);
+
+    for (size_t position = 0; position < leaves.size(); ++position)
+    {
+        const auto branch = instance.branch(position);
+        BOOST_REQUIRE_EQUAL(branch.size(), 4u);
+        BOOST_REQUIRE(merkle_tree::branch_root(leaves[position], branch,
+            position) == instance.root());
+    }
+
+    BOOST_REQUIRE(instance.branch(leaves.size()).empty());
+}
+
+BOOST_AUTO_TEST_CASE(merkle_tree__branch__wrong_position__different_root)
+{
+    const auto leaves = make_leaves(8);
+    const merkle_tree instance(leaves);
+    const auto branch = instance.branch(2);
+    BOOST_REQUIRE(merkle_tree::branch_root(leaves[2], branch, 3) !=
+        instance.root());
+}
+
+BOOST_AUTO_TEST_CASE(merkle_tree__partial__match_patterns__extract_round_trips)
+{
+    for (size_t count = 1; count <= 20; ++count)
+    {
+        const auto leaves = make_leaves(count);
+        const merkle_tree instance(leaves);
+
+        for (size_t stride = 1; stride <= 4; ++stride)
+        {
+            merkle_tree::matches matched(count, false);
+            merkle_tree::indexes expected_positions;
+            hash_list expected_hashes;
+
+            for (size_t position = count % stride; position < count;
+                position += stride)
+            {
+                matched[position] = true;
+                expected_positions.push_back(position);
+                expected_hashes.push_back(leaves[position]);
+            }
+
+            hash_list hashes;
+            data_chunk flags;
+            BOOST_REQUIRE(instance.partial(matched, hashes, flags));
+
+            hash_digest root;
+            hash_list extracted;
+            merkle_tree::indexes positions;
+            BOOST_REQUIRE(merkle_tree::extract(count, hashes, flags, root,
+                extracted, positions));
+            BOOST_REQUIRE(root == instance.root());
+            BOOST_REQUIRE(extracted == expected_hashes);
+            BOOST_REQUIRE(positions == expected_positions);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(merkle_tree__partial__no_matches__root_only)
+{
+    const merkle_tree instance(make_leaves(7));
+    hash_list hashes;
+    data_chunk flags;
+    BOOST_REQUIRE(instance.partial(merkle_tree::matches(7, false), hashes,
+        flags));
+    BOOST_REQUIRE_EQUAL(hashes.size(), 1u);
+    BOOST_REQUIRE(hashes.front() == instance.root());
+    BOOST_REQUIRE(flags == data_chunk{ 0x00 });
+}
+
+BOOST_AUTO_TEST_CASE(merkle_tree__partial__match_count_mismatch__false)
+{
+    const merkle_tree instance(make_leaves(7));
+    hash_list hashes;
+    data_chunk flags;
+    BOOST_REQUIRE(!instance.partial(merkle_tree::matches(6, true), hashes,
+        flags));
+}
+
+BOOST_AUTO_TEST_CASE(merkle_tree__extract__surplus_hash_or_flags__false)
+{
+    const merkle_tree instance(make_leaves(9));
+    merkle_tree::matches matched(9, false);
+    matched[4] = true;
+
+    hash_list hashes;
+    data_chunk flags;
+    BOOST_REQUIRE(instance.partial(matched, hashes, flags));
+
+    hash_digest root;
+    hash_list extracted;
+    merkle_tree::indexes positions;
+
+    auto extra_hash = hashes;
+    extra_hash.push_back(null_hash);
+    BOOST_REQUIRE(!merkle_tree::extract(9, extra_hash, flags, root, extracted,
+        positions));
+
+    auto extra_flags = flags;
+    extra_flags.push_back(0x00);
+    BOOST_REQUIRE(!merkle_tree::extract(9, hashes, extra_flags, root,
+        extracted, positions));
+
+    BOOST_REQUIRE(!merkle_tree::extract(0, hashes, flags, root, extracted,
+        positions));
+}
+
+BOOST_AUTO_TEST_CASE(merkle_tree__extract__duplicate_siblings__false)
+{
+    const auto leaf = make_leaves(1).front();
+    hash_digest root;
+    hash_list extracted;
+    merkle_tree::indexes positions;
+
+    // Root, left and right all flagged, with identical leaves (CVE-2012-2459).
+    BOOST_REQUIRE(!merkle_tree::extract(2, { leaf, leaf }, { 0x07 }, root,
+        extracted, positions));
+}
+
+BOOST_AUTO_TEST_CASE(merkle_tree__block__to_merkle_tree__cached_and_reset)
+{
+    auto instance = make_block(5);
+    const auto tree = instance.to_merkle_tree();
+    BOOST_REQUIRE(tree->root() == instance.generate_merkle_root());
+    BOOST_REQUIRE(instance.to_merkle_tree() == tree);
+    BOOST_REQUIRE(instance.merkle_branch(3) == tree->branch(3));
+
+    instance.set_transactions(make_block(6).transactions());
+    BOOST_REQUIRE(instance.to_merkle_tree() != tree);
+    BOOST_REQUIRE(instance.to_merkle_tree()->root() ==
+        instance.generate_merkle_root());
+}
+
+BOOST_AUTO_TEST_CASE(merkle_tree__block__merkle_branch__reset_by_mutable_transactions)
+{
+    auto instance = make_block(5);
+    const auto branch = instance.merkle_branch(2);
+
+    instance.transactions()[3].set_locktime(42);
+    const merkle_tree expected(instance.to_hashes());
+    BOOST_REQUIRE(instance.merkle_branch(2) != branch);
+    BOOST_REQUIRE(instance.merkle_branch(2) == expected.branch(2));
+    BOOST_REQUIRE(instance.to_merkle_tree()->root() == expected.root());
+}
+
+BOOST_AUTO_TEST_CASE(merkle_tree__block__to_merkle_tree__reset_by_from_data)
+{
+    const auto first = make_block(5);
+    const auto second = make_block(6);
+
+    block instance;
+    BOOST_REQUIRE(instance.from_data(first.to_data()));
+    BOOST_REQUIRE(instance.to_merkle_tree()->root() ==
+        first.generate_merkle_root());
+
+    BOOST_REQUIRE(instance.from_data(second.to_data()));
+    BOOST_REQUIRE_EQUAL(instance.serialized_size(), second.serialized_size());
+    BOOST_REQUIRE(instance.to_merkle_tree()->root() ==
+        second.generate_merkle_root());
+}
+
+BOOST_AUTO_TEST_CASE(merkle_tree__block__genesis__header_merkle_root)
+{
+    const auto genesis = block::genesis_mainnet();
+    BOOST_REQUIRE(genesis.to_merkle_tree()->root() ==
+        genesis.header().merkle());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,103 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+BOOST_AUTO_TEST_SUITE(rolling_bloom_filter_tests)
+
+static hash_digest make_hash(uint32_t value)
+{
+    return sha256_hash(to_chunk(to_little_endian(value)));
+}
+
+BOOST_AUTO_TEST_CASE(rolling_bloom_filter__constructor__rate__expected_hash_functions)
+{
+    const rolling_bloom_filter instance(50000, 0.000001);
+    BOOST_REQUIRE_EQUAL(instance.hash_functions(), 20u);
+    BOOST_REQUIRE(instance.words() != 0u);
+    BOOST_REQUIRE_EQUAL(instance.words() % 2u, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(rolling_bloom_filter__constructor__extreme_rates__clamped)
+{
+    BOOST_REQUIRE_EQUAL(rolling_bloom_filter(10, 0.9).hash_functions(), 1u);
+    BOOST_REQUIRE_EQUAL(rolling_bloom_filter(10, 1e-30).hash_functions(),
+        rolling_bloom_filter::max_hash_functions);
+}
+
+BOOST_AUTO_TEST_CASE(rolling_bloom_filter__contains__inserted__true)
+{
+    rolling_bloom_filter instance(100, 0.000001);
+    BOOST_REQUIRE(!instance.contains(make_hash(1)));
+
+    instance.insert(make_hash(1));
+    instance.insert(make_hash(2));
+    BOOST_REQUIRE(instance.contains(make_hash(1)));
+    BOOST_REQUIRE(instance.contains(make_hash(2)));
+    BOOST_REQUIRE(!instance.contains(make_hash(3)));
+}
+
+BOOST_AUTO_TEST_CASE(rolling_bloom_filter__insert__beyond_elements__retains_latest_evicts_oldest)
+{
+    const size_t elements = 100;
+    rolling_bloom_filter instance(elements, 0.001);
+
+    for (uint32_t value = 0; value < 10 * elements; ++value)
+        instance.insert(make_hash(value));
+
+    for (uint32_t value = 9 * elements; value < 10 * elements; ++value)
+        BOOST_REQUIRE(instance.contains(make_hash(value)));
+
+    size_t retained = 0;
+    for (uint32_t value = 0; value < elements; ++value)
+        if (instance.contains(make_hash(value)))
+            ++retained;
+
+    BOOST_REQUIRE_LT(retained, 10u);
+}
+
+BOOST_AUTO_TEST_CASE(rolling_bloom_filter__contains__not_inserted__within_false_positive_rate)
+{
+    const size_t elements = 1000;
+    rolling_bloom_filter instance(elements, 0.01);
+
+    for (uint32_t value = 0; value < 3 * elements; ++value)
+        instance.insert(make_hash(value));
+
+    size_t false_positives = 0;
+    for (uint32_t value = 1000000; value < 1010000; ++value)
+        if (instance.contains(make_hash(value)))
+            ++false_positives;
+
+    BOOST_REQUIRE_LT(false_positives, 200u);
+}
+
+BOOST_AUTO_TEST_CASE(rolling_bloom_filter__reset__inserted__not_contained)
+{
+    rolling_bloom_filter instance(100, 0.000001);
+    instance.insert(make_hash(1));
+    instance.reset();
+    BOOST_REQUIRE(!instance.contains(make_hash(1)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -408,6 +408,60 @@ BOOST_AUTO_TEST_CASE(script__pattern__17_of_17_multisig__non_standard)
     BOOST_REQUIRE(instance.pattern() == machine::script_pattern::non_standard);
 }
 
+// find_and_delete
+
+BOOST_AUTO_TEST_CASE(script__find_and_delete__no_match__unchanged)
+{
+    script instance;
+    BOOST_REQUIRE(instance.from_string("[aabb] dup [ccdd] drop"));
+    const auto expected = instance.to_data(false);
+    instance.find_and_delete({ { 0xaa }, { 0xbb, 0xcc } });
+    BOOST_REQUIRE(instance.to_data(false) == expected);
+    BOOST_REQUIRE_EQUAL(instance.size(), 4u);
+}
+
+BOOST_AUTO_TEST_CASE(script__find_and_delete__empty_endorsement__unchanged)
+{
+    script instance;
+    BOOST_REQUIRE(instance.from_string("0 [aabb] 0"));
+    const auto expected = instance.to_data(false);
+    instance.find_and_delete({ {} });
+    BOOST_REQUIRE(instance.to_data(false) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(script__find_and_delete__multiple_endorsements__all_deleted)
+{
+    script instance;
+    BOOST_REQUIRE(instance.from_string("[aabb] dup [ccdd] [aabb] [ccdd] drop [aabb]"));
+    instance.find_and_delete({ { 0xaa, 0xbb }, { 0xcc, 0xdd } });
+    BOOST_REQUIRE_EQUAL(instance.to_string(rule_fork::no_rules), "dup drop");
+}
+
+BOOST_AUTO_TEST_CASE(script__find_and_delete__non_minimal_push__not_deleted)
+{
+    script instance;
+    BOOST_REQUIRE(instance.from_string("[1.aabb] [aabb] dup"));
+    instance.find_and_delete({ { 0xaa, 0xbb } });
+    BOOST_REQUIRE_EQUAL(instance.to_string(rule_fork::no_rules), "[1.aabb] dup");
+}
+
+BOOST_AUTO_TEST_CASE(script__find_and_delete__embedded_in_push__not_deleted)
+{
+    script instance;
+    BOOST_REQUIRE(instance.from_string("[02aabb] [aabb]"));
+    instance.find_and_delete({ { 0xaa, 0xbb } });
+    BOOST_REQUIRE_EQUAL(instance.to_string(rule_fork::no_rules), "[02aabb]");
+}
+
+BOOST_AUTO_TEST_CASE(script__find_and_delete__truncated_trailing_op__retained)
+{
+    // [aabb] dup [aabb] followed by a push_size_3 truncated after one byte.
+    const auto data = to_chunk(base16_literal("02aabb7602aabb03ff"));
+    script instance(data, false);
+    instance.find_and_delete({ { 0xaa, 0xbb } });
+    BOOST_REQUIRE_EQUAL(encode_base16(instance.to_data(false)), "7603ff");
+}
+
 // Data-driven tests.
 //------------------------------------------------------------------------------
 
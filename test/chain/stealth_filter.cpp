@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+BOOST_AUTO_TEST_SUITE(stealth_filter_tests)
+
+static bool is_prefix_of_any(const stealth_filter::list& filters,
+    uint32_t prefix)
+{
+    for (const auto& filter: filters)
+        if (filter.is_prefix_of(prefix))
+            return true;
+
+    return false;
+}
+
+static void require_equivalent(const stealth_filter::list& filters)
+{
+    const stealth_filter instance(filters);
+    uint32_t prefix = 0x9e3779b9;
+
+    for (size_t count = 0; count < 4096; ++count)
+    {
+        BOOST_REQUIRE_EQUAL(instance.matches(prefix),
+            is_prefix_of_any(filters, prefix));
+        prefix = prefix * 1664525u + 1013904223u;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(stealth_filter__matches__no_filters__false)
+{
+    const stealth_filter instance({});
+    BOOST_REQUIRE(instance.empty());
+    BOOST_REQUIRE(!instance.matches(0));
+    BOOST_REQUIRE(!instance.matches(0xffffffff));
+}
+
+BOOST_AUTO_TEST_CASE(stealth_filter__matches__empty_filter__true)
+{
+    const stealth_filter instance({ binary() });
+    BOOST_REQUIRE(!instance.empty());
+    BOOST_REQUIRE(instance.matches(0));
+    BOOST_REQUIRE(instance.matches(0xffffffff));
+}
+
+BOOST_AUTO_TEST_CASE(stealth_filter__matches__short_filters__equivalent_to_is_prefix_of)
+{
+    require_equivalent({ binary("1"), binary("0110"), binary("01100111001"),
+        binary("0110") });
+}
+
+BOOST_AUTO_TEST_CASE(stealth_filter__matches__full_length_filters__equivalent_to_is_prefix_of)
+{
+    const binary filter(32, 0x9e3779b9u);
+    require_equivalent({ filter, binary(27, 0x12345678u) });
+    BOOST_REQUIRE(stealth_filter({ filter }).matches(0x9e3779b9u));
+}
+
+BOOST_AUTO_TEST_CASE(stealth_filter__matches__long_filters__equivalent_to_is_prefix_of)
+{
+    const data_chunk zero_excess{ 0xb9, 0x79, 0x37, 0x9e, 0x00 };
+    const data_chunk nonzero_excess{ 0xb9, 0x79, 0x37, 0x9e, 0x80 };
+    const binary zero(40, zero_excess);
+    const binary nonzero(40, nonzero_excess);
+    BOOST_REQUIRE(stealth_filter({ zero }).matches(0x9e3779b9u));
+    BOOST_REQUIRE(!stealth_filter({ nonzero }).matches(0x9e3779b9u));
+    require_equivalent({ zero, nonzero, binary("10") });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
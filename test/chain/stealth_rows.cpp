@@ -0,0 +1,147 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+BOOST_AUTO_TEST_SUITE(stealth_rows_tests)
+
+static const short_hash key_hash
+{
+    {
+        0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a,
+        0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14
+    }
+};
+
+static script null_data(size_t size, uint8_t fill)
+{
+    return script(script::to_null_data_pattern(data_chunk(size, fill)));
+}
+
+static output pay_key_hash()
+{
+    return { 0, script(script::to_pay_key_hash_pattern(key_hash)) };
+}
+
+static transaction make_transaction(output::list&& outputs)
+{
+    const input spend{ output_point{ null_hash, 0 }, script{}, 0 };
+    return { 1, 0, { spend }, std::move(outputs) };
+}
+
+BOOST_AUTO_TEST_CASE(stealth_rows__extract__candidates__expected_rows)
+{
+    const auto stealth = null_data(40, 0x2a);
+    const auto tx = make_transaction(
+    {
+        pay_key_hash(),
+        { 0, stealth },
+        pay_key_hash(),
+        { 0, null_data(20, 0x2a) },
+        pay_key_hash(),
+        { 0, null_data(80, 0x2b) }
+    });
+
+    stealth_rows instance;
+    instance.extract(tx, 7);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.transactions().front(), 7u);
+    BOOST_REQUIRE_EQUAL(instance.indexes().front(), 1u);
+    BOOST_REQUIRE(instance.public_key_hashes().front() == key_hash);
+    BOOST_REQUIRE(instance.transaction_hashes().front() == tx.hash());
+
+    uint32_t prefix;
+    BOOST_REQUIRE(to_stealth_prefix(prefix, stealth));
+    BOOST_REQUIRE_EQUAL(instance.prefixes().front(), prefix);
+
+    hash_digest unsigned_key;
+    BOOST_REQUIRE(extract_ephemeral_key(unsigned_key, stealth));
+    BOOST_REQUIRE(instance.ephemeral_keys().front() == unsigned_key);
+
+    ec_compressed signed_key;
+    BOOST_REQUIRE(extract_ephemeral_key(signed_key, stealth));
+    BOOST_REQUIRE(instance.to_stealth(0).ephemeral_public_key == signed_key);
+    BOOST_REQUIRE(instance.to_compact(0).ephemeral_public_key_hash ==
+        unsigned_key);
+}
+
+BOOST_AUTO_TEST_CASE(stealth_rows__extract__pushdata1__is_stealth_script)
+{
+    const auto stealth = null_data(max_null_data_size, 0x2a);
+    BOOST_REQUIRE(is_stealth_script(stealth));
+
+    stealth_rows instance;
+    instance.extract(make_transaction({ { 0, stealth }, pay_key_hash() }), 0);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(stealth_rows__extract__block__replaces_rows_in_block_order)
+{
+    block instance_block;
+    instance_block.set_transactions(
+    {
+        make_transaction({ { 0, null_data(32, 0x01) }, pay_key_hash() }),
+        make_transaction({ pay_key_hash() }),
+        make_transaction({ { 0, null_data(33, 0x02) }, pay_key_hash(),
+            { 0, null_data(34, 0x03) }, pay_key_hash() })
+    });
+
+    stealth_rows instance;
+    instance.extract(make_transaction({ { 0, null_data(32, 0x04) },
+        pay_key_hash() }), 42);
+    instance.extract(instance_block);
+    BOOST_REQUIRE_EQUAL(instance.size(), 3u);
+    BOOST_REQUIRE(instance.transactions() ==
+        stealth_rows::position_column({ 0, 2, 2 }));
+    BOOST_REQUIRE(instance.indexes() ==
+        stealth_rows::position_column({ 0, 0, 2 }));
+}
+
+BOOST_AUTO_TEST_CASE(stealth_rows__match__filters__equivalent_to_is_prefix_of)
+{
+    stealth_rows instance;
+
+    for (uint8_t fill = 0; fill < 64; ++fill)
+        instance.extract(make_transaction({ { 0, null_data(32, fill) },
+            pay_key_hash() }), fill);
+
+    BOOST_REQUIRE_EQUAL(instance.size(), 64u);
+    BOOST_REQUIRE(instance.match(stealth_filter({})).empty());
+    BOOST_REQUIRE_EQUAL(instance.match(stealth_filter({ binary() })).size(),
+        64u);
+
+    const stealth_filter::list filters{ binary("101"), binary("0011") };
+    stealth_rows::row_list expected;
+
+    for (size_t row = 0; row < instance.size(); ++row)
+    {
+        const auto prefix = instance.prefixes()[row];
+
+        if (filters[0].is_prefix_of(prefix) || filters[1].is_prefix_of(prefix))
+            expected.push_back(row);
+    }
+
+    BOOST_REQUIRE(instance.match(stealth_filter(filters)) == expected);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -522,6 +522,167 @@ BOOST_AUTO_TEST_CASE(transaction__factory_data_1__case_1__success)
     BOOST_REQUIRE(resave == raw_tx);
 }
 
+BOOST_AUTO_TEST_CASE(transaction__wire_data__from_data__captured_and_shared)
+{
+    static const auto raw_tx = to_chunk(base16_literal(TX1));
+    chain::transaction tx;
+    BOOST_REQUIRE(tx.from_data(raw_tx));
+
+    const auto data = tx.wire_data();
+    BOOST_REQUIRE(*data == raw_tx);
+    BOOST_REQUIRE(tx.wire_data() == data);
+    BOOST_REQUIRE(chain::transaction(tx).wire_data() == data);
+    BOOST_REQUIRE(tx.to_data() == raw_tx);
+}
+
+BOOST_AUTO_TEST_CASE(transaction__wire_data__setter__invalidated)
+{
+    static const auto raw_tx = to_chunk(base16_literal(TX1));
+    chain::transaction tx;
+    BOOST_REQUIRE(tx.from_data(raw_tx));
+    const auto hash = tx.hash();
+    const auto data = tx.wire_data();
+
+    tx.set_locktime(tx.locktime() + 1);
+    BOOST_REQUIRE(tx.wire_data() != data);
+    BOOST_REQUIRE(*tx.wire_data() != raw_tx);
+    BOOST_REQUIRE(tx.hash() != hash);
+
+    chain::transaction reloaded;
+    BOOST_REQUIRE(reloaded.from_data(tx.to_data()));
+    BOOST_REQUIRE_EQUAL(reloaded.locktime(), tx.locktime());
+}
+
+BOOST_AUTO_TEST_CASE(transaction__wire_data__copy_mutated_through_accessor__invalidated)
+{
+    static const auto raw_tx = to_chunk(base16_literal(TX1));
+    chain::transaction tx;
+    BOOST_REQUIRE(tx.from_data(raw_tx));
+
+    // As wire::input_set signs a copy of a parsed transaction.
+    chain::transaction copy(tx);
+    copy.inputs().front().set_script(chain::script{});
+    copy.outputs().front().set_value(42);
+    BOOST_REQUIRE(copy.to_data() != raw_tx);
+    BOOST_REQUIRE(*copy.wire_data() == copy.to_data());
+    BOOST_REQUIRE(tx.to_data() == raw_tx);
+
+    chain::transaction reloaded;
+    BOOST_REQUIRE(reloaded.from_data(copy.to_data()));
+    BOOST_REQUIRE(reloaded.inputs().front().script().empty());
+    BOOST_REQUIRE_EQUAL(reloaded.outputs().front().value(), 42u);
+}
+
+BOOST_AUTO_TEST_CASE(transaction__wire_data__trailing_bytes__built_on_first_use)
+{
+    static const auto raw_tx = to_chunk(base16_literal(TX1));
+    auto padded = raw_tx;
+    padded.push_back(0x00);
+    chain::transaction tx;
+    BOOST_REQUIRE(tx.from_data(padded));
+
+    const auto data = tx.wire_data();
+    BOOST_REQUIRE(*data == raw_tx);
+    BOOST_REQUIRE(tx.wire_data() == data);
+}
+
+BOOST_AUTO_TEST_CASE(transaction__to_hash__segregated_offsets__excludes_witness)
+{
+    static const auto raw_tx = to_chunk(base16_literal(TX1));
+    const auto expected = chain::transaction::factory_from_data(raw_tx);
+    const auto body_size = raw_tx.size() - 2 * sizeof(uint32_t);
+
+    // Version, marker and flag, inputs and outputs, witnesses and locktime.
+    data_chunk data(raw_tx.begin(), raw_tx.begin() + 4);
+    extend_data(data, data_chunk{ 0x00, 0x01 });
+    data.insert(data.end(), raw_tx.begin() + 4, raw_tx.end() - 4);
+    extend_data(data, data_chunk{ 0x01, 0x02, 0xab, 0xcd });
+    data.insert(data.end(), raw_tx.end() - 4, raw_tx.end());
+
+    chain::transaction::offsets offsets;
+    offsets.transaction = 0;
+    offsets.inputs = 6;
+    offsets.outputs = 6;
+    offsets.witnesses = 6 + body_size;
+    offsets.locktime = offsets.witnesses + 4;
+    BOOST_REQUIRE(chain::transaction::to_hash(data, offsets) ==
+        expected.hash());
+
+    offsets.inputs = 4;
+    offsets.witnesses = offsets.locktime = 4 + body_size;
+    BOOST_REQUIRE(chain::transaction::to_hash(raw_tx, offsets) ==
+        expected.hash());
+}
+
+BOOST_AUTO_TEST_CASE(transaction__from_data__parse_outputs__outputs_hash_and_offsets)
+{
+    static const auto raw_tx = to_chunk(base16_literal(TX1));
+    const auto expected = chain::transaction::factory_from_data(raw_tx);
+
+    chain::transaction tx;
+    chain::transaction::offsets offsets;
+    BOOST_REQUIRE(tx.from_data(raw_tx, chain::transaction::parse_outputs,
+        offsets));
+    BOOST_REQUIRE(tx.outputs() == expected.outputs());
+    BOOST_REQUIRE_EQUAL(tx.inputs().size(), expected.inputs().size());
+    BOOST_REQUIRE(tx.inputs().front().script().empty());
+    BOOST_REQUIRE(tx.hash() == expected.hash());
+    BOOST_REQUIRE_EQUAL(tx.locktime(), expected.locktime());
+
+    BOOST_REQUIRE_EQUAL(offsets.transaction, 0u);
+    BOOST_REQUIRE_EQUAL(offsets.inputs, 4u);
+    BOOST_REQUIRE_EQUAL(offsets.witnesses, offsets.locktime);
+    BOOST_REQUIRE_EQUAL(offsets.locktime + 4u, raw_tx.size());
+
+    // The skipped inputs are recovered from their offset.
+    auto source = make_safe_deserializer(raw_tx.begin() + offsets.inputs,
+        raw_tx.begin() + offsets.outputs);
+    BOOST_REQUIRE_EQUAL(source.read_size_little_endian(),
+        expected.inputs().size());
+
+    for (const auto& input: expected.inputs())
+        BOOST_REQUIRE(chain::input::factory_from_data(source) == input);
+
+    BOOST_REQUIRE(source.is_exhausted());
+}
+
+BOOST_AUTO_TEST_CASE(transaction__from_data__parse_input_points__points_only)
+{
+    static const auto raw_tx = to_chunk(base16_literal(TX1));
+    const auto expected = chain::transaction::factory_from_data(raw_tx);
+
+    chain::transaction tx;
+    chain::transaction::offsets offsets;
+    BOOST_REQUIRE(tx.from_data(raw_tx,
+        chain::transaction::parse_input_points, offsets));
+    BOOST_REQUIRE_EQUAL(tx.inputs().size(), expected.inputs().size());
+
+    for (size_t index = 0; index < tx.inputs().size(); ++index)
+    {
+        const auto& input = tx.inputs()[index];
+        BOOST_REQUIRE(input.previous_output() ==
+            expected.inputs()[index].previous_output());
+        BOOST_REQUIRE(input.script().empty());
+        BOOST_REQUIRE_EQUAL(input.sequence(), 0u);
+    }
+
+    BOOST_REQUIRE_EQUAL(tx.outputs().size(), expected.outputs().size());
+    BOOST_REQUIRE_EQUAL(tx.outputs().front().value(), chain::output::not_found);
+    BOOST_REQUIRE(tx.hash() == expected.hash());
+}
+
+BOOST_AUTO_TEST_CASE(transaction__from_data__parse_all_truncated__false)
+{
+    static const auto raw_tx = to_chunk(base16_literal(TX1));
+    const data_chunk truncated(raw_tx.begin(), raw_tx.end() - 1);
+
+    chain::transaction tx;
+    chain::transaction::offsets offsets;
+    BOOST_REQUIRE(!tx.from_data(truncated, chain::transaction::parse_all,
+        offsets));
+    BOOST_REQUIRE(!tx.is_valid());
+}
+
 BOOST_AUTO_TEST_CASE(transaction__factory_data_1__case_2__success)
 {
     static const auto tx_hash = hash_literal(TX4_HASH);
@@ -1042,6 +1203,31 @@ BOOST_AUTO_TEST_CASE(transaction__operator_assign_equals_2__always__matches_equi
     BOOST_REQUIRE(instance == expected);
 }
 
+BOOST_AUTO_TEST_CASE(transaction__operator_assign_equals__hashed__rehashes)
+{
+    static const auto raw_tx = to_chunk(base16_literal(TX4));
+    chain::transaction expected;
+    BOOST_REQUIRE(expected.from_data(raw_tx));
+    chain::transaction instance;
+    const auto stale = instance.hash();
+    instance = expected;
+    BOOST_REQUIRE(instance.hash() != stale);
+    BOOST_REQUIRE(instance.hash() == expected.hash());
+}
+
+BOOST_AUTO_TEST_CASE(transaction__copy__cached_values__retained)
+{
+    const chain::transaction expected(1, 0, {}, {}, 3, 42, true);
+    chain::transaction instance(expected);
+    BOOST_REQUIRE_EQUAL(instance.cached_sigops(), 3u);
+    BOOST_REQUIRE_EQUAL(instance.cached_fees(), 42u);
+    BOOST_REQUIRE(instance.cached_is_standard());
+
+    chain::transaction assigned;
+    assigned = expected;
+    BOOST_REQUIRE_EQUAL(assigned.cached_fees(), 42u);
+}
+
 BOOST_AUTO_TEST_CASE(transaction__operator_boolean_equals__duplicates__returns_true)
 {
     static const auto raw_tx = to_chunk(base16_literal(TX4));
@@ -0,0 +1,149 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+// A 32 byte element with the given first byte.
+static data_chunk element(uint8_t value)
+{
+    data_chunk out(32, 0x00);
+    out[0] = value;
+    return out;
+}
+
+static output_point make_point(uint32_t index)
+{
+    return { hash_literal(
+        "4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b"),
+        index };
+}
+
+static output make_output(uint64_t value)
+{
+    using namespace bc::machine;
+    return { value, script(operation::list{ { opcode::push_positive_1 } }) };
+}
+
+BOOST_AUTO_TEST_SUITE(utxo_commitment_tests)
+
+BOOST_AUTO_TEST_CASE(utxo_commitment__hash__reference_vector__expected)
+{
+    utxo_commitment instance;
+    instance.add(element(0));
+    instance.add(element(1));
+    instance.remove(element(2));
+
+    BOOST_REQUIRE_EQUAL(encode_hash(instance.hash()),
+        "10d312b100cbd32ada024a6646e40d3482fcff103668d2625f10002a607d5863");
+}
+
+BOOST_AUTO_TEST_CASE(utxo_commitment__hash__add_then_remove__empty)
+{
+    const utxo_commitment empty;
+    utxo_commitment instance;
+    instance.add(make_point(0), make_output(42), 100, false);
+    instance.add(make_point(1), make_output(43), 100, true);
+    instance.remove(make_point(0), make_output(42), 100, false);
+    instance.remove(make_point(1), make_output(43), 100, true);
+    BOOST_REQUIRE(instance.hash() == empty.hash());
+}
+
+BOOST_AUTO_TEST_CASE(utxo_commitment__hash__order__independent)
+{
+    utxo_commitment forward;
+    utxo_commitment reverse;
+
+    for (uint32_t index = 0; index < 4; ++index)
+        forward.add(make_point(index), make_output(index), 1, false);
+
+    for (uint32_t index = 4; index-- > 0;)
+        reverse.add(make_point(index), make_output(index), 1, false);
+
+    BOOST_REQUIRE(forward.hash() == reverse.hash());
+}
+
+BOOST_AUTO_TEST_CASE(utxo_commitment__hash__distinct_metadata__distinct)
+{
+    utxo_commitment first;
+    utxo_commitment second;
+    utxo_commitment third;
+    first.add(make_point(0), make_output(1), 1, false);
+    second.add(make_point(0), make_output(1), 2, false);
+    third.add(make_point(0), make_output(1), 1, true);
+    BOOST_REQUIRE(first.hash() != second.hash());
+    BOOST_REQUIRE(first.hash() != third.hash());
+}
+
+BOOST_AUTO_TEST_CASE(utxo_commitment__combine__partials__equals_serial)
+{
+    utxo_commitment serial;
+    utxo_commitment left;
+    utxo_commitment right;
+
+    serial.add(element(1));
+    serial.add(element(2));
+    serial.remove(element(3));
+    left.add(element(1));
+    right.add(element(2));
+    right.remove(element(3));
+
+    left.combine(right);
+    BOOST_REQUIRE(left.hash() == serial.hash());
+}
+
+BOOST_AUTO_TEST_CASE(utxo_commitment__to_element__expected_layout)
+{
+    const auto point = make_point(7);
+    const auto output = make_output(5);
+    const auto value = utxo_commitment::to_element(point, output, 3, true);
+
+    const auto expected = build_chunk(
+    {
+        point.to_data(true),
+        data_chunk{ 0x07, 0x00, 0x00, 0x00 },
+        output.to_data(true)
+    });
+
+    BOOST_REQUIRE(value == expected);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_commitment__from_data__round_trip__same_hash)
+{
+    utxo_commitment instance;
+    instance.add(element(1));
+    instance.remove(element(2));
+
+    const auto data = instance.to_data();
+    BOOST_REQUIRE_EQUAL(data.size(), 768u);
+
+    utxo_commitment restored;
+    BOOST_REQUIRE(restored.from_data(data));
+    BOOST_REQUIRE(restored.hash() == instance.hash());
+}
+
+BOOST_AUTO_TEST_CASE(utxo_commitment__from_data__wrong_size__false)
+{
+    utxo_commitment instance;
+    BOOST_REQUIRE(!instance.from_data(data_chunk(767, 0x00)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
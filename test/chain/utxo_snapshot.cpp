@@ -0,0 +1,272 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <sstream>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+static const auto block_hash = hash_literal(
+    "000000000019d6689c085ae165831e934ff763ae46a2a6c172b3f1b60a8ce26f");
+
+// Header (80) and terminator (40) sizes.
+static const size_t header_size = 4 + 4 + 32 + 4 + 32;
+static const size_t frame_size = 4 + 4 + 32;
+
+static unspent_output::list make_entries(size_t count)
+{
+    unspent_output::list out;
+
+    for (size_t index = 0; index < count; ++index)
+    {
+        auto hash = null_hash;
+        hash[0] = static_cast<uint8_t>(index);
+        const auto pay = script::to_pay_key_hash_pattern(short_hash{});
+        out.push_back(
+        {
+            { hash, static_cast<uint32_t>(index) },
+            { 1000 * index, script(pay) },
+            index,
+            index == 0
+        });
+    }
+
+    return out;
+}
+
+static hash_digest commit(const unspent_output::list& entries)
+{
+    utxo_commitment commitment;
+    for (const auto& entry: entries)
+        commitment.add(entry.point, entry.output, entry.height,
+            entry.coinbase);
+
+    return commitment.hash();
+}
+
+static std::string write_snapshot(const unspent_output::list& entries,
+    const hash_digest& commitment, size_t chunk_size)
+{
+    std::ostringstream stream;
+    utxo_snapshot_writer writer(stream, { block_hash, 42, commitment },
+        chunk_size);
+
+    for (const auto& entry: entries)
+        BOOST_REQUIRE(writer.write(entry));
+
+    BOOST_REQUIRE(writer.flush());
+    return stream.str();
+}
+
+static bool sort_by_index(const unspent_output& left,
+    const unspent_output& right)
+{
+    return left.point.index() < right.point.index();
+}
+
+BOOST_AUTO_TEST_SUITE(utxo_snapshot_tests)
+
+BOOST_AUTO_TEST_CASE(utxo_snapshot__load__multiple_chunks__all_entries)
+{
+    const auto entries = make_entries(20);
+    const auto data = write_snapshot(entries, commit(entries), 100);
+
+    std::mutex mutex;
+    size_t chunks = 0;
+    unspent_output::list loaded;
+    std::istringstream stream(data);
+    utxo_snapshot_reader reader(stream);
+
+    const auto handler = [&](size_t, unspent_output::list&& chunk)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++chunks;
+        loaded.insert(loaded.end(), chunk.begin(), chunk.end());
+        return true;
+    };
+
+    BOOST_REQUIRE_EQUAL(reader.load(handler, 2), error::success);
+    BOOST_REQUIRE(reader.header().block_hash == block_hash);
+    BOOST_REQUIRE_EQUAL(reader.header().height, 42u);
+    BOOST_REQUIRE_GT(chunks, 1u);
+    BOOST_REQUIRE_EQUAL(loaded.size(), entries.size());
+
+    std::sort(loaded.begin(), loaded.end(), sort_by_index);
+
+    for (size_t index = 0; index < entries.size(); ++index)
+    {
+        BOOST_REQUIRE(loaded[index].point == entries[index].point);
+        BOOST_REQUIRE(loaded[index].output == entries[index].output);
+        BOOST_REQUIRE_EQUAL(loaded[index].height, entries[index].height);
+        BOOST_REQUIRE_EQUAL(loaded[index].coinbase, entries[index].coinbase);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(utxo_snapshot__load__maximum_chunk_size__all_entries)
+{
+    // Ten entries of 7MB scripts exceed the 64MB maximum chunk after nine.
+    static const size_t max_chunk_size = 64 * 1024 * 1024;
+    const script large(data_chunk(7 * 1024 * 1024, 0x51), false);
+    auto entries = make_entries(10);
+
+    for (auto& entry: entries)
+        entry.output.set_script(large);
+
+    const auto data = write_snapshot(entries, commit(entries),
+        max_chunk_size);
+
+    size_t loaded = 0;
+    std::mutex mutex;
+    std::istringstream stream(data);
+    utxo_snapshot_reader reader(stream);
+    const auto handler = [&](size_t, unspent_output::list&& chunk)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        loaded += chunk.size();
+        return true;
+    };
+
+    BOOST_REQUIRE_EQUAL(reader.load(handler, 2), error::success);
+    BOOST_REQUIRE_EQUAL(loaded, entries.size());
+}
+
+BOOST_AUTO_TEST_CASE(utxo_snapshot__load__empty_set__success)
+{
+    const auto data = write_snapshot({}, commit({}), 0);
+    BOOST_REQUIRE_EQUAL(data.size(), header_size + frame_size);
+
+    std::istringstream stream(data);
+    utxo_snapshot_reader reader(stream);
+    const auto handler = [](size_t, unspent_output::list&&)
+    {
+        return true;
+    };
+
+    BOOST_REQUIRE_EQUAL(reader.load(handler, 1), error::success);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_snapshot__load__corrupt_payload__store_snapshot_corrupt)
+{
+    const auto entries = make_entries(3);
+    auto data = write_snapshot(entries, commit(entries), 0);
+
+    // Flip a byte in the first payload.
+    data[header_size + frame_size] ^= 0x01;
+
+    std::istringstream stream(data);
+    utxo_snapshot_reader reader(stream);
+    const auto handler = [](size_t, unspent_output::list&&)
+    {
+        return true;
+    };
+
+    BOOST_REQUIRE_EQUAL(reader.load(handler, 1),
+        error::store_snapshot_corrupt);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_snapshot__load__oversized_script_with_valid_checksum__bad_stream)
+{
+    // Point, height/coinbase, amount and a script size type over 2^62.
+    data_chunk payload(36, 0x00);
+    extend_data(payload, data_chunk{ 0x00, 0x00, 0xff });
+    extend_data(payload, data_chunk(8, 0x7f));
+
+    data_chunk frame;
+    extend_data(frame, to_little_endian<uint32_t>(1));
+    extend_data(frame, to_little_endian(static_cast<uint32_t>(
+        payload.size())));
+    extend_data(frame, sha256_hash(payload));
+    extend_data(frame, payload);
+
+    const unspent_output::list entries;
+    auto data = write_snapshot(entries, commit(entries), 0);
+    data.insert(header_size, std::string(frame.begin(), frame.end()));
+
+    std::istringstream stream(data);
+    utxo_snapshot_reader reader(stream);
+    const auto handler = [](size_t, unspent_output::list&&)
+    {
+        return true;
+    };
+
+    BOOST_REQUIRE_EQUAL(reader.load(handler, 2), error::bad_stream);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_snapshot__load__wrong_commitment__store_snapshot_mismatch)
+{
+    const auto entries = make_entries(3);
+    const auto data = write_snapshot(entries, null_hash, 0);
+
+    std::istringstream stream(data);
+    utxo_snapshot_reader reader(stream);
+    const auto handler = [](size_t, unspent_output::list&&)
+    {
+        return true;
+    };
+
+    BOOST_REQUIRE_EQUAL(reader.load(handler, 1),
+        error::store_snapshot_mismatch);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_snapshot__load__missing_terminator__bad_stream)
+{
+    const auto entries = make_entries(3);
+    auto data = write_snapshot(entries, commit(entries), 0);
+    data.resize(data.size() - frame_size);
+
+    std::istringstream stream(data);
+    utxo_snapshot_reader reader(stream);
+    const auto handler = [](size_t, unspent_output::list&&)
+    {
+        return true;
+    };
+
+    BOOST_REQUIRE_EQUAL(reader.load(handler, 1), error::bad_stream);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_snapshot__load__handler_false__service_stopped)
+{
+    const auto entries = make_entries(10);
+    const auto data = write_snapshot(entries, commit(entries), 50);
+
+    std::istringstream stream(data);
+    utxo_snapshot_reader reader(stream);
+    const auto handler = [](size_t, unspent_output::list&&)
+    {
+        return false;
+    };
+
+    BOOST_REQUIRE_EQUAL(reader.load(handler, 2), error::service_stopped);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_snapshot__read_header__bad_magic__false)
+{
+    auto data = write_snapshot({}, commit({}), 0);
+    data[0] ^= 0x01;
+
+    std::istringstream stream(data);
+    utxo_snapshot_reader reader(stream);
+    BOOST_REQUIRE(!reader.read_header());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -90,4 +90,31 @@ BOOST_AUTO_TEST_CASE(pkcs5_pbkdf2_hmac_sha512_test)
     }
 }
 
+// Test vectors from the satoshi client (hash_tests.cpp).
+BOOST_AUTO_TEST_CASE(murmur3__satoshi_vectors__expected)
+{
+    BOOST_REQUIRE_EQUAL(murmur3(data_chunk{}, 0x00000000), 0x00000000u);
+    BOOST_REQUIRE_EQUAL(murmur3(data_chunk{}, 0xfba4c795), 0x6a396f08u);
+    BOOST_REQUIRE_EQUAL(murmur3(data_chunk{}, 0xffffffff), 0x81f16f39u);
+    BOOST_REQUIRE_EQUAL(murmur3(base16_literal("00"), 0xfba4c795), 0xea3f0b17u);
+    BOOST_REQUIRE_EQUAL(murmur3(base16_literal("ff"), 0), 0xfd6cf10du);
+    BOOST_REQUIRE_EQUAL(murmur3(base16_literal("0011"), 0), 0x16c6b7abu);
+    BOOST_REQUIRE_EQUAL(murmur3(base16_literal("001122"), 0), 0x8eb51c3du);
+    BOOST_REQUIRE_EQUAL(murmur3(base16_literal("00112233"), 0), 0xb4471bf8u);
+    BOOST_REQUIRE_EQUAL(murmur3(base16_literal("001122334455667788"), 0),
+        0xb4698defu);
+}
+
+BOOST_AUTO_TEST_CASE(murmur3__seeds__equals_each_seed)
+{
+    const auto data = base16_literal("00112233445566");
+    const uint32_t seeds[] = { 0, 0xfba4c795, 0xffffffff };
+    uint32_t hashes[3];
+
+    murmur3(data, seeds, hashes, 3);
+
+    for (size_t seed = 0; seed < 3; ++seed)
+        BOOST_REQUIRE_EQUAL(hashes[seed], murmur3(data, seeds[seed]));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/bitcoin/math/sip_hash.hpp>
+
+using namespace bc;
+
+BOOST_AUTO_TEST_SUITE(sip_hash_tests)
+
+static const uint64_t key0 = 0x0706050403020100;
+static const uint64_t key1 = 0x0f0e0d0c0b0a0908;
+
+static hash_list make_values(size_t count)
+{
+    hash_list out(count);
+
+    for (size_t index = 0; index < count; ++index)
+        out[index] = bitcoin_hash(to_little_endian(uint64_t(index)));
+
+    return out;
+}
+
+// Reference vector for a 32 byte message of bytes 0x00 through 0x1f.
+BOOST_AUTO_TEST_CASE(sip_hash__sip_hash_uint256__reference_vector__expected)
+{
+    hash_digest value;
+
+    for (size_t index = 0; index < value.size(); ++index)
+        value[index] = static_cast<uint8_t>(index);
+
+    BOOST_REQUIRE_EQUAL(sip_hash_uint256(key0, key1, value),
+        0x7127512f72f27cceu);
+}
+
+BOOST_AUTO_TEST_CASE(sip_hash__sip_hash_uint256_batch__empty__empty)
+{
+    std::vector<uint64_t> out{ 42 };
+    sip_hash_uint256(key0, key1, hash_list{}, out);
+    BOOST_REQUIRE(out.empty());
+}
+
+BOOST_AUTO_TEST_CASE(sip_hash__sip_hash_uint256_batch__all_sizes__matches_scalar)
+{
+    for (const size_t count: { 1u, 2u, 3u, 4u, 5u, 7u, 8u, 9u, 1000u })
+    {
+        const auto values = make_values(count);
+        std::vector<uint64_t> out;
+        sip_hash_uint256(key0, key1, values, out);
+        BOOST_REQUIRE_EQUAL(out.size(), count);
+
+        for (size_t index = 0; index < count; ++index)
+            BOOST_REQUIRE_EQUAL(out[index],
+                sip_hash_uint256(key0, key1, values[index]));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
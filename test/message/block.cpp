@@ -195,6 +195,19 @@ BOOST_AUTO_TEST_CASE(block__factory_data_1__genesis_mainnet__success)
     BOOST_REQUIRE_EQUAL(raw_reserialization.size(), block.serialized_size(version::level::minimum));
 }
 
+BOOST_AUTO_TEST_CASE(block__to_data__wire_data__built_once_and_shared)
+{
+    const message::block instance(chain::block::genesis_mainnet());
+    const auto raw_block = instance.to_data(version::level::minimum);
+    const auto data = instance.wire_data(true);
+    BOOST_REQUIRE(*data == raw_block);
+
+    const auto packet = serialize(version::level::minimum, instance, 0);
+    BOOST_REQUIRE(instance.wire_data(true) == data);
+    BOOST_REQUIRE(data_chunk(packet.begin() + heading::satoshi_fixed_size(),
+        packet.end()) == raw_block);
+}
+
 BOOST_AUTO_TEST_CASE(block__factory_data_2__genesis_mainnet__success)
 {
     const auto genesis = chain::block::genesis_mainnet();
@@ -0,0 +1,172 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::message;
+
+BOOST_AUTO_TEST_SUITE(compact_block_reconstructor_tests)
+
+static chain::block make_block(uint32_t count)
+{
+    const chain::input coinbase_input{ chain::output_point{ null_hash,
+        chain::point::null_index }, chain::script{}, max_input_sequence };
+
+    chain::transaction::list transactions
+    {
+        chain::transaction{ 1, 0, { coinbase_input }, {} }
+    };
+
+    for (uint32_t tx = 1; tx < count; ++tx)
+    {
+        const chain::input input{ chain::output_point{ null_hash, tx },
+            chain::script{}, max_input_sequence };
+        transactions.push_back(chain::transaction{ 1, 0, { input }, {} });
+    }
+
+    chain::block out;
+    out.set_transactions(std::move(transactions));
+    out.header().set_merkle(out.generate_merkle_root());
+    return out;
+}
+
+BOOST_AUTO_TEST_CASE(compact_block_reconstructor__fill__all_known__complete_block)
+{
+    const auto block = make_block(8);
+    const auto compact = compact_block::factory_from_block(
+        message::block(block));
+
+    compact_block_reconstructor instance(compact);
+    BOOST_REQUIRE(instance.is_valid());
+    BOOST_REQUIRE(!instance.is_complete());
+
+    const auto& pool = block.transactions();
+    BOOST_REQUIRE_EQUAL(instance.fill(pool.begin() + 1, pool.end()), 7u);
+    BOOST_REQUIRE(instance.is_complete());
+    BOOST_REQUIRE(instance.missing().empty());
+
+    chain::block result;
+    BOOST_REQUIRE(instance.to_block(result));
+    BOOST_REQUIRE(result == block);
+}
+
+BOOST_AUTO_TEST_CASE(compact_block_reconstructor__fill__pool_over_batches__complete_block)
+{
+    const auto block = make_block(600);
+    const auto& txs = block.transactions();
+    compact_block_reconstructor instance(compact_block::factory_from_block(
+        message::block(block)));
+
+    // Unrelated transactions precede and follow those of the block.
+    auto pool = make_block(1000).transactions();
+    pool.erase(pool.begin(), pool.begin() + 600);
+    pool.insert(pool.begin() + 200, txs.begin() + 1, txs.end());
+
+    BOOST_REQUIRE_EQUAL(instance.fill(pool.begin(), pool.end()), 599u);
+    BOOST_REQUIRE(instance.is_complete());
+
+    chain::block result;
+    BOOST_REQUIRE(instance.to_block(result));
+    BOOST_REQUIRE(result == block);
+}
+
+BOOST_AUTO_TEST_CASE(compact_block_reconstructor__fill__unknown_transaction__false)
+{
+    const auto block = make_block(4);
+    compact_block_reconstructor instance(compact_block::factory_from_block(
+        message::block(block)));
+
+    BOOST_REQUIRE(!instance.fill(make_block(9).transactions().back()));
+    BOOST_REQUIRE(instance.fill(block.transactions()[2]));
+    BOOST_REQUIRE(!instance.fill(block.transactions()[2]));
+}
+
+BOOST_AUTO_TEST_CASE(compact_block_reconstructor__fill__partial_pool__request_and_reply_complete)
+{
+    const auto block = make_block(10);
+    const auto& txs = block.transactions();
+    compact_block_reconstructor instance(compact_block::factory_from_block(
+        message::block(block)));
+
+    const chain::transaction::list pool{ txs[1], txs[2], txs[5], txs[6],
+        txs[7], txs[9] };
+    BOOST_REQUIRE_EQUAL(instance.fill(pool.begin(), pool.end()), 6u);
+    BOOST_REQUIRE(!instance.is_complete());
+
+    const auto missing = instance.missing();
+    BOOST_REQUIRE(missing == compact_block_reconstructor::indexes({ 3, 4, 8 }));
+
+    // Requested indexes are differentially encoded.
+    const auto request = instance.to_request();
+    BOOST_REQUIRE(request.block_hash() == block.hash());
+    BOOST_REQUIRE(request.indexes() == std::vector<uint64_t>({ 3, 0, 3 }));
+
+    BOOST_REQUIRE(!instance.fill(block_transactions(block.hash(),
+        { txs[3], txs[4] })));
+    BOOST_REQUIRE(!instance.fill(block_transactions(null_hash,
+        { txs[3], txs[4], txs[8] })));
+    BOOST_REQUIRE(instance.fill(block_transactions(block.hash(),
+        { txs[3], txs[4], txs[8] })));
+
+    chain::block result;
+    BOOST_REQUIRE(instance.to_block(result));
+    BOOST_REQUIRE(result == block);
+}
+
+BOOST_AUTO_TEST_CASE(compact_block_reconstructor__constructor__duplicate_short_ids__invalid)
+{
+    const auto block = make_block(3);
+    const auto compact = compact_block::factory_from_block(
+        message::block(block));
+    auto short_ids = compact.short_ids();
+    short_ids.back() = short_ids.front();
+
+    const compact_block duplicated(compact.header(), compact.nonce(),
+        short_ids, compact.transactions());
+    const compact_block_reconstructor instance(duplicated);
+    BOOST_REQUIRE(!instance.is_valid());
+}
+
+BOOST_AUTO_TEST_CASE(compact_block_reconstructor__constructor__prefilled_out_of_range__invalid)
+{
+    const auto block = make_block(3);
+    const compact_block compact(block.header(), 42, { 1, 2 },
+        { prefilled_transaction{ 3, block.transactions().front() } });
+    const compact_block_reconstructor instance(compact);
+    BOOST_REQUIRE(!instance.is_valid());
+}
+
+BOOST_AUTO_TEST_CASE(compact_block_reconstructor__to_block__merkle_mismatch__false)
+{
+    auto block = make_block(3);
+    block.header().set_merkle(null_hash);
+    compact_block_reconstructor instance(compact_block::factory_from_block(
+        message::block(block)));
+
+    const auto& pool = block.transactions();
+    instance.fill(pool.begin(), pool.end());
+    BOOST_REQUIRE(instance.is_complete());
+
+    chain::block result;
+    BOOST_REQUIRE(!instance.to_block(result));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::message;
+
+BOOST_AUTO_TEST_SUITE(framer_tests)
+
+static const uint32_t magic = 0xe8f3e1e3;
+static const auto level = version::level::maximum;
+
+static data_chunk make_buffer()
+{
+    const auto first = serialize(level, ping(42), magic);
+    const auto second = serialize(level, block{}, magic);
+    return build_chunk({ first, second });
+}
+
+BOOST_AUTO_TEST_CASE(framer__read__two_frames__payloads_in_place)
+{
+    const framer instance(magic, level, false);
+    const auto buffer = make_buffer();
+    data_slice remaining(buffer);
+    heading head;
+    data_slice payload(buffer);
+    size_t size;
+
+    BOOST_REQUIRE(instance.read(remaining, head, payload, size) ==
+        framer::result::complete);
+    BOOST_REQUIRE_EQUAL(head.command(), ping::command);
+    BOOST_REQUIRE(payload.begin() == buffer.data() +
+        heading::satoshi_fixed_size());
+
+    ping first;
+    BOOST_REQUIRE(deserialize(level, payload, first));
+    BOOST_REQUIRE_EQUAL(first.nonce(), 42u);
+
+    remaining = data_slice(remaining.begin() + size, remaining.end());
+    BOOST_REQUIRE(instance.read(remaining, head, payload, size) ==
+        framer::result::complete);
+    BOOST_REQUIRE_EQUAL(head.command(), block::command);
+    BOOST_REQUIRE(remaining.begin() + size == buffer.data() + buffer.size());
+}
+
+BOOST_AUTO_TEST_CASE(framer__read__partial_frame__incomplete)
+{
+    const framer instance(magic, level, false);
+    const auto buffer = serialize(level, ping(42), magic);
+    heading head;
+    data_slice payload(buffer);
+    size_t size;
+
+    const data_slice partial_heading(buffer.data(), buffer.data() + 10);
+    BOOST_REQUIRE(instance.read(partial_heading, head, payload, size) ==
+        framer::result::incomplete);
+
+    const data_slice partial_payload(buffer.data(),
+        buffer.data() + buffer.size() - 1);
+    BOOST_REQUIRE(instance.read(partial_payload, head, payload, size) ==
+        framer::result::incomplete);
+}
+
+BOOST_AUTO_TEST_CASE(framer__read__corrupt_payload__invalid)
+{
+    const framer instance(magic, level, false);
+    auto buffer = serialize(level, ping(42), magic);
+    buffer.back() ^= 0x01;
+    heading head;
+    data_slice payload(buffer);
+    size_t size;
+
+    BOOST_REQUIRE(instance.read(buffer, head, payload, size) ==
+        framer::result::invalid);
+}
+
+BOOST_AUTO_TEST_CASE(framer__read__other_magic__invalid)
+{
+    const framer instance(magic + 1, level, false);
+    const auto buffer = serialize(level, ping(42), magic);
+    heading head;
+    data_slice payload(buffer);
+    size_t size;
+
+    BOOST_REQUIRE(instance.read(buffer, head, payload, size) ==
+        framer::result::invalid);
+}
+
+BOOST_AUTO_TEST_CASE(framer__read__oversized_payload__invalid_before_payload)
+{
+    const framer instance(magic, level, false);
+    const heading oversized(magic, ping::command,
+        static_cast<uint32_t>(instance.maximum_payload_size() + 1), 0);
+    const auto buffer = oversized.to_data();
+    heading head;
+    data_slice payload(buffer);
+    size_t size;
+
+    BOOST_REQUIRE(instance.read(buffer, head, payload, size) ==
+        framer::result::invalid);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
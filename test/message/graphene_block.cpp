@@ -0,0 +1,234 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::message;
+
+BOOST_AUTO_TEST_SUITE(graphene_block_tests)
+
+static const uint64_t nonce = 0x0123456789abcdef;
+
+static chain::transaction::list make_transactions(uint32_t first,
+    uint32_t count)
+{
+    chain::transaction::list out;
+    out.reserve(count);
+
+    for (auto tx = first; tx < first + count; ++tx)
+    {
+        const chain::input input{ chain::output_point{ null_hash, tx },
+            chain::script{}, max_input_sequence };
+        out.push_back(chain::transaction{ 1, 0, { input }, {} });
+    }
+
+    return out;
+}
+
+static chain::block make_block(uint32_t count, bool canonical)
+{
+    const chain::input coinbase_input{ chain::output_point{ null_hash,
+        chain::point::null_index }, chain::script{}, max_input_sequence };
+
+    auto transactions = make_transactions(1, count - 1);
+
+    if (canonical)
+        std::sort(transactions.begin(), transactions.end(),
+            [](const chain::transaction& left, const chain::transaction& right)
+            {
+                const auto left_hash = left.hash();
+                const auto right_hash = right.hash();
+                return std::lexicographical_compare(left_hash.rbegin(),
+                    left_hash.rend(), right_hash.rbegin(), right_hash.rend());
+            });
+
+    transactions.insert(transactions.begin(),
+        chain::transaction{ 1, 0, { coinbase_input }, {} });
+
+    chain::block out;
+    out.set_transactions(std::move(transactions));
+    out.header().set_merkle(out.generate_merkle_root());
+    return out;
+}
+
+// The receiver's pool is the block's transactions and as many unrelated.
+static chain::transaction::list make_pool(const chain::block& block)
+{
+    const auto& txs = block.transactions();
+    const auto count = static_cast<uint32_t>(txs.size());
+    auto pool = make_transactions(1000000, count);
+    pool.insert(pool.end(), std::next(txs.begin()), txs.end());
+    return pool;
+}
+
+BOOST_AUTO_TEST_CASE(graphene_block__reconstruct__canonical_block__complete_without_order)
+{
+    const auto block = make_block(500, true);
+    BOOST_REQUIRE(block.is_canonical_ordered());
+
+    const auto pool = make_pool(block);
+    const graphene_block instance(block, nonce, pool.size());
+    BOOST_REQUIRE(instance.is_valid());
+    BOOST_REQUIRE(instance.order().empty());
+    BOOST_REQUIRE(!instance.filter().filter().empty());
+
+    chain::block result;
+    graphene_block::short_id_list missing;
+    BOOST_REQUIRE(instance.reconstruct(pool.begin(), pool.end(), result,
+        missing) == graphene_block::result::complete);
+    BOOST_REQUIRE(missing.empty());
+    BOOST_REQUIRE(result == block);
+}
+
+BOOST_AUTO_TEST_CASE(graphene_block__reconstruct__uncanonical_block__complete_in_order)
+{
+    const auto block = make_block(500, false);
+    const auto pool = make_pool(block);
+    const graphene_block instance(block, nonce, pool.size());
+    BOOST_REQUIRE_EQUAL(instance.order().size(), 499u);
+
+    chain::block result;
+    graphene_block::short_id_list missing;
+    BOOST_REQUIRE(instance.reconstruct(pool.begin(), pool.end(), result,
+        missing) == graphene_block::result::complete);
+    BOOST_REQUIRE(result == block);
+}
+
+BOOST_AUTO_TEST_CASE(graphene_block__reconstruct__missing_transactions__incomplete_then_complete)
+{
+    const auto block = make_block(100, true);
+    const auto& txs = block.transactions();
+    auto pool = make_pool(block);
+    const graphene_block instance(block, nonce, pool.size());
+
+    // Withhold two of the block's transactions from the pool.
+    pool.erase(std::remove_if(pool.begin(), pool.end(),
+        [&](const chain::transaction& tx)
+        {
+            return tx == txs[10] || tx == txs[20];
+        }), pool.end());
+
+    chain::block result;
+    graphene_block::short_id_list missing;
+    BOOST_REQUIRE(instance.reconstruct(pool.begin(), pool.end(), result,
+        missing) == graphene_block::result::incomplete);
+
+    std::sort(missing.begin(), missing.end());
+    graphene_block::short_id_list expected{ instance.short_id(txs[10]),
+        instance.short_id(txs[20]) };
+    std::sort(expected.begin(), expected.end());
+    BOOST_REQUIRE(missing == expected);
+
+    pool.push_back(txs[10]);
+    pool.push_back(txs[20]);
+    BOOST_REQUIRE(instance.reconstruct(pool.begin(), pool.end(), result,
+        missing) == graphene_block::result::complete);
+    BOOST_REQUIRE(result == block);
+}
+
+BOOST_AUTO_TEST_CASE(graphene_block__reconstruct__pool_underestimated__failed)
+{
+    const auto block = make_block(100, true);
+    const auto pool = make_pool(block);
+
+    // Sized for a pool of only the block, so no filter and a small table.
+    const graphene_block instance(block, nonce, 99);
+    BOOST_REQUIRE(instance.filter().filter().empty());
+
+    chain::block result;
+    graphene_block::short_id_list missing;
+    BOOST_REQUIRE(instance.reconstruct(pool.begin(), pool.end(), result,
+        missing) == graphene_block::result::failed);
+}
+
+BOOST_AUTO_TEST_CASE(graphene_block__from_data__to_data__round_trip)
+{
+    const auto block = make_block(50, false);
+    const auto pool = make_pool(block);
+    const graphene_block expected(block, nonce, pool.size());
+    const auto data = expected.to_data(version::level::maximum);
+    BOOST_REQUIRE_EQUAL(data.size(),
+        expected.serialized_size(version::level::maximum));
+
+    const auto instance = graphene_block::factory_from_data(
+        version::level::maximum, data);
+    BOOST_REQUIRE(instance.is_valid());
+    BOOST_REQUIRE(instance.to_data(version::level::maximum) == data);
+
+    chain::block result;
+    graphene_block::short_id_list missing;
+    BOOST_REQUIRE(instance.reconstruct(pool.begin(), pool.end(), result,
+        missing) == graphene_block::result::complete);
+    BOOST_REQUIRE(result == block);
+}
+
+// The offset of the transaction count, following header, nonce and coinbase.
+static size_t count_offset(const chain::block& block)
+{
+    return chain::header::satoshi_fixed_size() + sizeof(uint64_t) +
+        block.transactions().front().serialized_size();
+}
+
+BOOST_AUTO_TEST_CASE(graphene_block__from_data__oversized_filter__false)
+{
+    const auto block = make_block(10, true);
+    const graphene_block expected(block, nonce, 20);
+    auto data = expected.to_data(version::level::maximum);
+
+    // Replace the filter and what follows with a filter size of 2^62.
+    data.resize(count_offset(block) + sizeof(uint32_t));
+    data.push_back(0xff);
+    data.insert(data.end(), 8, 0x40);
+    data.insert(data.end(), 100, 0x00);
+
+    graphene_block instance;
+    BOOST_REQUIRE(!instance.from_data(version::level::maximum, data));
+}
+
+BOOST_AUTO_TEST_CASE(graphene_block__from_data__oversized_transaction_count__false)
+{
+    const auto block = make_block(10, true);
+    const graphene_block expected(block, nonce, 20);
+    auto data = expected.to_data(version::level::maximum);
+
+    // Maximal count and a matching order size, in place of the empty order.
+    const auto offset = count_offset(block);
+    std::fill_n(data.begin() + offset, sizeof(uint32_t), 0xff);
+    BOOST_REQUIRE_EQUAL(data.back(), 0x00);
+    data.back() = 0xfe;
+    extend_data(data, to_little_endian<uint32_t>(0xfffffffe));
+
+    graphene_block instance;
+    BOOST_REQUIRE(!instance.from_data(version::level::maximum, data));
+}
+
+BOOST_AUTO_TEST_CASE(graphene_block__serialized_size__large_canonical_block__below_compact_block)
+{
+    const auto block = make_block(2000, true);
+    const graphene_block instance(block, nonce, 4000);
+    const auto compact = compact_block::factory_from_block(
+        message::block(block));
+
+    BOOST_REQUIRE_LT(instance.serialized_size(version::level::maximum) * 2,
+        compact.serialized_size(version::level::maximum));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
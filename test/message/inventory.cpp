@@ -462,4 +462,23 @@ BOOST_AUTO_TEST_CASE(inventory__reduce__matching_type__returns_matches)
     BOOST_REQUIRE(expected == result);
 }
 
+BOOST_AUTO_TEST_CASE(inventory__remove_known__added_known__removes_only_known)
+{
+    const auto hash1 = hash_literal("1111111111111111111111111111111111111111111111111111111111111111");
+    const auto hash2 = hash_literal("2222222222222222222222222222222222222222222222222222222222222222");
+    const auto hash3 = hash_literal("3333333333333333333333333333333333333333333333333333333333333333");
+    chain::rolling_bloom_filter known(100, 0.000001);
+
+    const message::inventory sent({ hash1, hash3 },
+        message::inventory_vector::type_id::transaction);
+    sent.add_known(known);
+
+    message::inventory instance({ hash1, hash2, hash3 },
+        message::inventory_vector::type_id::transaction);
+    BOOST_REQUIRE_EQUAL(instance.remove_known(known), 2u);
+    BOOST_REQUIRE_EQUAL(instance.inventories().size(), 1u);
+    BOOST_REQUIRE(instance.inventories().front().hash() == hash2);
+    BOOST_REQUIRE_EQUAL(instance.remove_known(known), 0u);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
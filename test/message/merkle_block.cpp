@@ -137,6 +137,46 @@ BOOST_AUTO_TEST_CASE(merkle_block__constructor_5__always__equals_params)
     BOOST_REQUIRE(flags == instance.flags());
 }
 
+BOOST_AUTO_TEST_CASE(merkle_block__constructor_matches__extract__matched_transactions)
+{
+    chain::transaction::list transactions;
+
+    for (uint32_t tx = 0; tx < 7; ++tx)
+        transactions.push_back(chain::transaction{ 1, tx, {}, {} });
+
+    chain::block block;
+    block.set_transactions(std::move(transactions));
+    block.header().set_merkle(block.generate_merkle_root());
+
+    chain::merkle_tree::matches matched(7, false);
+    matched[1] = true;
+    matched[6] = true;
+
+    const message::merkle_block instance(block, matched);
+    BOOST_REQUIRE_EQUAL(instance.total_transactions(), 7u);
+
+    hash_list hashes;
+    chain::merkle_tree::indexes positions;
+    BOOST_REQUIRE(instance.extract(hashes, positions));
+    BOOST_REQUIRE_EQUAL(hashes.size(), 2u);
+    BOOST_REQUIRE(hashes[0] == block.transactions()[1].hash());
+    BOOST_REQUIRE(hashes[1] == block.transactions()[6].hash());
+    BOOST_REQUIRE(positions == chain::merkle_tree::indexes({ 1, 6 }));
+}
+
+BOOST_AUTO_TEST_CASE(merkle_block__extract__header_merkle_mismatch__false)
+{
+    chain::block block;
+    block.set_transactions({ chain::transaction{ 1, 0, {}, {} } });
+
+    const message::merkle_block instance(block,
+        chain::merkle_tree::matches{ true });
+
+    hash_list hashes;
+    chain::merkle_tree::indexes positions;
+    BOOST_REQUIRE(!instance.extract(hashes, positions));
+}
+
 BOOST_AUTO_TEST_CASE(from_data_insufficient_data_fails)
 {
     const data_chunk data{ 10 };
@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::message;
+
+BOOST_AUTO_TEST_SUITE(pooled_message_tests)
+
+static const uint32_t magic = 0xe8f3e1e3;
+static const auto level = version::level::maximum;
+
+static data_chunk concatenate(const pooled_message& message)
+{
+    data_chunk out(message.heading.begin(), message.heading.end());
+    extend_data(out, *message.payload);
+    return out;
+}
+
+BOOST_AUTO_TEST_CASE(pooled_message__serialize__ping__same_as_contiguous)
+{
+    buffer_pool pool(4);
+    const auto message = serialize(level, ping(42), magic, pool);
+    BOOST_REQUIRE(concatenate(message) == serialize(level, ping(42), magic));
+    BOOST_REQUIRE_EQUAL(message.size(), heading::satoshi_fixed_size() + 8u);
+}
+
+BOOST_AUTO_TEST_CASE(pooled_message__serialize__block__same_as_contiguous_and_frames)
+{
+    const chain::input input{ chain::output_point{ null_hash,
+        chain::point::null_index }, chain::script{}, max_input_sequence };
+    const chain::output output{ 5000000000, chain::script{} };
+    message::block block;
+    block.set_transactions({ chain::transaction{ 1, 0, { input },
+        { output } } });
+    block.header().set_merkle(block.generate_merkle_root());
+    BOOST_REQUIRE(block.is_valid());
+
+    buffer_pool pool(4);
+    const auto message = serialize(level, block, magic, pool);
+    const auto expected = serialize(level, block, magic);
+    BOOST_REQUIRE(concatenate(message) == expected);
+
+    const auto buffers = message.to_buffers();
+    BOOST_REQUIRE_EQUAL(boost::asio::buffer_size(buffers), expected.size());
+
+    // The heading is a valid frame heading for the pooled payload.
+    const framer instance(magic, level, false);
+    const auto frame = concatenate(message);
+    heading head;
+    data_slice payload(frame);
+    size_t size;
+    BOOST_REQUIRE(instance.read(frame, head, payload, size) ==
+        framer::result::complete);
+    BOOST_REQUIRE_EQUAL(size, frame.size());
+}
+
+BOOST_AUTO_TEST_CASE(pooled_message__serialize__released__payload_returns_to_pool)
+{
+    buffer_pool pool(4);
+
+    {
+        const auto message = serialize(level, ping(42), magic, pool);
+        BOOST_REQUIRE_EQUAL(pool.idle(), 0u);
+    }
+
+    BOOST_REQUIRE_EQUAL(pool.idle(), 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+
+BOOST_AUTO_TEST_SUITE(buffer_pool_tests)
+
+BOOST_AUTO_TEST_CASE(buffer_pool__acquire__empty_pool__sized_buffer)
+{
+    buffer_pool pool(2);
+    const auto buffer = pool.acquire(42);
+    BOOST_REQUIRE_EQUAL(buffer->size(), 42u);
+    BOOST_REQUIRE_EQUAL(pool.idle(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(buffer_pool__acquire__released_buffer__allocation_reused)
+{
+    buffer_pool pool(2);
+    auto buffer = pool.acquire(100);
+    const auto allocation = buffer->data();
+    buffer.reset();
+    BOOST_REQUIRE_EQUAL(pool.idle(), 1u);
+
+    const auto reused = pool.acquire(50);
+    BOOST_REQUIRE_EQUAL(pool.idle(), 0u);
+    BOOST_REQUIRE_EQUAL(reused->size(), 50u);
+    BOOST_REQUIRE(reused->data() == allocation);
+}
+
+BOOST_AUTO_TEST_CASE(buffer_pool__release__full_pool__freed)
+{
+    buffer_pool pool(1);
+    auto first = pool.acquire(1);
+    auto second = pool.acquire(1);
+    first.reset();
+    second.reset();
+    BOOST_REQUIRE_EQUAL(pool.idle(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(buffer_pool__release__after_pool_destroyed__freed)
+{
+    buffer_pool::buffer_ptr buffer;
+
+    {
+        buffer_pool pool(1);
+        buffer = pool.acquire(10);
+    }
+
+    BOOST_REQUIRE_EQUAL(buffer->size(), 10u);
+    buffer.reset();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
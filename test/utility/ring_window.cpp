@@ -0,0 +1,160 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <deque>
+#include <stdexcept>
+#include <utility>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+
+BOOST_AUTO_TEST_SUITE(ring_window_tests)
+
+typedef ring_window<uint32_t, uint64_t> window;
+
+static bool same(const window& left, const std::deque<uint32_t>& right)
+{
+    return left.size() == right.size() &&
+        std::equal(left.begin(), left.end(), right.begin());
+}
+
+static uint64_t twice(uint32_t value)
+{
+    return 2u * value;
+}
+
+BOOST_AUTO_TEST_CASE(ring_window__construct__default__empty)
+{
+    const window instance;
+    BOOST_REQUIRE(instance.empty());
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(instance.begin() == instance.end());
+}
+
+BOOST_AUTO_TEST_CASE(ring_window__push_back_pop_front__sliding__expected)
+{
+    window instance{ 1, 2, 3 };
+    std::deque<uint32_t> expected{ 1, 2, 3 };
+
+    for (uint32_t value = 4; value < 100; ++value)
+    {
+        instance.push_back(value);
+        instance.pop_front();
+        expected.push_back(value);
+        expected.pop_front();
+        BOOST_REQUIRE(same(instance, expected));
+    }
+
+    BOOST_REQUIRE_EQUAL(instance.front(), 97u);
+    BOOST_REQUIRE_EQUAL(instance.back(), 99u);
+    BOOST_REQUIRE_EQUAL(*instance.rbegin(), 99u);
+}
+
+BOOST_AUTO_TEST_CASE(ring_window__push_back__copy__parent_unchanged)
+{
+    const window parent{ 1, 2, 3 };
+    auto child = parent;
+    child.push_back(4);
+    child.pop_front();
+
+    BOOST_REQUIRE(same(parent, { 1, 2, 3 }));
+    BOOST_REQUIRE(same(child, { 2, 3, 4 }));
+}
+
+BOOST_AUTO_TEST_CASE(ring_window__push_back__sibling_copies__independent)
+{
+    const window parent{ 1, 2, 3 };
+    auto first = parent;
+    auto second = parent;
+    first.push_back(4);
+    second.push_back(5);
+    first.push_back(6);
+
+    BOOST_REQUIRE(same(parent, { 1, 2, 3 }));
+    BOOST_REQUIRE(same(first, { 1, 2, 3, 4, 6 }));
+    BOOST_REQUIRE(same(second, { 1, 2, 3, 5 }));
+}
+
+BOOST_AUTO_TEST_CASE(ring_window__mutable_access__shared__detaches)
+{
+    const window parent{ 1, 2, 3 };
+    auto child = parent;
+    child[1] = 42;
+    *child.begin() = 7;
+
+    BOOST_REQUIRE(same(parent, { 1, 2, 3 }));
+    BOOST_REQUIRE(same(child, { 7, 42, 3 }));
+}
+
+BOOST_AUTO_TEST_CASE(ring_window__resize__larger__zero_filled_and_writable)
+{
+    window instance{ 1 };
+    instance.resize(3);
+    instance[2] = 9;
+    BOOST_REQUIRE(same(instance, { 1, 0, 9 }));
+
+    instance.resize(2);
+    BOOST_REQUIRE(same(instance, { 1, 0 }));
+}
+
+BOOST_AUTO_TEST_CASE(ring_window__at__out_of_range__throws)
+{
+    const window instance{ 1, 2 };
+    BOOST_REQUIRE_EQUAL(instance.at(1), 2u);
+    BOOST_REQUIRE_THROW(instance.at(2), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(ring_window__move__source__empty)
+{
+    window source{ 1, 2 };
+    const auto target = std::move(source);
+    BOOST_REQUIRE(source.empty());
+    BOOST_REQUIRE(same(target, { 1, 2 }));
+}
+
+BOOST_AUTO_TEST_CASE(ring_window__total__sliding_copies__expected)
+{
+    window instance{ 1, 2, 3 };
+
+    for (uint32_t value = 4; value < 50; ++value)
+    {
+        auto child = instance;
+        child.push_back(value);
+        child.pop_front();
+        instance = child;
+
+        // The window is { value - 2, value - 1, value }.
+        const uint64_t expected = 2u * (3u * value - 3u);
+        BOOST_REQUIRE_EQUAL(instance.total(0, 3, twice), expected);
+        BOOST_REQUIRE_EQUAL(instance.total(1, 2, twice), 2u * (value - 1u));
+        BOOST_REQUIRE_EQUAL(instance.total(1, 1, twice), 0u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ring_window__total__after_write__recomputed)
+{
+    window instance{ 1, 2, 3 };
+    BOOST_REQUIRE_EQUAL(instance.total(0, 3, twice), 12u);
+
+    instance[0] = 10;
+    BOOST_REQUIRE_EQUAL(instance.total(0, 3, twice), 30u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()